@@ -86,7 +86,7 @@ int main() {
     // writing the exact neumann trace to the output file
     Eigen::VectorXd v(2 * numpanels); // neumann
     for (unsigned I = 0; I < 2 * numpanels; ++I) {
-      Eigen::VectorXd tangent = mesh.getPanels()[I]->Derivative(0.);
+      Eigen::VectorXd tangent = mesh.getPanel(I).Derivative(0.);
       Eigen::Vector2d normal;
       // Outward normal vector
       normal << tangent(1), -tangent(0);
@@ -137,7 +137,7 @@ int main() {
     // parametricbem2d::ParametrizedMesh lmesh = convert_to_linear(mesh);
     // Getting the panels
     using PanelVector = parametricbem2d::PanelVector;
-    PanelVector panels = mesh.getPanels();
+    const PanelVector &panels = mesh.getPanels();
 
     if (!true) {
       for (unsigned i = 0; i < numpanels; ++i) {
@@ -8,12 +8,16 @@
 #ifndef ABSTRACTBEMSPACEHPP
 #define ABSTRACTBEMSPACEHPP
 
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "gauleg.hpp"
+#include "logweight_quadrature.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -41,9 +45,12 @@ public:
 
   /**
    * This function maps a local shape function to the corresponding global shape
-   * function for a BEM space on the given number of panels, defined in
-   * \f$\eqref{eq:lgm}\f$. This is a pure virtual function and has to be
-   * implemented in the derived classes.
+   * function for a BEM space on the given mesh, defined in
+   * \f$\eqref{eq:lgm}\f$. The global shape functions are numbered by
+   * boundary components, see ParametrizedMesh::getComponentOffset(): the ones
+   * of a component form a contiguous block following the blocks of the
+   * previous components, and within the block they are numbered by
+   * LocGlobMap() for the panels of the component.
    *
    * @param q Index of the local/reference shape function (>=1)
    * @param n Index of the panel for which this map is applied (>=1)
@@ -53,7 +60,17 @@ public:
    */
   virtual unsigned int LocGlobMap2(unsigned int q, unsigned int n,
                                    const ParametrizedMesh &mesh) const {
-    return 0;
+    // Asserting the index of local shape function and the panel number are
+    // within limits
+    if (!(q <= q_ && n >= 1 && n <= mesh.getNumPanels()))
+      throw std::out_of_range("Panel/RSF index out of range!");
+    // Panels of the component containing the panel n
+    unsigned int c = mesh.getComponent(n - 1);
+    unsigned int first = mesh.getComponentOffset(c);
+    unsigned int size = mesh.getComponentOffset(c + 1) - first;
+    // Numbering within the component, after the global shape functions of
+    // the previous components
+    return LocGlobMap(q, n - first, size) + getSpaceDim(first);
   }
 
   /**
@@ -116,6 +133,70 @@ public:
     return referenceshapefunctiondots_[q](t);
   }
 
+  /**
+   * This function evaluates all the reference shape functions of the BEM space
+   * at a given point. Unlike evaluateShapeFunction(), it does not check its
+   * arguments, and the concrete spaces override it with inlined evaluations,
+   * such that it is suited for the innermost loops of the kernels.
+   *
+   * @param t The point in the parameter range
+   * @param values Vector of size getQ() which is filled with the values
+   */
+  virtual void
+  evaluateShapeFunctions(double t, Eigen::Ref<Eigen::VectorXd> values) const {
+    for (int q = 0; q < q_; ++q)
+      values(q) = referenceshapefunctions_[q](t);
+  }
+
+  /**
+   * This function evaluates the derivatives of all the reference shape
+   * functions at a given point, see evaluateShapeFunctions().
+   *
+   * @param t The point in the parameter range
+   * @param values Vector of size getQ() which is filled with the derivatives
+   */
+  virtual void
+  evaluateShapeFunctionDots(double t,
+                            Eigen::Ref<Eigen::VectorXd> values) const {
+    for (int q = 0; q < q_; ++q)
+      values(q) = referenceshapefunctiondots_[q](t);
+  }
+
+  /**
+   * This function tabulates all the reference shape functions of the BEM space
+   * at the nodes of a quadrature rule on [-1,1]. The kernels evaluate the
+   * table once instead of calling evaluateShapeFunction() in their innermost
+   * loops. The implementation in this base class uses the stored std::function
+   * objects; the concrete spaces override it with inlined evaluations.
+   *
+   * @param qr Quadrature rule with nodes in the parameter range
+   * @return Array of size getQ() X qr.n, entry (q,k) is the value of the
+   *         reference shape function q at the node k
+   */
+  virtual Eigen::ArrayXXd tabulateShapeFunctions(const QuadRule &qr) const {
+    Eigen::ArrayXXd table(q_, qr.n);
+    for (unsigned int k = 0; k < qr.n; ++k)
+      for (int q = 0; q < q_; ++q)
+        table(q, k) = referenceshapefunctions_[q](qr.x(k));
+    return table;
+  }
+
+  /**
+   * This function tabulates the derivatives of all the reference shape
+   * functions at the nodes of a quadrature rule, see tabulateShapeFunctions().
+   *
+   * @param qr Quadrature rule with nodes in the parameter range
+   * @return Array of size getQ() X qr.n, entry (q,k) is the derivative of the
+   *         reference shape function q at the node k
+   */
+  virtual Eigen::ArrayXXd tabulateShapeFunctionDots(const QuadRule &qr) const {
+    Eigen::ArrayXXd table(q_, qr.n);
+    for (unsigned int k = 0; k < qr.n; ++k)
+      for (int q = 0; q < q_; ++q)
+        table(q, k) = referenceshapefunctiondots_[q](qr.x(k));
+    return table;
+  }
+
   /**
    * This function is used for checking whether a value t is within the
    * valid parameter range. This function is non virtual to prevent it
@@ -170,6 +251,27 @@ protected:
    * Protected constructor ensures this base class is non instantiable.
    */
   AbstractBEMSpace() : q_(0){};
+  /**
+   * This function tabulates Q functions at the nodes of a quadrature rule, as
+   * needed by the overrides of tabulateShapeFunctions() and
+   * tabulateShapeFunctionDots() in the concrete spaces. With Q known at compile
+   * time and an inlineable function, the loops are fully optimized.
+   *
+   * @tparam Q Number of functions
+   * @tparam Function Type of the function, called as function(q, t)
+   * @param qr Quadrature rule with nodes in the parameter range
+   * @param function The functions to be tabulated
+   * @return Array of size Q X qr.n with the values at the nodes
+   */
+  template <unsigned int Q, typename Function>
+  static Eigen::ArrayXXd tabulate(const QuadRule &qr,
+                                  const Function &function) {
+    Eigen::ArrayXXd table(Q, qr.n);
+    for (unsigned int k = 0; k < qr.n; ++k)
+      for (unsigned int q = 0; q < Q; ++q)
+        table(q, k) = function(q, qr.x(k));
+    return table;
+  }
   /**
    * A protected vector containing all the reference shape functions.
    */
@@ -184,6 +286,120 @@ protected:
    */
   int q_;
 }; // class AbstractBEMSpace
+
+/**
+ * \class TabulatedBEMSpace
+ * \brief This class bundles a BEM space with the values and derivatives of its
+ *        reference shape functions at the nodes of a quadrature rule, see
+ *        AbstractBEMSpace::tabulateShapeFunctions(). The tables are computed
+ *        once per assembly and shared by all the panel pairs, instead of
+ *        being allocated by the kernels for every pair. The space has to
+ *        outlive this object. The tables for the lower order Gauss rules used
+ *        by the adaptive quadrature are computed on demand, once per order,
+ *        see getLowerOrder().
+ */
+class TabulatedBEMSpace {
+public:
+  /**
+   * Constructor which tabulates the reference shape functions and their
+   * derivatives.
+   *
+   * @param space The BEM space
+   * @param qr Quadrature rule with nodes in the parameter range
+   */
+  TabulatedBEMSpace(const AbstractBEMSpace &space, const QuadRule &qr)
+      : space_(space), values_(space.tabulateShapeFunctions(qr)),
+        dots_(space.tabulateShapeFunctionDots(qr)),
+        lower_orders_(new std::atomic<const TabulatedBEMSpace *>[qr.n]()) {}
+
+  // The tables for the lower orders are owned by the object
+  TabulatedBEMSpace(const TabulatedBEMSpace &) = delete;
+  TabulatedBEMSpace &operator=(const TabulatedBEMSpace &) = delete;
+
+  /**
+   * Destructor which frees the tables for the lower orders
+   */
+  ~TabulatedBEMSpace() {
+    for (Eigen::Index order = 0; order < values_.cols(); ++order)
+      delete lower_orders_[order].load();
+  }
+
+  /**
+   * This function returns the tabulated BEM space.
+   *
+   * @return Reference to the BEM space
+   */
+  const AbstractBEMSpace &getSpace() const { return space_; }
+
+  /**
+   * This function returns the number of reference shape functions.
+   *
+   * @return Number of reference shape functions
+   */
+  int getQ() const { return values_.rows(); }
+
+  /**
+   * This function returns the values of the reference shape functions.
+   *
+   * @return Array of size getQ() X qr.n, entry (q,k) is the value of the
+   *         reference shape function q at the node k
+   */
+  const Eigen::ArrayXXd &getValues() const { return values_; }
+
+  /**
+   * This function returns the derivatives of the reference shape functions.
+   *
+   * @return Array of size getQ() X qr.n, entry (q,k) is the derivative of the
+   *         reference shape function q at the node k
+   */
+  const Eigen::ArrayXXd &getDots() const { return dots_; }
+
+  /**
+   * This function returns the reference shape functions of the space
+   * tabulated at the nodes of the Gauss rule of a lower order, see
+   * getGaussQR(). The tables are computed at the first request and shared
+   * by all the threads, like PanelGeometryCache::getLowerOrder().
+   *
+   * @param order Order of the Gauss rule, smaller than the number of nodes
+   * @return Reference to the tables for the given order, valid as long as
+   *         this object
+   */
+  const TabulatedBEMSpace &getLowerOrder(unsigned int order) const {
+    assert(Eigen::Index(order) < values_.cols());
+    const TabulatedBEMSpace *tables =
+        lower_orders_[order].load(std::memory_order_acquire);
+    if (tables == nullptr) {
+      // Threads tabulating the same order concurrently keep the first result
+      const TabulatedBEMSpace *computed =
+          new TabulatedBEMSpace(space_, getGaussQR(order));
+      if (lower_orders_[order].compare_exchange_strong(
+              tables, computed, std::memory_order_acq_rel))
+        tables = computed;
+      else
+        delete computed;
+    }
+    return *tables;
+  }
+
+private:
+  /**
+   * The tabulated BEM space
+   */
+  const AbstractBEMSpace &space_;
+  /**
+   * Values of the reference shape functions at the quadrature nodes
+   */
+  Eigen::ArrayXXd values_;
+  /**
+   * Derivatives of the reference shape functions at the quadrature nodes
+   */
+  Eigen::ArrayXXd dots_;
+  /**
+   * Tables for the Gauss rules of lower orders, indexed by the order and
+   * computed on demand
+   */
+  std::unique_ptr<std::atomic<const TabulatedBEMSpace *>[]> lower_orders_;
+}; // class TabulatedBEMSpace
 } // namespace parametricbem2d
 
 #endif // ABSTRACTBEMSPACEHPP
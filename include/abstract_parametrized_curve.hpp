@@ -103,6 +103,55 @@ public:
    */
   virtual Eigen::Vector2d DoubleDerivative(double t) const = 0;
 
+  /**
+   * This function is used for evaluating the parametrization \f$\gamma\f$(t)
+   * at several parameter values at once, as needed for the quadrature nodes of
+   * a panel. The default implementation calls operator() for every parameter
+   * value; the inherited classes override it with a vectorized evaluation
+   * which requires only one virtual call for all the values.
+   *
+   * @param t Array of parameter values
+   * @param out Matrix of size 2 X t.size() which is filled with the
+   *            parametrized points, column k corresponding to t(k)
+   */
+  virtual void Evaluate(const Eigen::ArrayXd &t, Eigen::Matrix2Xd &out) const {
+    out.resize(2, t.size());
+    for (unsigned k = 0; k < t.size(); ++k)
+      out.col(k) = this->operator()(t(k));
+  }
+
+  /**
+   * This function is used for evaluating the derivative \f$\dot{\gamma}\f$(t)
+   * at several parameter values at once. The default implementation calls
+   * Derivative(double) for every parameter value.
+   *
+   * @param t Array of parameter values
+   * @param out Matrix of size 2 X t.size() which is filled with the
+   *            derivatives, column k corresponding to t(k)
+   */
+  virtual void Derivative(const Eigen::ArrayXd &t,
+                          Eigen::Matrix2Xd &out) const {
+    out.resize(2, t.size());
+    for (unsigned k = 0; k < t.size(); ++k)
+      out.col(k) = Derivative(t(k));
+  }
+
+  /**
+   * This function is used for evaluating the double derivative
+   * \f$\ddot{\gamma}\f$(t) at several parameter values at once. The default
+   * implementation calls DoubleDerivative(double) for every parameter value.
+   *
+   * @param t Array of parameter values
+   * @param out Matrix of size 2 X t.size() which is filled with the double
+   *            derivatives, column k corresponding to t(k)
+   */
+  virtual void DoubleDerivative(const Eigen::ArrayXd &t,
+                                Eigen::Matrix2Xd &out) const {
+    out.resize(2, t.size());
+    for (unsigned k = 0; k < t.size(); ++k)
+      out.col(k) = DoubleDerivative(t(k));
+  }
+
   /**
    * This function is used for checking whether a value t is within the
    * valid parameter range. This function is non virtual to prevent it
@@ -121,6 +170,21 @@ public:
     return (t >= a && t <= b);
   }
 
+  /**
+   * This function is used for checking whether all the values in an array are
+   * within the valid parameter range, see IsWithinParameterRange(double).
+   *
+   * @param t The values to be checked
+   * @return boolean indicating result of the performed check
+   */
+  static bool IsWithinParameterRange(const Eigen::ArrayXd &t) {
+    double a, b;
+    // Getting the parameter range
+    std::tie(a, b) = ParameterRange();
+    // Checking if all the values are within parameter range
+    return (t >= a).all() && (t <= b).all();
+  }
+
   /**
    * This function is used for splitting a parametrized curve into several
    * self-similar part curves. It is useful to make a parametrized mesh as it
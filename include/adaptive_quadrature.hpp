@@ -0,0 +1,337 @@
+/**
+ * \file adaptive_quadrature.hpp
+ * \brief This file defines the functions for choosing the order of the tensor
+ *        product Gauss quadrature for pairs of disjoint panels from their
+ *        admissibility, as mentioned in \f$\ref{par:distpan}\f$. The adaptive
+ *        choice is switched off by default and is enabled by setting an
+ *        accuracy target. It also defines the subdivision of panels close to
+ *        the evaluation points of the potentials.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef ADAPTIVEQUADRATUREHPP
+#define ADAPTIVEQUADRATUREHPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "abstract_parametrized_curve.hpp"
+#include "logweight_quadrature.hpp"
+#include "panel_geometry_cache.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This namespace contains the functions for choosing the quadrature order
+ * for disjoint panels and for recording the orders which were used.
+ */
+namespace adaptive_quadrature {
+/**
+ * Smallest quadrature order chosen by the adaptive selection
+ */
+const unsigned MIN_ORDER = 2;
+
+/**
+ * Number of bins in the histogram of orders. Orders greater than or equal to
+ * HISTOGRAM_SIZE - 1 are counted in the last bin.
+ */
+const unsigned HISTOGRAM_SIZE = 257;
+
+/**
+ * Largest admissibility of a panel with respect to an evaluation point, the
+ * length of the panel divided by the distance to the point, for which the
+ * potentials are evaluated with the Gauss rule on the panel. As in
+ * SelectOrder(), the error of the Gauss rule of order n then decays at least
+ * like \f$(2+\sqrt{5})^{-2n}\f$. Closer panels are subdivided, see
+ * IntegrateNearPoint().
+ */
+const double POTENTIAL_RHO = 1.;
+
+/**
+ * Largest number of bisections of a panel in IntegrateNearPoint()
+ */
+const unsigned MAX_SUBDIVISIONS = 30;
+
+/**
+ * This function gives access to the accuracy target requested through
+ * setAccuracy(). A value of zero means that it is read from the environment.
+ *
+ * @return Reference to the requested accuracy target
+ */
+inline std::atomic<double> &RequestedAccuracy() {
+  static std::atomic<double> requested(0.);
+  return requested;
+}
+
+/**
+ * This function sets the accuracy target for the quadrature of disjoint
+ * panels, which enables the adaptive choice of the quadrature order. Passing
+ * zero restores the default described in getAccuracy().
+ *
+ * @param accuracy Accuracy target (>0) for the quadrature error
+ */
+inline void setAccuracy(double accuracy) { RequestedAccuracy() = accuracy; }
+
+/**
+ * This function returns the accuracy target specified through the
+ * environment variable PARAMETRICBEM2D_QUADRATURE_ACCURACY. The environment
+ * is only read at the first call, as the accuracy target is queried for every
+ * pair of disjoint panels.
+ *
+ * @return Accuracy target, or zero if the variable is not set to a positive
+ *         value
+ */
+inline double EnvironmentAccuracy() {
+  static const double accuracy = [] {
+    const char *env = std::getenv("PARAMETRICBEM2D_QUADRATURE_ACCURACY");
+    return env != nullptr && std::atof(env) > 0 ? std::atof(env) : 0.;
+  }();
+  return accuracy;
+}
+
+/**
+ * This function returns the accuracy target for the quadrature of disjoint
+ * panels. Unless set by setAccuracy(), it is read from the environment
+ * variable PARAMETRICBEM2D_QUADRATURE_ACCURACY, see EnvironmentAccuracy(). If
+ * neither is given, the adaptive choice is disabled and zero is returned.
+ *
+ * @return Accuracy target, or zero if the adaptive choice is disabled
+ */
+inline double getAccuracy() {
+  double requested = RequestedAccuracy();
+  if (requested > 0)
+    return requested;
+  // Accuracy target specified through the environment
+  return EnvironmentAccuracy();
+}
+
+/**
+ * This function gives access to the counters of the histogram of orders.
+ *
+ * @return Pointer to the HISTOGRAM_SIZE counters, indexed by order
+ */
+inline std::atomic<unsigned long> *OrderCounts() {
+  // Static storage is zero initialized
+  static std::atomic<unsigned long> counts[HISTOGRAM_SIZE];
+  return counts;
+}
+
+/**
+ * This function returns the histogram of the quadrature orders chosen for
+ * disjoint panel pairs while the adaptive choice was enabled, since the start
+ * of the program or the last call to resetOrderHistogram().
+ *
+ * @return Vector whose nth entry is the number of panel pairs integrated with
+ *         order n. Its size is one more than the largest order used.
+ */
+inline std::vector<unsigned long> getOrderHistogram() {
+  std::vector<unsigned long> histogram(HISTOGRAM_SIZE);
+  for (unsigned n = 0; n < HISTOGRAM_SIZE; ++n)
+    histogram[n] = OrderCounts()[n];
+  // Removing the trailing empty bins
+  while (!histogram.empty() && histogram.back() == 0)
+    histogram.pop_back();
+  return histogram;
+}
+
+/**
+ * This function sets all the counts in the histogram of orders to zero.
+ */
+inline void resetOrderHistogram() {
+  for (unsigned n = 0; n < HISTOGRAM_SIZE; ++n)
+    OrderCounts()[n] = 0;
+}
+
+/**
+ * This function computes the quadrature order for a pair of disjoint panels
+ * with the admissibility \f$\rho\f$. Seen from one panel, mapped to [-1,1],
+ * the kernel is singular at a relative distance of at least
+ * \f$\delta = 2/\rho\f$. The integrand is therefore analytic inside the
+ * Bernstein ellipse with parameter \f$\varsigma = \delta + \sqrt{1 +
+ * \delta^2}\f$ and the error of the Gauss rule of order n decays like
+ * \f$\varsigma^{-2n}\f$. The smallest order with \f$\varsigma^{-2n}\f$ below
+ * the accuracy target is used, limited to the range [MIN_ORDER,N].
+ *
+ * @param rho Admissibility of the pair of panels, see rho()
+ * @param accuracy Accuracy target (>0)
+ * @param N Largest order to be returned
+ * @return Quadrature order for the pair of panels
+ */
+inline unsigned SelectOrder(double rho, double accuracy, unsigned N) {
+  if (!(rho < std::numeric_limits<double>::infinity()))
+    return N;
+  double delta = 2. / rho;
+  double varsigma = delta + std::sqrt(1. + delta * delta);
+  double order = std::ceil(-std::log(accuracy) / (2. * std::log(varsigma)));
+  // Comparing as double to avoid overflow in the conversion
+  if (order >= N)
+    return N;
+  return std::max(MIN_ORDER, static_cast<unsigned>(order));
+}
+
+/**
+ * This function records the order used for a pair of panels in the histogram
+ * of orders and returns it.
+ *
+ * @param order Quadrature order used for a pair of panels
+ * @return The same order
+ */
+inline unsigned RecordOrder(unsigned order) {
+  OrderCounts()[std::min(order, HISTOGRAM_SIZE - 1)].fetch_add(
+      1, std::memory_order_relaxed);
+  return order;
+}
+
+/**
+ * This function returns the quadrature order to be used for a pair of
+ * disjoint panels, when at most the order N is to be used. If the adaptive
+ * choice is disabled, N is returned. Otherwise the order is chosen with the
+ * admissibility rho() of the panels and recorded in the histogram.
+ *
+ * @param pi Parametrization for the first panel \f$\Pi\f$.
+ * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
+ * @param N Largest order to be used
+ * @return Quadrature order for the pair of panels
+ */
+inline unsigned SelectOrder(const AbstractParametrizedCurve &pi,
+                            const AbstractParametrizedCurve &pi_p,
+                            unsigned N) {
+  double accuracy = getAccuracy();
+  if (accuracy <= 0)
+    return N;
+  return RecordOrder(SelectOrder(rho(pi, pi_p), accuracy, N));
+}
+
+/**
+ * This function returns the quadrature order to be used for a pair of
+ * disjoint panels, when at most the order N is to be used. If the adaptive
+ * choice is disabled, N is returned. Otherwise the order is chosen with the
+ * admissibility estimated from the tabulated geometry, see
+ * PanelGeometryCache::estimateRho(), and recorded in the histogram.
+ *
+ * @param geometry Tabulated geometry of the panels in the mesh
+ * @param i Index of the first panel (>=0)
+ * @param j Index of the second panel (>=0)
+ * @param N Largest order to be used
+ * @return Quadrature order for the pair of panels
+ */
+inline unsigned SelectOrder(const PanelGeometryCache &geometry, unsigned i,
+                            unsigned j, unsigned N) {
+  double accuracy = getAccuracy();
+  if (accuracy <= 0)
+    return N;
+  return RecordOrder(SelectOrder(geometry.estimateRho(i, j), accuracy, N));
+}
+
+/**
+ * This function evaluates the integral of a function over the parameter
+ * interval [a,b] of a panel, which is close to the point x. The interval is
+ * bisected until the admissibility of the parts with respect to x is at most
+ * POTENTIAL_RHO, or until MAX_SUBDIVISIONS bisections, and the Gauss rule is
+ * used on every part. The length of a part and its distance to x are
+ * estimated as in PanelGeometryCache::estimateRho().
+ *
+ * @tparam Integrand Template type for the integrand. Should support
+ *                   evaluation of the form integrand(t) for the parameter t,
+ *                   returning a double
+ * @param panel Parametrization of the panel
+ * @param x The evaluation point
+ * @param integrand The function to be integrated over the parameter
+ * @param GaussQR QuadRule object on [-1,1] used on the parts of the panel
+ * @param a Start of the parameter interval
+ * @param b End of the parameter interval
+ * @param depth Number of bisections which led to the interval
+ * @return The integral of the function over the interval
+ */
+template <typename Integrand>
+double IntegrateNearPoint(const AbstractParametrizedCurve &panel,
+                          const Eigen::Vector2d &x, const Integrand &integrand,
+                          const QuadRule &GaussQR, double a = -1.,
+                          double b = 1., unsigned depth = 0) {
+  unsigned N = GaussQR.n;
+  // Gauss nodes mapped to [a,b]
+  Eigen::VectorXd t(N);
+  for (unsigned k = 0; k < N; ++k)
+    t(k) = 0.5 * (a + b) + 0.5 * (b - a) * GaussQR.x(k);
+  if (depth < MAX_SUBDIVISIONS) {
+    // Circle around the part, centered at the midpoint of its endpoints
+    Eigen::Vector2d start = panel(a);
+    Eigen::Vector2d end = panel(b);
+    Eigen::Vector2d center = 0.5 * (start + end);
+    double radius = 0.5 * (end - start).norm();
+    double length = 0.;
+    for (unsigned k = 0; k < N; ++k) {
+      radius = std::max(radius, (panel(t(k)) - center).norm());
+      length += 0.5 * (b - a) * GaussQR.w(k) * panel.Derivative(t(k)).norm();
+    }
+    double dist = (x - center).norm() - radius;
+    if (dist * POTENTIAL_RHO < length) { // Bisection of the part
+      double middle = 0.5 * (a + b);
+      return IntegrateNearPoint(panel, x, integrand, GaussQR, a, middle,
+                                depth + 1) +
+             IntegrateNearPoint(panel, x, integrand, GaussQR, middle, b,
+                                depth + 1);
+    }
+  }
+  // Gauss rule on the part
+  double integral = 0.;
+  for (unsigned k = 0; k < N; ++k)
+    integral += GaussQR.w(k) * integrand(t(k));
+  return 0.5 * (b - a) * integral;
+}
+
+/**
+ * This function evaluates the integral of a function over a panel like
+ * IntegrateNearPoint(), for an integrand depending on the points and the
+ * tangents of the panel. The panel is evaluated once at the Gauss nodes, for
+ * the Gauss rule and for the admissibility of the panel with respect to x,
+ * and only a panel close to x is passed on to IntegrateNearPoint().
+ *
+ * @tparam Integrand Template type for the integrand. Should support
+ *                   evaluation of the form integrand(t, y, tangent) for the
+ *                   parameter t, the point y = panel(t) and the tangent
+ *                   tangent = panel.Derivative(t), returning a double
+ * @param panel Parametrization of the panel
+ * @param x The evaluation point
+ * @param integrand The function to be integrated over the parameter
+ * @param GaussQR QuadRule object on [-1,1]
+ * @return The integral of the function over the panel
+ */
+template <typename Integrand>
+double IntegrateOverPanel(const AbstractParametrizedCurve &panel,
+                          const Eigen::Vector2d &x, const Integrand &integrand,
+                          const QuadRule &GaussQR) {
+  // Circle around the panel and length of the panel as in
+  // IntegrateNearPoint(), together with the Gauss rule
+  Eigen::Vector2d start = panel(-1);
+  Eigen::Vector2d end = panel(1);
+  Eigen::Vector2d center = 0.5 * (start + end);
+  double radius = 0.5 * (end - start).norm();
+  double length = 0., integral = 0.;
+  for (unsigned k = 0; k < GaussQR.n; ++k) {
+    double t = GaussQR.x(k);
+    Eigen::Vector2d y = panel(t);
+    Eigen::Vector2d tangent = panel.Derivative(t);
+    radius = std::max(radius, (y - center).norm());
+    length += GaussQR.w(k) * tangent.norm();
+    integral += GaussQR.w(k) * integrand(t, y, tangent);
+  }
+  if (((x - center).norm() - radius) * POTENTIAL_RHO < length) {
+    // Subdivision of the panel close to x
+    auto parametric = [&](double t) {
+      return integrand(t, panel(t), panel.Derivative(t));
+    };
+    return IntegrateNearPoint(panel, x, parametric, GaussQR);
+  }
+  return integral;
+}
+
+} // namespace adaptive_quadrature
+} // namespace parametricbem2d
+
+#endif // ADAPTIVEQUADRATUREHPP
@@ -28,7 +28,9 @@ namespace adj_double_layer {
  * Bilinear form for Adjoint Double Layer BIO. It uses the trial and test spaces
  * and the parametrized mesh object, specified in the inputs to the function.
  * It evaluates the matrix by internally using the Double Layer Galerkin Matrix
- * evaluation and transposing it to give the final result.
+ * evaluation with the roles of the spaces swapped and transposing it to give
+ * the final result. If the Double Layer Galerkin matrix is needed as well, a
+ * calderon::DoubleLayerOperators object avoids assembling it twice.
  *
  * @param mesh ParametrizedMesh object containing all the panels in the form
  *             of small parametrized curves
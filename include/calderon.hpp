@@ -0,0 +1,139 @@
+/**
+ * \file calderon.hpp
+ * \brief This file defines functions and classes to evaluate the Galerkin
+ *        matrices of the boundary integral operators appearing in the Calderon
+ *        projector together, sharing the work which is common to them.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef CALDERONHPP
+#define CALDERONHPP
+
+#include <tuple>
+
+#include "abstract_bem_space.hpp"
+#include "double_layer.hpp"
+#include "gauleg.hpp"
+#include "hypersingular.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parametrized_mesh.hpp"
+#include "single_layer.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This namespace contains the functions and classes for evaluating the
+ * Galerkin matrices of several boundary integral operators at once.
+ */
+namespace calderon {
+/**
+ * \class DoubleLayerOperators
+ * \brief This class holds the Galerkin matrix K of the Double Layer BIO and
+ *        gives access to the Galerkin matrix K' of the Adjoint Double Layer
+ *        BIO for the spaces with swapped roles. As K' is the transpose of K,
+ *        only K is assembled and K' is returned as a transposed view of it.
+ */
+class DoubleLayerOperators {
+public:
+  /**
+   * Constructor which assembles the Double Layer Galerkin matrix.
+   *
+   * @param mesh ParametrizedMesh object containing all the panels in the form
+   *             of small parametrized curves
+   * @param trial_space The trial space for K, which is the test space for K'
+   * @param test_space The test space for K, which is the trial space for K'
+   * @param N The order for gauss/log-weighted quadrature.
+   */
+  DoubleLayerOperators(const ParametrizedMesh &mesh,
+                       const AbstractBEMSpace &trial_space,
+                       const AbstractBEMSpace &test_space,
+                       const unsigned int &N)
+      : K_(double_layer::GalerkinMatrix(mesh, trial_space, test_space, N)) {}
+
+  /**
+   * Constructor from an already assembled Double Layer Galerkin matrix.
+   *
+   * @param K The Double Layer Galerkin matrix
+   */
+  explicit DoubleLayerOperators(const Eigen::MatrixXd &K) : K_(K) {}
+
+  /**
+   * This function returns the Double Layer Galerkin matrix
+   *
+   * @return The Galerkin matrix K
+   */
+  const Eigen::MatrixXd &getK() const { return K_; }
+
+  /**
+   * This function returns the Adjoint Double Layer Galerkin matrix as a
+   * transposed view of K, without copying it
+   *
+   * @return The Galerkin matrix K'
+   */
+  Eigen::Transpose<const Eigen::MatrixXd> getKp() const {
+    return K_.transpose();
+  }
+
+private:
+  /**
+   * The Double Layer Galerkin matrix
+   */
+  Eigen::MatrixXd K_;
+}; // class DoubleLayerOperators
+
+/**
+ * This structure holds the Galerkin matrices of the Single Layer BIO V, the
+ * Double Layer BIO K and the Hypersingular BIO W. The Galerkin matrix of the
+ * Adjoint Double Layer BIO K' is obtained as a transposed view of K.
+ */
+struct CalderonBlocks {
+  Eigen::MatrixXd V; // Galerkin matrix of V, for the Neumann space
+  Eigen::MatrixXd K; // Galerkin matrix of K, Dirichlet space -> Neumann space
+  Eigen::MatrixXd W; // Galerkin matrix of W, for the Dirichlet space
+
+  /**
+   * This function returns the Galerkin matrix of K' as a transposed view of K,
+   * with the Neumann space as trial space and the Dirichlet space as test
+   * space
+   *
+   * @return The Galerkin matrix K'
+   */
+  Eigen::Transpose<const Eigen::MatrixXd> Kp() const { return K.transpose(); }
+};
+
+/**
+ * This function evaluates the Galerkin matrices V, K and W for the given mesh
+ * and spaces, giving access to K' as well (see CalderonBlocks). The geometry
+ * of the panels is tabulated only once for all the operators, see
+ * PanelGeometryCache, V and W are assembled together, see
+ * hypersingular::GalerkinMatrices(), and the Double Layer matrix is assembled
+ * only once for K and K'. The result is identical to separate calls to the
+ * GalerkinMatrix() functions of the operators.
+ *
+ * @param mesh ParametrizedMesh object containing all the panels in the form
+ *             of small parametrized curves
+ * @param neumann_space The space for V, also the test space for K
+ * @param dirichlet_space The space for W, also the trial space for K
+ * @param N The order for gauss/log-weighted quadrature.
+ * @return A CalderonBlocks object containing the Galerkin matrices
+ */
+inline CalderonBlocks AssembleCalderonBlocks(
+    const ParametrizedMesh &mesh, const AbstractBEMSpace &neumann_space,
+    const AbstractBEMSpace &dirichlet_space, const unsigned int &N) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels once for all the operators
+  PanelGeometryCache geometry(mesh, GaussQR);
+  CalderonBlocks blocks;
+  // V and W share the evaluations of the logarithmic kernel
+  std::tie(blocks.V, blocks.W) = hypersingular::GalerkinMatrices(
+      mesh, geometry, neumann_space, dirichlet_space, GaussQR);
+  blocks.K = double_layer::GalerkinMatrix(mesh, geometry, dirichlet_space,
+                                          neumann_space, GaussQR);
+  return blocks;
+}
+
+} // namespace calderon
+} // namespace parametricbem2d
+
+#endif // CALDERONHPP
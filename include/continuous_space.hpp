@@ -42,6 +42,44 @@ public:
  */
 template <> class ContinuousSpace<1> : public AbstractBEMSpace {
 public:
+  // Number of reference shape functions, known at compile time
+  static constexpr unsigned int Q = 2;
+
+  // Reference shape functions and their derivatives, which can be inlined.
+  // The arguments are not checked, see evaluateShapeFunction().
+  static double shapeFunction(unsigned int q, double t) {
+    return q == 0 ? 0.5 * (t + 1) : 0.5 * (1 - t);
+  }
+  static double shapeFunctionDot(unsigned int q, double /*t*/) {
+    return q == 0 ? 0.5 : -0.5;
+  }
+
+  // Evaluation of all the reference shape functions at a point
+  void evaluateShapeFunctions(double t,
+                              Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunction(q, t);
+  }
+
+  // Evaluation of all the reference shape function derivatives at a point
+  void evaluateShapeFunctionDots(double t,
+                                 Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunctionDot(q, t);
+  }
+
+  // Tabulation of the reference shape functions at the quadrature nodes
+  Eigen::ArrayXXd tabulateShapeFunctions(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunction(q, t); });
+  }
+
+  // Tabulation of the reference shape function derivatives
+  Eigen::ArrayXXd tabulateShapeFunctionDots(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunctionDot(q, t); });
+  }
+
   // Local to Global Map
   unsigned int LocGlobMap(unsigned int q, unsigned int n,
                           unsigned int N) const {
@@ -57,23 +95,6 @@ public:
       return (n % N == 0) ? 1 : (n + 1);
   }
 
-  // Local to Global Map
-  unsigned int LocGlobMap2(unsigned int q, unsigned int n,
-                           const ParametrizedMesh &mesh) const {
-    // Getting the mesh information
-    unsigned split = mesh.getSplit();
-    unsigned N = mesh.getNumPanels();
-    // Mapping depends whether domain is annular or not
-    if (split != 0) {
-      if (n <= split) // we are within the first boundary in the mesh
-        return LocGlobMap(q, n, split);
-      else // for the second boundary in the mesh
-        return LocGlobMap(q, n - split, N - split) + split;
-    } else { // simply connected domain
-      return LocGlobMap(q, n, N);
-    }
-  }
-
   // Space Dimensions as defined in \f$\ref{T:thm:dimbe}\f$
   unsigned int getSpaceDim(unsigned int numpanels) const {
     return numpanels * (q_ - 1);
@@ -99,17 +120,17 @@ public:
     // Number of reference shape functions for the space
     q_ = 2;
     // Reference shape function 1, defined using a lambda expression
-    BasisFunctionType b1 = [&](double t) { return 0.5 * (t + 1); };
+    BasisFunctionType b1 = [](double t) { return shapeFunction(0, t); };
     // Reference shape function 2, defined using a lambda expression
-    BasisFunctionType b2 = [&](double t) { return 0.5 * (1 - t); };
+    BasisFunctionType b2 = [](double t) { return shapeFunction(1, t); };
     // Adding the reference shape functions to the vector
     referenceshapefunctions_.push_back(b1);
     referenceshapefunctions_.push_back(b2);
 
     // Reference shape function 1 derivative, defined using a lambda expression
-    BasisFunctionType b1dot = [&](double t) { return 0.5; };
+    BasisFunctionType b1dot = [](double t) { return shapeFunctionDot(0, t); };
     // Reference shape function 2 derivative, defined using a lambda expression
-    BasisFunctionType b2dot = [&](double t) { return -0.5; };
+    BasisFunctionType b2dot = [](double t) { return shapeFunctionDot(1, t); };
     // Adding the reference shape function derivatives to the vector
     referenceshapefunctiondots_.push_back(b1dot);
     referenceshapefunctiondots_.push_back(b2dot);
@@ -122,6 +143,44 @@ public:
  */
 template <> class ContinuousSpace<2> : public AbstractBEMSpace {
 public:
+  // Number of reference shape functions, known at compile time
+  static constexpr unsigned int Q = 3;
+
+  // Reference shape functions and their derivatives, which can be inlined.
+  // The arguments are not checked, see evaluateShapeFunction().
+  static double shapeFunction(unsigned int q, double t) {
+    return q == 0 ? 0.5 * (t + 1) : (q == 1 ? 0.5 * (1 - t) : 1 - t * t);
+  }
+  static double shapeFunctionDot(unsigned int q, double t) {
+    return q == 0 ? 0.5 : (q == 1 ? -0.5 : -2 * t);
+  }
+
+  // Evaluation of all the reference shape functions at a point
+  void evaluateShapeFunctions(double t,
+                              Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunction(q, t);
+  }
+
+  // Evaluation of all the reference shape function derivatives at a point
+  void evaluateShapeFunctionDots(double t,
+                                 Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunctionDot(q, t);
+  }
+
+  // Tabulation of the reference shape functions at the quadrature nodes
+  Eigen::ArrayXXd tabulateShapeFunctions(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunction(q, t); });
+  }
+
+  // Tabulation of the reference shape function derivatives
+  Eigen::ArrayXXd tabulateShapeFunctionDots(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunctionDot(q, t); });
+  }
+
   unsigned int LocGlobMap(unsigned int q, unsigned int n,
                           unsigned int N) const {
     // Asserting the index of local shape function and the panel number are
@@ -138,23 +197,6 @@ public:
       return N + n;
   }
 
-  // Local to Global Map
-  unsigned int LocGlobMap2(unsigned int q, unsigned int n,
-                           const ParametrizedMesh &mesh) const {
-    // Getting the mesh information
-    unsigned split = mesh.getSplit();
-    unsigned N = mesh.getNumPanels();
-    // Mapping depends whether domain is annular or not
-    if (split != 0) {
-      if (n <= split) // we are within the first boundary in the mesh
-        return LocGlobMap(q, n, split);
-      else // for the second boundary in the mesh
-        return LocGlobMap(q, n - split, N - split) + split;
-    } else { // simply connected domain
-      return LocGlobMap(q, n, N);
-    }
-  }
-
   // Space Dimensions as defined in \f$\ref{T:thm:dimbe}\f$
   unsigned int getSpaceDim(unsigned int numpanels) const {
     return numpanels * (q_ - 1);
@@ -167,15 +209,22 @@ public:
     unsigned numpanels = mesh.getNumPanels();
     unsigned coeffs_size = getSpaceDim(numpanels);
     Eigen::VectorXd coeffs(coeffs_size);
-    PanelVector panels = mesh.getPanels();
-    // Filling the coefficients
-    for (unsigned i = 0; i < numpanels; ++i) {
-      Eigen::Vector2d lvertex = mesh.getVertex(i);
-      Eigen::Vector2d rvertex = mesh.getVertex((i + 1) % numpanels);
-      coeffs(i) = func(lvertex(0), lvertex(1));
-      Eigen::Vector2d cvertex = panels[i]->operator()(0);
-      coeffs(numpanels + i) = func(cvertex(0), cvertex(1)) -
-                              0.5 * (coeffs(i) + func(rvertex(0), rvertex(1)));
+    // Filling the coefficients, numbered by boundary components as in
+    // LocGlobMap2()
+    for (unsigned c = 0; c < mesh.getNumComponents(); ++c) {
+      unsigned first = mesh.getComponentOffset(c);
+      unsigned size = mesh.getComponentOffset(c + 1) - first;
+      for (unsigned i = first; i < first + size; ++i) {
+        const AbstractParametrizedCurve &panel = mesh.getPanel(i);
+        Eigen::Vector2d lvertex = panel(-1);
+        Eigen::Vector2d rvertex = panel(1);
+        Eigen::Vector2d cvertex = panel(0);
+        unsigned vertex_dof = 2 * first + (i - first);
+        coeffs(vertex_dof) = func(lvertex(0), lvertex(1));
+        coeffs(vertex_dof + size) =
+            func(cvertex(0), cvertex(1)) -
+            0.5 * (coeffs(vertex_dof) + func(rvertex(0), rvertex(1)));
+      }
     }
     return coeffs;
   }
@@ -185,22 +234,22 @@ public:
     // Number of reference shape functions for the space
     q_ = 3;
     // Reference shape function 1, defined using a lambda expression
-    BasisFunctionType b1 = [&](double t) { return 0.5 * (t + 1); };
+    BasisFunctionType b1 = [](double t) { return shapeFunction(0, t); };
     // Reference shape function 2, defined using a lambda expression
-    BasisFunctionType b2 = [&](double t) { return 0.5 * (1 - t); };
+    BasisFunctionType b2 = [](double t) { return shapeFunction(1, t); };
     // Reference shape function 3, defined using a lambda expression
-    BasisFunctionType b3 = [&](double t) { return 1 - t * t; };
+    BasisFunctionType b3 = [](double t) { return shapeFunction(2, t); };
     // Adding the reference shape functions to the vector
     referenceshapefunctions_.push_back(b1);
     referenceshapefunctions_.push_back(b2);
     referenceshapefunctions_.push_back(b3);
 
     // Reference shape function 1 derivative, defined using a lambda expression
-    BasisFunctionType b1dot = [&](double t) { return 0.5; };
+    BasisFunctionType b1dot = [](double t) { return shapeFunctionDot(0, t); };
     // Reference shape function 2 derivative, defined using a lambda expression
-    BasisFunctionType b2dot = [&](double t) { return -0.5; };
+    BasisFunctionType b2dot = [](double t) { return shapeFunctionDot(1, t); };
     // Reference shape function 3 derivative, defined using a lambda expression
-    BasisFunctionType b3dot = [&](double t) { return -2 * t; };
+    BasisFunctionType b3dot = [](double t) { return shapeFunctionDot(2, t); };
     // Adding the reference shape function derivatives to the vector
     referenceshapefunctiondots_.push_back(b1dot);
     referenceshapefunctiondots_.push_back(b2dot);
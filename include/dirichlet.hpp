@@ -14,9 +14,11 @@
 #include "adj_double_layer.hpp"
 #include "continuous_space.hpp"
 #include "discontinuous_space.hpp"
+#include "dof_map.hpp"
 #include "double_layer.hpp"
 #include "hypersingular.hpp"
 #include "integral_gauss.hpp"
+#include "iterative_solvers.hpp"
 #include "parametrized_mesh.hpp"
 #include "single_layer.hpp"
 #include <Eigen/Dense>
@@ -44,7 +46,7 @@ inline Eigen::MatrixXd MassMatrix(const ParametrizedMesh &mesh,
   unsigned qx = x_space.getQ();
   unsigned qy = y_space.getQ();
   // Getting the panels
-  PanelVector panels = mesh.getPanels();
+  const PanelVector &panels = mesh.getPanels();
   unsigned numpanels = mesh.getNumPanels();
   unsigned split = numpanels/2;
   // Getting the space dimensions to fix matrix sizes
@@ -52,6 +54,9 @@ inline Eigen::MatrixXd MassMatrix(const ParametrizedMesh &mesh,
   unsigned int cols = y_space.getSpaceDim(numpanels);
   // Setting the output matrix size
   Eigen::MatrixXd output = Eigen::MatrixXd::Zero(rows, cols);
+  // Tabulating the local to global maps of both spaces
+  DofMap x_dofs(x_space, mesh);
+  DofMap y_dofs(y_space, mesh);
   // Interaction matrix for all pairs of reference shape functions between the
   // two spaces
   Eigen::MatrixXd interaction(qx, qy);
@@ -72,13 +77,8 @@ inline Eigen::MatrixXd MassMatrix(const ParametrizedMesh &mesh,
     // Local to global mapping of the elements in interaction
     for (unsigned int I = 0; I < qx; ++I) {
       for (unsigned int J = 0; J < qy; ++J) {
-        // int II = x_space.LocGlobMap(I + 1, panel + 1, numpanels) - 1;
-        // if(split == 0)
-        // int JJ = y_space.LocGlobMap(J + 1, panel + 1, numpanels) - 1;
-        int II = x_space.LocGlobMap2(I + 1, panel + 1, mesh) - 1;
-        int JJ = y_space.LocGlobMap2(J + 1, panel + 1, mesh) - 1;
         // Filling the mass matrix entries
-        output(II, JJ) += interaction(I, J);
+        output(x_dofs(I, panel), y_dofs(J, panel)) += interaction(I, J);
       }
     }
   }
@@ -134,6 +134,48 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = dec.solve(rhs);
   return sol;
 }
+
+/**
+ * This function solves the Dirichlet boundary value problem in the same way
+ * as the function above, but solves the linear system iteratively with the
+ * conjugate gradient method, see iterative_solvers::CG(), using only products
+ * with the Galerkin matrix V. V is symmetric positive definite if the
+ * diameter of the domain is smaller than 1, which can always be achieved by
+ * scaling. The Galerkin matrices are still assembled densely as above, only the
+ * factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param g Dirichlet boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the Neumann trace of the solution u
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> g,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  DiscontinuousSpace<0> trial_space;
+  DiscontinuousSpace<0> test_space;
+  // Space used for interpolation of Dirichlet data
+  ContinuousSpace<1> g_interpol_space;
+  // Computing V matrix
+  Eigen::MatrixXd V = single_layer::GalerkinMatrix(mesh, trial_space, order);
+  // Computing K matrix
+  Eigen::MatrixXd K =
+      double_layer::GalerkinMatrix(mesh, g_interpol_space, test_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, g_interpol_space, order);
+  // Getting Dirichlet data at the vertices, interpolation by \f$S_{1}^{0}\f$
+  Eigen::VectorXd g_N = g_interpol_space.Interpolate(g, mesh);
+  // Build rhs for solving
+  Eigen::VectorXd rhs = (0.5 * M + K) * g_N;
+  // Solving for coefficients with products by V
+  return iterative_solvers::CG(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return V * x; }, rhs,
+      options);
+}
 } // namespace direct_first_kind
 
 /**
@@ -186,6 +228,49 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = dec.solve(rhs);
   return sol;
 }
+
+/**
+ * This function solves the Dirichlet boundary value problem in the same way
+ * as the function above, but solves the linear system iteratively with the
+ * GMRES method, see iterative_solvers::GMRES(), using only products with the
+ * Galerkin matrices M and K'. The Galerkin matrices are still assembled densely
+ * as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param g Dirichlet boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the Neumann trace of the solution u
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> g,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  ContinuousSpace<2> trial_space;
+  ContinuousSpace<2> test_space;
+  // Space used for interpolation of Dirichlet data
+  ContinuousSpace<2> g_interpol_space;
+  // Computing W matrix
+  Eigen::MatrixXd W =
+      hypersingular::GalerkinMatrix(mesh, g_interpol_space, order);
+  // Computing K' matrix
+  Eigen::MatrixXd Kp =
+      adj_double_layer::GalerkinMatrix(mesh, trial_space, test_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, trial_space, order);
+  // Getting Dirichlet data
+  Eigen::VectorXd g_N = g_interpol_space.Interpolate(g, mesh);
+  // Build rhs for solving
+  Eigen::VectorXd rhs = W * g_N;
+  // Solving for coefficients with products by the lhs (0.5 * M - Kp)
+  return iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        return 0.5 * (M * x) - Kp * x;
+      },
+      rhs, options);
+}
 } // namespace direct_second_kind
 
 /**
@@ -227,6 +312,45 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = dec.solve(rhs);
   return sol;
 }
+
+/**
+ * This function solves the Dirichlet boundary value problem in the same way
+ * as the function above, but solves the linear system iteratively with the
+ * conjugate gradient method, see iterative_solvers::CG(), using only products
+ * with the Galerkin matrix V. V is symmetric positive definite if the
+ * diameter of the domain is smaller than 1, which can always be achieved by
+ * scaling. The Galerkin matrices are still assembled densely as above, only the
+ * factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param g Dirichlet boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * \f$\Phi\f$ as described above
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> g,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  DiscontinuousSpace<0> trial_space;
+  DiscontinuousSpace<0> test_space;
+  // Space used for interpolation of Dirichlet data
+  ContinuousSpace<1> g_interpol_space;
+  // Computing V matrix
+  Eigen::MatrixXd V = single_layer::GalerkinMatrix(mesh, trial_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, g_interpol_space, order);
+  // Getting Dirichlet data at the vertices, interpolation by \f$S_{1}^{0}\f$
+  Eigen::VectorXd g_N = g_interpol_space.Interpolate(g, mesh);
+  // Build rhs for solving
+  Eigen::VectorXd rhs = M * g_N;
+  // Solving for coefficients with products by V
+  return iterative_solvers::CG(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return V * x; }, rhs,
+      options);
+}
 } // namespace indirect_first_kind
 
 /**
@@ -272,6 +396,48 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = dec.solve(rhs);
   return sol;
 }
+
+/**
+ * This function solves the Dirichlet boundary value problem in the same way
+ * as the function above, but solves the linear system iteratively with the
+ * GMRES method, see iterative_solvers::GMRES(), using only products with the
+ * Galerkin matrices M and K. The Galerkin matrices are still assembled densely
+ * as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param g Dirichlet boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * \f$\Phi\f$ as described above
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> g,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  DiscontinuousSpace<0> trial_space;
+  DiscontinuousSpace<0> test_space;
+  // Space used for interpolation of Dirichlet data
+  ContinuousSpace<1> g_interpol_space;
+  // Computing K matrix
+  Eigen::MatrixXd K =
+      double_layer::GalerkinMatrix(mesh, trial_space, trial_space, order);
+  // Computing mass matrix for lhs
+  Eigen::MatrixXd Ml = MassMatrix(mesh, test_space, trial_space, order);
+  // Computing mass matrix for rhs
+  Eigen::MatrixXd Mr = MassMatrix(mesh, test_space, g_interpol_space, order);
+  // Getting Dirichlet data at the vertices, interpolation by \f$S_{1}^{0}\f$
+  Eigen::VectorXd g_N = g_interpol_space.Interpolate(g, mesh);
+  // Build rhs for solving
+  Eigen::VectorXd rhs = Mr * g_N;
+  // Solving for coefficients with products by the lhs (-0.5 * Ml + K)
+  return iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        return -0.5 * (Ml * x) + K * x;
+      },
+      rhs, options);
+}
 } // namespace indirect_second_kind
 } // namespace dirichlet_bvp
 } // namespace parametricbem2d
@@ -42,29 +42,53 @@ public:
  */
 template <> class DiscontinuousSpace<0> : public AbstractBEMSpace {
 public:
-  // Local to Global Map
-  unsigned int LocGlobMap(unsigned int q, unsigned int n,
-                          unsigned int N) const {
-    // Asserting the index of local shape function and the panel number are
-    // within limits
-    if (!(q <= q_ && n <= N)) {
-      throw std::out_of_range("Panel/RSF index out of range!");
-    }
+  // Number of reference shape functions, known at compile time
+  static constexpr unsigned int Q = 1;
 
-    return n;
+  // Reference shape functions and their derivatives, which can be inlined.
+  // The arguments are not checked, see evaluateShapeFunction().
+  static double shapeFunction(unsigned int /*q*/, double /*t*/) {
+    return 1.;
+  }
+  static double shapeFunctionDot(unsigned int /*q*/, double /*t*/) {
+    return 0.;
+  }
+
+  // Evaluation of all the reference shape functions at a point
+  void evaluateShapeFunctions(double t,
+                              Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunction(q, t);
+  }
+
+  // Evaluation of all the reference shape function derivatives at a point
+  void evaluateShapeFunctionDots(double t,
+                                 Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunctionDot(q, t);
+  }
+
+  // Tabulation of the reference shape functions at the quadrature nodes
+  Eigen::ArrayXXd tabulateShapeFunctions(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunction(q, t); });
+  }
+
+  // Tabulation of the reference shape function derivatives
+  Eigen::ArrayXXd tabulateShapeFunctionDots(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunctionDot(q, t); });
   }
 
   // Local to Global Map
-  unsigned int LocGlobMap2(unsigned int q, unsigned int n,
-                           const ParametrizedMesh &mesh) const {
-    // Getting the mesh information
-    unsigned split = mesh.getSplit();
-    unsigned N = mesh.getNumPanels();
+  unsigned int LocGlobMap(unsigned int q, unsigned int n,
+                          unsigned int N) const {
     // Asserting the index of local shape function and the panel number are
     // within limits
     if (!(q <= q_ && n <= N)) {
       throw std::out_of_range("Panel/RSF index out of range!");
     }
+
     return n;
   }
 
@@ -79,7 +103,7 @@ public:
     // The output vector
     unsigned coeffs_size = getSpaceDim(mesh.getNumPanels());
     Eigen::VectorXd coeffs(coeffs_size);
-    PanelVector panels = mesh.getPanels();
+    const PanelVector &panels = mesh.getPanels();
     // Filling the coefficients
     for (unsigned i = 0; i < coeffs_size; ++i) {
       Eigen::Vector2d pt = panels[i]->operator()(0);
@@ -93,12 +117,12 @@ public:
     // Number of reference shape functions for the space
     q_ = 1;
     // Reference shape function 1, defined using a lambda expression
-    BasisFunctionType b1 = [&](double t) { return 1.; };
+    BasisFunctionType b1 = [](double t) { return shapeFunction(0, t); };
     // Adding the reference shape functions to the vector
     referenceshapefunctions_.push_back(b1);
 
     // Reference shape function 1 derivative, defined using a lambda expression
-    BasisFunctionType b1dot = [&](double t) { return 0.; };
+    BasisFunctionType b1dot = [](double t) { return shapeFunctionDot(0, t); };
     // Adding the reference shape function derivatives to the vector
     referenceshapefunctiondots_.push_back(b1dot);
   }
@@ -110,27 +134,47 @@ public:
  */
 template <> class DiscontinuousSpace<1> : public AbstractBEMSpace {
 public:
-  // Local to Global Map
-  unsigned int LocGlobMap(unsigned int q, unsigned int n,
-                          unsigned int N) const {
-    // Asserting the index of local shape function and the panel number are
-    // within limits
-    if (!(q <= q_ && n <= N)) {
-      throw std::out_of_range("Panel/RSF index out of range!");
-    }
+  // Number of reference shape functions, known at compile time
+  static constexpr unsigned int Q = 2;
 
-    if (q == 1)
-      return n;
-    else
-      return N + n;
+  // Reference shape functions and their derivatives, which can be inlined.
+  // The arguments are not checked, see evaluateShapeFunction().
+  static double shapeFunction(unsigned int q, double t) {
+    return q == 0 ? 0.5 : 0.5 * t;
+  }
+  static double shapeFunctionDot(unsigned int q, double /*t*/) {
+    return q == 0 ? 0. : 0.5;
   }
 
-  // Local to Global Map 2 for annular domain
-  unsigned int LocGlobMap2(unsigned int q, unsigned int n,
-                           const ParametrizedMesh &mesh) const {
-    // Getting the mesh information
-    unsigned split = mesh.getSplit();
-    unsigned N = mesh.getNumPanels();
+  // Evaluation of all the reference shape functions at a point
+  void evaluateShapeFunctions(double t,
+                              Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunction(q, t);
+  }
+
+  // Evaluation of all the reference shape function derivatives at a point
+  void evaluateShapeFunctionDots(double t,
+                                 Eigen::Ref<Eigen::VectorXd> values) const {
+    for (unsigned int q = 0; q < Q; ++q)
+      values(q) = shapeFunctionDot(q, t);
+  }
+
+  // Tabulation of the reference shape functions at the quadrature nodes
+  Eigen::ArrayXXd tabulateShapeFunctions(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunction(q, t); });
+  }
+
+  // Tabulation of the reference shape function derivatives
+  Eigen::ArrayXXd tabulateShapeFunctionDots(const QuadRule &qr) const {
+    return tabulate<Q>(
+        qr, [](unsigned int q, double t) { return shapeFunctionDot(q, t); });
+  }
+
+  // Local to Global Map
+  unsigned int LocGlobMap(unsigned int q, unsigned int n,
+                          unsigned int N) const {
     // Asserting the index of local shape function and the panel number are
     // within limits
     if (!(q <= q_ && n <= N)) {
@@ -155,12 +199,18 @@ public:
     unsigned numpanels = mesh.getNumPanels();
     unsigned coeffs_size = getSpaceDim(numpanels);
     Eigen::VectorXd coeffs(coeffs_size);
-    // Filling the coefficients
-    for (unsigned i = 0; i < numpanels; ++i) {
-      Eigen::Vector2d ptl = mesh.getVertex(i);
-      Eigen::Vector2d ptr = mesh.getVertex((i + 1) % numpanels);
-      coeffs(i) = func(ptl(0), ptl(1)) + func(ptr(0), ptr(1));
-      coeffs(i + numpanels) = func(ptr(0), ptr(1)) - func(ptl(0), ptl(1));
+    // Filling the coefficients, numbered by boundary components as in
+    // LocGlobMap2()
+    for (unsigned c = 0; c < mesh.getNumComponents(); ++c) {
+      unsigned first = mesh.getComponentOffset(c);
+      unsigned size = mesh.getComponentOffset(c + 1) - first;
+      for (unsigned i = first; i < first + size; ++i) {
+        Eigen::Vector2d ptl = mesh.getPanel(i)(-1);
+        Eigen::Vector2d ptr = mesh.getPanel(i)(1);
+        unsigned dof = 2 * first + (i - first);
+        coeffs(dof) = func(ptl(0), ptl(1)) + func(ptr(0), ptr(1));
+        coeffs(dof + size) = func(ptr(0), ptr(1)) - func(ptl(0), ptl(1));
+      }
     }
     return coeffs;
   }
@@ -170,17 +220,17 @@ public:
     // Number of reference shape functions for the space
     q_ = 2;
     // Reference shape function 1, defined using a lambda expression
-    BasisFunctionType b1 = [&](double t) { return 0.5; };
+    BasisFunctionType b1 = [](double t) { return shapeFunction(0, t); };
     // Reference shape function 2, defined using a lambda expression
-    BasisFunctionType b2 = [&](double t) { return 0.5 * t; };
+    BasisFunctionType b2 = [](double t) { return shapeFunction(1, t); };
     // Adding the reference shape functions to the vector
     referenceshapefunctions_.push_back(b1);
     referenceshapefunctions_.push_back(b2);
 
     // Reference shape function 1 derivative, defined using a lambda expression
-    BasisFunctionType b1dot = [&](double t) { return 0.; };
+    BasisFunctionType b1dot = [](double t) { return shapeFunctionDot(0, t); };
     // Reference shape function 2 derivative, defined using a lambda expression
-    BasisFunctionType b2dot = [&](double t) { return 0.5; };
+    BasisFunctionType b2dot = [](double t) { return shapeFunctionDot(1, t); };
     // Adding the reference shape function derivatives to the vector
     referenceshapefunctiondots_.push_back(b1dot);
     referenceshapefunctiondots_.push_back(b2dot);
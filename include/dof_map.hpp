@@ -0,0 +1,140 @@
+/**
+ * \file dof_map.hpp
+ * \brief This file declares the class DofMap which tabulates the local to
+ *        global map (\f$\eqref{eq:lgm}\f$) of a BEM space on a mesh, such that
+ *        the assembly routines can look it up without calling
+ *        AbstractBEMSpace::LocGlobMap2() for every entry.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef DOFMAPHPP
+#define DOFMAPHPP
+
+#include <vector>
+
+#include "abstract_bem_space.hpp"
+#include "parametrized_mesh.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * \class DofMap
+ * \brief This class stores the global shape function numbers of all the local
+ *        shape functions of a BEM space on all the panels of a mesh. The
+ *        numbers of a panel are stored contiguously, in a flat table of size
+ *        numpanels X Q. Unlike AbstractBEMSpace::LocGlobMap2(), all indices
+ *        are 0 based. The table is built once and can be shared by all the
+ *        assembly routines using the same space and mesh, also from several
+ *        threads. The global shape functions of every boundary component of
+ *        the mesh form a contiguous block, see getComponentOffset(). The
+ *        components are the ranges of consecutive panels of
+ *        ParametrizedMesh::getComponent(), not the chains of MeshTopology.
+ */
+class DofMap {
+public:
+  /**
+   * Constructor which tabulates the local to global map of the space on the
+   * mesh.
+   *
+   * @param space The BEM space
+   * @param mesh ParametrizedMesh object containing all the panels
+   */
+  DofMap(const AbstractBEMSpace &space, const ParametrizedMesh &mesh)
+      : numpanels_(mesh.getNumPanels()), Q_(space.getQ()),
+        dim_(space.getSpaceDim(numpanels_)), table_(Q_, numpanels_) {
+    for (unsigned int i = 0; i < numpanels_; ++i)
+      for (unsigned int q = 0; q < Q_; ++q)
+        table_(q, i) = space.LocGlobMap2(q + 1, i + 1, mesh) - 1;
+    // Blocks of the global shape functions of the boundary components
+    for (unsigned int c = 0; c <= mesh.getNumComponents(); ++c)
+      offsets_.push_back(space.getSpaceDim(mesh.getComponentOffset(c)));
+  }
+
+  /**
+   * This function returns the global shape function number for a local shape
+   * function on a panel.
+   *
+   * @param q Index of the local shape function (0 based)
+   * @param i Index of the panel (0 based)
+   * @return Index of the global shape function (0 based)
+   */
+  int operator()(unsigned int q, unsigned int i) const { return table_(q, i); }
+
+  /**
+   * This function returns the global shape function numbers for all the local
+   * shape functions on a panel.
+   *
+   * @param i Index of the panel (0 based)
+   * @return Pointer to the getQ() global shape function numbers (0 based)
+   */
+  const int *getPanelDofs(unsigned int i) const { return table_.col(i).data(); }
+
+  /**
+   * This function returns the whole table, with the entry (q,i) belonging to
+   * the local shape function q on the panel i.
+   *
+   * @return Q X numpanels matrix of global shape function numbers (0 based)
+   */
+  const Eigen::MatrixXi &getTable() const { return table_; }
+
+  /**
+   * This function returns the number of panels in the mesh.
+   *
+   * @return Number of panels
+   */
+  unsigned int getNumPanels() const { return numpanels_; }
+
+  /**
+   * This function returns the number of local shape functions of the space.
+   *
+   * @return Number of local shape functions
+   */
+  unsigned int getQ() const { return Q_; }
+
+  /**
+   * This function returns the dimension of the space on the mesh.
+   *
+   * @return Number of global shape functions
+   */
+  unsigned int getSpaceDim() const { return dim_; }
+
+  /**
+   * This function returns the position where the block of global shape
+   * functions of a boundary component begins. The global shape functions of
+   * the component c are the ones from getComponentOffset(c) to
+   * getComponentOffset(c+1)-1.
+   *
+   * @param c Index of the component (<= number of components of the mesh)
+   * @return Index of the first global shape function of the component c
+   *         (0 based), or the space dimension for c = number of components
+   */
+  unsigned int getComponentOffset(unsigned int c) const { return offsets_[c]; }
+
+private:
+  /**
+   * Number of panels in the mesh
+   */
+  unsigned int numpanels_;
+  /**
+   * Number of local shape functions of the space
+   */
+  unsigned int Q_;
+  /**
+   * Dimension of the space on the mesh
+   */
+  unsigned int dim_;
+  /**
+   * The global shape function numbers, one column per panel
+   */
+  Eigen::MatrixXi table_;
+  /**
+   * Positions of the blocks of the boundary components, followed by the
+   * space dimension
+   */
+  std::vector<unsigned int> offsets_;
+}; // class DofMap
+
+} // namespace parametricbem2d
+
+#endif // DOFMAPHPP
@@ -14,7 +14,10 @@
 
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
+#include "fast_multipole.hpp"
+#include "hierarchical_matrix.hpp"
 #include "logweight_quadrature.hpp"
+#include "panel_geometry_cache.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -113,6 +116,9 @@ Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
  *
  * ComputeIntegralCoinciding()
  *
+ * For disjoint panels, a lower quadrature order than the one of GaussQR is
+ * used if enabled through adaptive_quadrature::setAccuracy().
+ *
  * @param pi Parametrization for the first panel \f$\Pi\f$.
  * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
  * @param trial_space The trial space for evaluating the matrix.
@@ -128,6 +134,102 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
                                   const AbstractBEMSpace &test_space,
                                   const QuadRule &GaussQR);
 
+/**
+ * This function is used to evaluate the Interaction Matrix for the pair of
+ * panels with indices i and j in a mesh, for the bilinear form induced by the
+ * Double Layer BIO, in the case where the panels are completely disjoint. It
+ * computes the same quadrature as the version above but reads the points,
+ * derivative norms and normals at the quadrature nodes from a
+ * PanelGeometryCache instead of evaluating the parametrizations.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param trial_space The trial space for evaluating the matrix.
+ * @param test_space The test space for evaluating the matrix.
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Interaction Matrix
+ * (\f$Q_{test}\f$X\f$Q_{trial}\f$)
+ */
+Eigen::MatrixXd ComputeIntegralGeneral(const PanelGeometryCache &geometry,
+                                       unsigned int i, unsigned int j,
+                                       const AbstractBEMSpace &trial_space,
+                                       const AbstractBEMSpace &test_space,
+                                       const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrix as the version above,
+ * writing it into a matrix provided by the caller. It uses the shape
+ * functions tabulated in TabulatedBEMSpace objects and does not allocate
+ * memory if interaction_matrix already has the size Qtest X Qtrial, such that
+ * the assembly can reuse the matrices for all the panel pairs.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param trial_space The trial space tabulated at the nodes of GaussQR
+ * @param test_space The test space tabulated at the nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrix The Eigen::MatrixXd which is overwritten with the
+ *                           Interaction Matrix (QtestXQtrial)
+ */
+void ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                            unsigned int j,
+                            const TabulatedBEMSpace &trial_space,
+                            const TabulatedBEMSpace &test_space,
+                            const QuadRule &GaussQR,
+                            Eigen::MatrixXd &interaction_matrix);
+
+/**
+ * This function is used to evaluate the Interaction Matrix for the pair of
+ * panels with indices i and j in a mesh, for the bilinear form induced by the
+ * Double Layer BIO. The computation is delegated based on cases like the
+ * version above, using the PanelGeometryCache for disjoint panels.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param trial_space The trial space for evaluating the matrix.
+ * @param test_space The test space for evaluating the matrix.
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Interaction Matrix
+ * (\f$Q_{test}\f$X\f$Q_{trial}\f$)
+ */
+Eigen::MatrixXd InteractionMatrix(const PanelGeometryCache &geometry,
+                                  unsigned int i, unsigned int j,
+                                  const AbstractBEMSpace &trial_space,
+                                  const AbstractBEMSpace &test_space,
+                                  const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrix as the version above,
+ * writing it into a matrix provided by the caller. For disjoint panels, no
+ * memory is allocated, see the corresponding version of
+ * ComputeIntegralGeneral(), also for the lower orders of the adaptive
+ * quadrature once they are tabulated. Coinciding and adjacent panels, O(n)
+ * of the pairs for n panels, are computed by ComputeIntegralCoinciding()
+ * and ComputeIntegralAdjacent(), which allocate their temporaries. This is
+ * the version used for assembly.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param trial_space The trial space tabulated at the nodes of GaussQR
+ * @param test_space The test space tabulated at the nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrix The Eigen::MatrixXd which is overwritten with the
+ *                           Interaction Matrix (QtestXQtrial)
+ */
+void InteractionMatrix(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const TabulatedBEMSpace &trial_space,
+                       const TabulatedBEMSpace &test_space,
+                       const QuadRule &GaussQR,
+                       Eigen::MatrixXd &interaction_matrix);
+
 /**
  * This function is used to evaluate the full Galerkin matrix based on the
  * Bilinear form for Double Layer BIO. It uses the trial and test spaces
@@ -135,6 +237,8 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
  * It evaluates the matrix by panel oriented assembly (\f$\ref{pc:ass}\f$) by
  * first evaluating the interaction matrix for all possible pairs of panels and
  * then using the local to global map of BEM spaces to fill the matrix entries.
+ * The interaction matrices are computed on parallel threads, see
+ * parallel_assembly::getNumThreads().
  *
  * @param mesh ParametrizedMesh object containing all the panels in the form
  *             of small parametrized curves
@@ -148,6 +252,28 @@ Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &test_space,
                                const unsigned int &N);
 
+/**
+ * This function evaluates the same Galerkin matrix as GalerkinMatrix() for
+ * the Double Layer BIO, using an already tabulated geometry of the mesh. This
+ * allows several Galerkin matrices to be assembled from a single pass over
+ * the geometry of the panels.
+ *
+ * @param mesh ParametrizedMesh object containing all the panels in the form
+ *             of small parametrized curves
+ * @param geometry PanelGeometryCache for the mesh, tabulated at the nodes of
+ *                 GaussQR
+ * @param trial_space The trial space for evaluating the matrix.
+ * @param test_space The test space for evaluating the matrix.
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Galerkin Matrix for the given mesh and space
+ */
+Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh &mesh,
+                               const PanelGeometryCache &geometry,
+                               const AbstractBEMSpace &trial_space,
+                               const AbstractBEMSpace &test_space,
+                               const QuadRule &GaussQR);
+
 /**
  * This function is used to evaluate the Double Layer Potential given by
  * \f$\Psi^{\Delta}_{DL}\Phi(x) = \int_{\Gamma} \frac{1}{2\Pi}
@@ -155,7 +281,8 @@ Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
  * = \sum_{i=1}^{N} c_{i} b^{i}_{N}\f$ where \f$c_{i}\f$ are the coefficients
  * and \f$b^{i}_{N}\f$ are the basis functions for the given BEM space and mesh.
  * The Double Layer Potential is evaluated using quadrature, at the evaluation
- * point x passed as an input.
+ * point x passed as an input. Panels close to x are subdivided, see
+ * adaptive_quadrature::IntegrateNearPoint().
  *
  * @param x An Eigen::Vector2d type for the evaluation point
  * @param coeffs An Eigen::VectorXd type containing the coefficients \f$c_{i}\f$
@@ -170,6 +297,115 @@ double Potential(const Eigen::Vector2d &x, const Eigen::VectorXd &coeffs,
                  const ParametrizedMesh &mesh, const AbstractBEMSpace &space,
                  const unsigned int &N);
 
+/**
+ * This function computes the corrections of the Double Layer Potential,
+ * evaluated with the Gauss rule of GaussQR on every panel, for the panels
+ * which are close to the evaluation points. For these panels, the
+ * admissibility with respect to the point exceeds
+ * adaptive_quadrature::POTENTIAL_RHO and the Gauss rule is inaccurate. Their
+ * contribution is replaced by the integral from
+ * adaptive_quadrature::IntegrateNearPoint(), which subdivides the panel
+ * towards the point. The other panels keep the cheap Gauss rule.
+ *
+ * @param points An Eigen::Matrix2Xd type with the evaluation points as columns
+ * @param coeffs An Eigen::VectorXd type containing the coefficients \f$c_{i}\f$
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param geometry PanelGeometryCache for the mesh and GaussQR
+ * @param space The BEM space used for evaluating the Double Layer Potential
+ * @param GaussQR QuadRule object on [-1,1] used on the panels
+ * @return Eigen::VectorXd with the corrections to be added at the points
+ */
+Eigen::VectorXd PotentialNearFieldCorrection(
+    const Eigen::Matrix2Xd &points, const Eigen::VectorXd &coeffs,
+    const ParametrizedMesh &mesh, const PanelGeometryCache &geometry,
+    const AbstractBEMSpace &space, const QuadRule &GaussQR);
+
+/**
+ * This function evaluates the Double Layer Potential, see Potential(), at
+ * many evaluation points. The quadrature nodes and the weighted values of
+ * \f$\Phi\f$ (see WeightedDensity()) are tabulated once for all the points,
+ * and the points are distributed over threads. The panels close to a point
+ * are subdivided, see PotentialNearFieldCorrection().
+ *
+ * @param points An Eigen::Matrix2Xd type with the evaluation points as columns
+ * @param coeffs An Eigen::VectorXd type containing the coefficients \f$c_{i}\f$
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param space The BEM space used for evaluating the Double Layer Potential
+ * @param N Order for Gauss Quadrature
+ * @return Eigen::VectorXd with the Double Layer Potential at the points
+ */
+Eigen::VectorXd Potentials(const Eigen::Matrix2Xd &points,
+                           const Eigen::VectorXd &coeffs,
+                           const ParametrizedMesh &mesh,
+                           const AbstractBEMSpace &space,
+                           const unsigned int &N);
+
+/**
+ * This function evaluates the Double Layer Potential at many evaluation
+ * points like Potentials(), with the same
+ * quadrature, but in \f$O(M+n)\f$ operations for M points and n quadrature
+ * nodes. The sum over the nodes is evaluated by LaplaceFMM, which treats
+ * nodes close to a point directly and the others through expansions. The
+ * panels close to a point are subdivided, see PotentialNearFieldCorrection().
+ *
+ * @param points An Eigen::Matrix2Xd type with the evaluation points as columns
+ * @param coeffs An Eigen::VectorXd type containing the coefficients \f$c_{i}\f$
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param space The BEM space used for evaluating the Double Layer Potential
+ * @param N Order for Gauss Quadrature
+ * @param options The parameters of the FMM
+ * @return Eigen::VectorXd with the Double Layer Potential at the points
+ */
+Eigen::VectorXd FastMultipolePotential(
+    const Eigen::Matrix2Xd &points, const Eigen::VectorXd &coeffs,
+    const ParametrizedMesh &mesh, const AbstractBEMSpace &space,
+    const unsigned int &N,
+    const FastMultipoleOptions &options = FastMultipoleOptions());
+
+/**
+ * This function evaluates the Galerkin matrix for the Double Layer BIO as a
+ * hierarchical matrix, see HierarchicalMatrix. The blocks for admissible
+ * pairs of clusters of panels are approximated by adaptive cross
+ * approximation of the interaction matrices from ComputeIntegralGeneral(),
+ * the other blocks are computed with InteractionMatrix().
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param trial_space The trial space for evaluating the matrix.
+ * @param test_space The test space for evaluating the matrix.
+ * @param N Order for Gauss Quadrature
+ * @param options The parameters of the hierarchical matrix approximation
+ * @return A HierarchicalMatrix approximating the Galerkin matrix
+ */
+HierarchicalMatrix HierarchicalGalerkinMatrix(
+    const ParametrizedMesh &mesh, const AbstractBEMSpace &trial_space,
+    const AbstractBEMSpace &test_space, const unsigned int &N,
+    const HierarchicalMatrixOptions &options = HierarchicalMatrixOptions());
+
+/**
+ * This function sets up the matrix-vector product with the Galerkin matrix
+ * for the Double Layer BIO by the fast multipole method, see
+ * FastMultipoleOperator. The tensor product Gauss quadrature of
+ * ComputeIntegralGeneral() is evaluated for all the panel pairs by the FMM,
+ * and corrected with InteractionMatrix() for the coinciding and adjacent
+ * panel pairs.
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param trial_space The trial space for evaluating the matrix.
+ * @param test_space The test space for evaluating the matrix.
+ * @param N Order for Gauss Quadrature
+ * @param options The parameters of the FMM
+ * @return A FastMultipoleOperator for the Galerkin matrix
+ */
+FastMultipoleOperator FastMultipoleGalerkinOperator(
+    const ParametrizedMesh &mesh, const AbstractBEMSpace &trial_space,
+    const AbstractBEMSpace &test_space, const unsigned int &N,
+    const FastMultipoleOptions &options = FastMultipoleOptions());
+
 } // namespace double_layer
 } // namespace parametricbem2d
 
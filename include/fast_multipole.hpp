@@ -0,0 +1,690 @@
+/**
+ * \file fast_multipole.hpp
+ * \brief This file defines a fast multipole method (FMM) for the 2D Laplace
+ *        kernels log|x-y| and (x-y).n/|x-y|^2, using multipole and local
+ *        expansions in complex variables on a quadtree. On top of it, the
+ *        matrix-vector products with the Galerkin matrices of the Single and
+ *        Double Layer BIOs are evaluated in \f$O(n)\f$ operations, correcting
+ *        the near field with the interaction matrices of the operators.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef FASTMULTIPOLEHPP
+#define FASTMULTIPOLEHPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "abstract_bem_space.hpp"
+#include "dof_map.hpp"
+#include "logweight_quadrature.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
+#include "parametrized_mesh.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This structure holds the parameters of the fast multipole method.
+ */
+struct FastMultipoleOptions {
+  /**
+   * Number of terms of the multipole and local expansions
+   */
+  unsigned order = 24;
+  /**
+   * Maximum number of points in a box of the quadtree which is not subdivided
+   */
+  unsigned leafsize = 32;
+  /**
+   * Two boxes interact through expansions if the sum of their radii is at
+   * most theta times the distance of their centers. The error of the
+   * expansions decays like theta^order.
+   */
+  double theta = 0.5;
+};
+
+/**
+ * \class LaplaceFMM
+ * \brief This class evaluates the potentials
+ *        \f$ \phi(x_k) = \sum_l q_l \log|x_k-y_l| +
+ *        d_l \cdot (x_k-y_l)/|x_k-y_l|^2 \f$
+ *        of charges \f$q_l\f$ and dipoles \f$d_l\f$ at the sources
+ *        \f$y_l\f$ for all targets \f$x_k\f$, with the fast multipole method.
+ *        Source and target points which coincide do not interact. The
+ *        quadtree and the interaction lists are built once at construction,
+ *        such that the potentials can be evaluated for many charges.
+ */
+class LaplaceFMM {
+public:
+  /**
+   * Constructor which builds the quadtree over the sources and targets and
+   * the interaction lists of its boxes, by a dual traversal of the tree.
+   *
+   * @param sources The source points, one per column
+   * @param targets The target points, one per column
+   * @param options The parameters of the method
+   */
+  LaplaceFMM(const Eigen::Matrix2Xd &sources, const Eigen::Matrix2Xd &targets,
+             const FastMultipoleOptions &options = FastMultipoleOptions());
+
+  /**
+   * This function evaluates the potentials at the targets.
+   *
+   * @param charges The charges at the sources, or an empty vector if there
+   *                are none
+   * @param dipoles The dipole moments at the sources, one per column, or an
+   *                empty matrix if there are none
+   * @return The potentials at the targets
+   */
+  Eigen::VectorXd Evaluate(const Eigen::VectorXd &charges,
+                           const Eigen::Matrix2Xd &dipoles) const;
+
+  /**
+   * This function returns the number of boxes in the quadtree
+   *
+   * @return Number of boxes
+   */
+  unsigned int getNumBoxes() const { return boxes_.size(); }
+
+private:
+  /**
+   * \struct Box
+   * \brief A square of the quadtree with the ranges of the sources and
+   *        targets inside it in source_order_ and target_order_, and the
+   *        boxes it interacts with through expansions (far) or directly
+   *        (near).
+   */
+  struct Box {
+    std::complex<double> center;
+    double radius; // Largest distance of a point in the box to the center
+    unsigned int source_begin, source_end, target_begin, target_end;
+    std::vector<unsigned int> children;
+    std::vector<unsigned int> far, near;
+  };
+
+  /**
+   * This function adds the box with the given center and half width and its
+   * descendants to boxes_, sorting the sources and targets by box
+   *
+   * @return Index of the box in boxes_
+   */
+  unsigned int BuildTree(std::complex<double> center, double halfwidth,
+                         unsigned int source_begin, unsigned int source_end,
+                         unsigned int target_begin, unsigned int target_end,
+                         unsigned int depth);
+
+  /**
+   * This function adds the interactions of the target box a with the source
+   * box b and their descendants to the interaction lists
+   */
+  void BuildInteractionLists(unsigned int a, unsigned int b);
+
+  /**
+   * Sources and targets as complex numbers
+   */
+  std::vector<std::complex<double>> sources_, targets_;
+  /**
+   * Indices of the sources and targets, sorted by box
+   */
+  std::vector<unsigned int> source_order_, target_order_;
+  /**
+   * Boxes of the quadtree, each box is stored before its children
+   */
+  std::vector<Box> boxes_;
+  /**
+   * Parameters of the method
+   */
+  FastMultipoleOptions options_;
+  /**
+   * Binomial coefficients, binomial_(n,k) = n choose k
+   */
+  Eigen::MatrixXd binomial_;
+}; // class LaplaceFMM
+
+/**
+ * \class FastMultipoleOperator
+ * \brief This class evaluates the matrix-vector product with the Galerkin
+ *        matrix of the Single or Double Layer BIO without assembling it. The
+ *        tensor product Gauss quadrature of the disjoint panel pairs, see
+ *        ComputeIntegralGeneral(), is evaluated for all panel pairs at once
+ *        with LaplaceFMM. For the coinciding and adjacent panel pairs, the
+ *        quadrature is replaced by the interaction matrices of the operator,
+ *        which are computed once at construction.
+ */
+class FastMultipoleOperator {
+public:
+  /**
+   * The kernel of the operator
+   */
+  enum class Kernel {
+    SingleLayer, // -1/(2 pi) log|x-y|
+    DoubleLayer  // 1/(2 pi) (x-y).n(y)/|x-y|^2
+  };
+
+  /**
+   * Constructor which sets up the FMM for the quadrature nodes of all the
+   * panels and computes the near field corrections in parallel.
+   *
+   * @tparam NearKernel Template type for the interaction matrices of the
+   *                    coinciding and adjacent panel pairs. Should support
+   *                    evaluation of the form near(i,j) which returns the
+   *                    Qtest X Qtrial interaction matrix for the test panel i
+   *                    and the trial panel j (0 based indices)
+   * @param mesh ParametrizedMesh object containing all the panels
+   * @param geometry PanelGeometryCache for the mesh and GaussQR
+   * @param trial_space The trial space for evaluating the matrix
+   * @param test_space The test space for evaluating the matrix
+   * @param GaussQR QuadRule object on [-1,1] for the disjoint panel pairs
+   * @param kernel The kernel of the operator
+   * @param near The interaction matrices for the near field
+   * @param options The parameters of the FMM
+   */
+  template <typename NearKernel>
+  FastMultipoleOperator(const ParametrizedMesh &mesh,
+                        const PanelGeometryCache &geometry,
+                        const AbstractBEMSpace &trial_space,
+                        const AbstractBEMSpace &test_space,
+                        const QuadRule &GaussQR, Kernel kernel,
+                        const NearKernel &near,
+                        const FastMultipoleOptions &options =
+                            FastMultipoleOptions());
+
+  /**
+   * This function returns the number of rows of the Galerkin matrix
+   *
+   * @return Dimension of the test space
+   */
+  unsigned int rows() const { return rows_; }
+
+  /**
+   * This function returns the number of columns of the Galerkin matrix
+   *
+   * @return Dimension of the trial space
+   */
+  unsigned int cols() const { return cols_; }
+
+  /**
+   * This function evaluates the matrix-vector product with the Galerkin
+   * matrix
+   *
+   * @param x Vector of coefficients in the trial space
+   * @return The product, a vector of size rows()
+   */
+  Eigen::VectorXd operator*(const Eigen::VectorXd &x) const;
+
+private:
+  /**
+   * \struct Correction
+   * \brief The difference of the interaction matrix and the quadrature
+   *        evaluated by the FMM, for the test panel i and the trial panel j
+   */
+  struct Correction {
+    unsigned int i, j;
+    Eigen::MatrixXd matrix;
+  };
+
+  /**
+   * Dimensions of the Galerkin matrix
+   */
+  unsigned int rows_, cols_;
+  /**
+   * The kernel of the operator
+   */
+  Kernel kernel_;
+  /**
+   * Global indices of the local coefficients, the entry (I,i) belongs to the
+   * Ith local shape function on the ith panel
+   */
+  Eigen::MatrixXi test_dofs_, trial_dofs_;
+  /**
+   * Shape functions times quadrature weights and derivative norms at the
+   * quadrature nodes, the entry (I,k) belongs to the Ith local shape function
+   * and the kth node of all the panels (node after node, panel after panel)
+   */
+  Eigen::MatrixXd test_weights_, trial_weights_;
+  /**
+   * Unit normals at the quadrature nodes of all the panels
+   */
+  Eigen::Matrix2Xd normals_;
+  /**
+   * FMM for the quadrature nodes of all the panels
+   */
+  LaplaceFMM fmm_;
+  /**
+   * Near field corrections
+   */
+  std::vector<Correction> corrections_;
+}; // class FastMultipoleOperator
+
+/**
+ * This function finds the pairs of distinct adjacent panels in a mesh, with
+ * the same criterion as the InteractionMatrix() functions of the operators,
+ * see MeshTopology::getRelation().
+ *
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @return The pairs (i,j) of adjacent panels, both (i,j) and (j,i) are
+ *         included
+ */
+inline std::vector<std::pair<unsigned int, unsigned int>>
+FindAdjacentPanels(const ParametrizedMesh &mesh) {
+  unsigned int numpanels = mesh.getNumPanels();
+  const MeshTopology &topology = mesh.getTopology();
+  std::vector<std::pair<unsigned int, unsigned int>> pairs;
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    unsigned int j = topology.getNext(i);
+    if (j == numpanels || j == i)
+      continue;
+    pairs.push_back(std::make_pair(i, j));
+    pairs.push_back(std::make_pair(j, i));
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  return pairs;
+}
+
+inline LaplaceFMM::LaplaceFMM(const Eigen::Matrix2Xd &sources,
+                              const Eigen::Matrix2Xd &targets,
+                              const FastMultipoleOptions &options)
+    : options_(options) {
+  unsigned int numsources = sources.cols();
+  unsigned int numtargets = targets.cols();
+  for (unsigned int l = 0; l < numsources; ++l) {
+    sources_.push_back(std::complex<double>(sources(0, l), sources(1, l)));
+    source_order_.push_back(l);
+  }
+  for (unsigned int k = 0; k < numtargets; ++k) {
+    targets_.push_back(std::complex<double>(targets(0, k), targets(1, k)));
+    target_order_.push_back(k);
+  }
+  // Binomial coefficients for the translations of the expansions
+  unsigned int p = options_.order;
+  binomial_ = Eigen::MatrixXd::Zero(2 * p + 1, 2 * p + 1);
+  for (unsigned int n = 0; n <= 2 * p; ++n) {
+    binomial_(n, 0) = 1;
+    for (unsigned int k = 1; k <= n; ++k)
+      binomial_(n, k) = binomial_(n - 1, k - 1) + binomial_(n - 1, k);
+  }
+  if (numsources == 0 || numtargets == 0)
+    return;
+  // Square containing all the points
+  Eigen::Matrix2Xd points(2, numsources + numtargets);
+  points << sources, targets;
+  Eigen::Vector2d lower = points.rowwise().minCoeff();
+  Eigen::Vector2d upper = points.rowwise().maxCoeff();
+  Eigen::Vector2d center = 0.5 * (lower + upper);
+  double halfwidth = 0.5 * (upper - lower).maxCoeff();
+  BuildTree(std::complex<double>(center(0), center(1)), halfwidth, 0,
+            numsources, 0, numtargets, 0);
+  BuildInteractionLists(0, 0);
+}
+
+inline unsigned int
+LaplaceFMM::BuildTree(std::complex<double> center, double halfwidth,
+                      unsigned int source_begin, unsigned int source_end,
+                      unsigned int target_begin, unsigned int target_end,
+                      unsigned int depth) {
+  Box box;
+  box.center = center;
+  box.radius = 0;
+  for (unsigned int l = source_begin; l < source_end; ++l)
+    box.radius =
+        std::max(box.radius, std::abs(sources_[source_order_[l]] - center));
+  for (unsigned int k = target_begin; k < target_end; ++k)
+    box.radius =
+        std::max(box.radius, std::abs(targets_[target_order_[k]] - center));
+  box.source_begin = source_begin;
+  box.source_end = source_end;
+  box.target_begin = target_begin;
+  box.target_end = target_end;
+  unsigned int index = boxes_.size();
+  boxes_.push_back(box);
+  // Boxes with few points are not subdivided. The depth is limited for
+  // points which cannot be separated.
+  if (source_end - source_begin + target_end - target_begin <=
+          options_.leafsize ||
+      depth >= 50)
+    return index;
+  // Sorting the points of the box by quadrant, the quadrant q lies to the
+  // right of the center if q is odd and above the center if q > 1
+  auto quadrant = [&](std::complex<double> z) {
+    return (z.real() >= center.real()) + 2 * (z.imag() >= center.imag());
+  };
+  auto sort_by_quadrant = [&](const std::vector<std::complex<double>> &points,
+                              std::vector<unsigned int> &order,
+                              unsigned int begin, unsigned int end) {
+    std::vector<unsigned int> bounds(5, begin);
+    std::stable_sort(order.begin() + begin, order.begin() + end,
+                     [&](unsigned int a, unsigned int b) {
+                       return quadrant(points[a]) < quadrant(points[b]);
+                     });
+    for (int q = 0; q < 4; ++q)
+      bounds[q + 1] = std::partition_point(order.begin() + bounds[q],
+                                           order.begin() + end,
+                                           [&](unsigned int a) {
+                                             return quadrant(points[a]) <= q;
+                                           }) -
+                      order.begin();
+    return bounds;
+  };
+  std::vector<unsigned int> source_bounds =
+      sort_by_quadrant(sources_, source_order_, source_begin, source_end);
+  std::vector<unsigned int> target_bounds =
+      sort_by_quadrant(targets_, target_order_, target_begin, target_end);
+  for (unsigned int q = 0; q < 4; ++q) {
+    if (source_bounds[q] == source_bounds[q + 1] &&
+        target_bounds[q] == target_bounds[q + 1])
+      continue;
+    std::complex<double> shift(q % 2 ? 1 : -1, q > 1 ? 1 : -1);
+    unsigned int child = BuildTree(
+        center + 0.5 * halfwidth * shift, 0.5 * halfwidth, source_bounds[q],
+        source_bounds[q + 1], target_bounds[q], target_bounds[q + 1],
+        depth + 1);
+    boxes_[index].children.push_back(child);
+  }
+  return index;
+}
+
+inline void LaplaceFMM::BuildInteractionLists(unsigned int a, unsigned int b) {
+  const Box &target = boxes_[a];
+  const Box &source = boxes_[b];
+  if (target.target_begin == target.target_end ||
+      source.source_begin == source.source_end)
+    return; // Nothing to interact
+  // Well separated boxes interact through the expansions
+  if (target.radius + source.radius <=
+      options_.theta * std::abs(target.center - source.center)) {
+    boxes_[a].far.push_back(b);
+    return;
+  }
+  bool target_leaf = target.children.empty();
+  bool source_leaf = source.children.empty();
+  if (target_leaf && source_leaf) {
+    boxes_[a].near.push_back(b);
+    return;
+  }
+  // Subdividing the larger box
+  if (source_leaf || (!target_leaf && target.radius >= source.radius)) {
+    std::vector<unsigned int> children = target.children;
+    for (unsigned int child : children)
+      BuildInteractionLists(child, b);
+  } else {
+    std::vector<unsigned int> children = source.children;
+    for (unsigned int child : children)
+      BuildInteractionLists(a, child);
+  }
+}
+
+inline Eigen::VectorXd
+LaplaceFMM::Evaluate(const Eigen::VectorXd &charges,
+                     const Eigen::Matrix2Xd &dipoles) const {
+  typedef std::complex<double> Complex;
+  unsigned int numboxes = boxes_.size();
+  unsigned int p = options_.order;
+  bool has_charges = charges.size() > 0;
+  bool has_dipoles = dipoles.cols() > 0;
+  assert(!has_charges ||
+         charges.size() == static_cast<Eigen::Index>(sources_.size()));
+  assert(!has_dipoles ||
+         dipoles.cols() == static_cast<Eigen::Index>(sources_.size()));
+  Eigen::VectorXd potentials = Eigen::VectorXd::Zero(targets_.size());
+  // Dipole moments as complex numbers
+  std::vector<Complex> moments(has_dipoles ? sources_.size() : 0);
+  for (unsigned int l = 0; l < moments.size(); ++l)
+    moments[l] = Complex(dipoles(0, l), dipoles(1, l));
+  // Multipole expansions, a_0 log(z-c) + sum_k a_k (z-c)^(-k), and local
+  // expansions, sum_l b_l (z-c)^l, one column per box. The potentials are
+  // the real parts.
+  Eigen::MatrixXcd multipoles = Eigen::MatrixXcd::Zero(p + 1, numboxes);
+  Eigen::MatrixXcd locals = Eigen::MatrixXcd::Zero(p + 1, numboxes);
+
+  // Upward pass, children are stored after their parents
+  for (unsigned int b = numboxes; b-- > 0;) {
+    const Box &box = boxes_[b];
+    if (box.children.empty()) {
+      // Expansions of the sources in the leaf
+      for (unsigned int s = box.source_begin; s < box.source_end; ++s) {
+        unsigned int l = source_order_[s];
+        Complex y = sources_[l] - box.center;
+        Complex power = 1; // (y-c)^(k-1)
+        if (has_charges)
+          multipoles(0, b) += charges(l);
+        for (unsigned int k = 1; k <= p; ++k) {
+          if (has_charges)
+            multipoles(k, b) -= charges(l) * power * y / double(k);
+          if (has_dipoles)
+            multipoles(k, b) += moments[l] * power;
+          power *= y;
+        }
+      }
+      continue;
+    }
+    // Translating the expansions of the children to the center of the box
+    for (unsigned int child : box.children) {
+      Complex z0 = boxes_[child].center - box.center;
+      Complex a0 = multipoles(0, child);
+      multipoles(0, b) += a0;
+      Complex z0_power = 1; // z0^l
+      for (unsigned int l = 1; l <= p; ++l) {
+        z0_power *= z0;
+        Complex value = -a0 * z0_power / double(l);
+        Complex z0_power_lk = 1; // z0^(l-k)
+        for (unsigned int k = l; k >= 1; --k) {
+          value +=
+              multipoles(k, child) * z0_power_lk * binomial_(l - 1, k - 1);
+          z0_power_lk *= z0;
+        }
+        multipoles(l, b) += value;
+      }
+    }
+  }
+
+  // Interactions of the boxes, in parallel as every box only writes to its
+  // own local expansion and targets
+  parallel_assembly::ParallelFor(0, numboxes, [&](unsigned int b) {
+    const Box &box = boxes_[b];
+    // Translating the multipole expansions of the far boxes to local
+    // expansions about the center of the box
+    Eigen::VectorXcd terms(p + 1);
+    for (unsigned int f : box.far) {
+      Complex z0 = boxes_[f].center - box.center;
+      Complex inverse = 1. / z0;
+      Complex a0 = multipoles(0, f);
+      // terms(k) = a_k (-1/z0)^k
+      Complex power = 1;
+      for (unsigned int k = 1; k <= p; ++k) {
+        power *= -inverse;
+        terms(k) = multipoles(k, f) * power;
+      }
+      locals(0, b) += a0 * std::log(-z0) + terms.tail(p).sum();
+      Complex inverse_power = 1; // z0^(-l)
+      for (unsigned int l = 1; l <= p; ++l) {
+        inverse_power *= inverse;
+        Complex value = -a0 / double(l);
+        for (unsigned int k = 1; k <= p; ++k)
+          value += terms(k) * binomial_(l + k - 1, k - 1);
+        locals(l, b) += value * inverse_power;
+      }
+    }
+    // Direct interactions with the near boxes
+    for (unsigned int t = box.target_begin; t < box.target_end; ++t) {
+      unsigned int k = target_order_[t];
+      Complex x = targets_[k];
+      double potential = 0;
+      for (unsigned int n : box.near) {
+        for (unsigned int s = boxes_[n].source_begin; s < boxes_[n].source_end;
+             ++s) {
+          unsigned int l = source_order_[s];
+          Complex z = x - sources_[l];
+          if (z == Complex(0)) // Coinciding points do not interact
+            continue;
+          if (has_charges)
+            potential += charges(l) * std::log(std::abs(z));
+          if (has_dipoles)
+            potential += std::real(moments[l] / z);
+        }
+      }
+      potentials(k) += potential;
+    }
+  });
+
+  // Downward pass, translating the local expansions to the children
+  for (unsigned int b = 0; b < numboxes; ++b) {
+    for (unsigned int child : boxes_[b].children) {
+      Complex z0 = boxes_[child].center - boxes_[b].center;
+      for (unsigned int l = 0; l <= p; ++l) {
+        Complex value = 0;
+        Complex z0_power = 1; // z0^(k-l)
+        for (unsigned int k = l; k <= p; ++k) {
+          value += locals(k, b) * binomial_(k, l) * z0_power;
+          z0_power *= z0;
+        }
+        locals(l, child) += value;
+      }
+    }
+  }
+
+  // Evaluating the local expansions at the targets of the leaves
+  parallel_assembly::ParallelFor(0, numboxes, [&](unsigned int b) {
+    const Box &box = boxes_[b];
+    if (!box.children.empty())
+      return;
+    for (unsigned int t = box.target_begin; t < box.target_end; ++t) {
+      unsigned int k = target_order_[t];
+      Complex z = targets_[k] - box.center;
+      // Horner scheme
+      Complex value = locals(p, b);
+      for (unsigned int l = p; l-- > 0;)
+        value = value * z + locals(l, b);
+      potentials(k) += value.real();
+    }
+  });
+  return potentials;
+}
+
+template <typename NearKernel>
+FastMultipoleOperator::FastMultipoleOperator(
+    const ParametrizedMesh &mesh, const PanelGeometryCache &geometry,
+    const AbstractBEMSpace &trial_space, const AbstractBEMSpace &test_space,
+    const QuadRule &GaussQR, Kernel kernel, const NearKernel &near,
+    const FastMultipoleOptions &options)
+    : kernel_(kernel),
+      fmm_(Eigen::Matrix2Xd(2, 0), Eigen::Matrix2Xd(2, 0), options) {
+  unsigned int numpanels = mesh.getNumPanels();
+  unsigned int N = GaussQR.n;
+  assert(geometry.getNumNodes() == N);
+  rows_ = test_space.getSpaceDim(numpanels);
+  cols_ = trial_space.getSpaceDim(numpanels);
+  unsigned int Qtest = test_space.getQ();
+  unsigned int Qtrial = trial_space.getQ();
+  // Tabulating the local to global maps
+  test_dofs_ = DofMap(test_space, mesh).getTable();
+  trial_dofs_ = DofMap(trial_space, mesh).getTable();
+  // Tabulating the quadrature nodes, weights and normals of all the panels,
+  // as the functions F and G in \f$\eqref{eq:titg}\f$ times the weights
+  Eigen::Matrix2Xd points(2, N * numpanels);
+  normals_.resize(2, N * numpanels);
+  test_weights_.resize(Qtest, N * numpanels);
+  trial_weights_.resize(Qtrial, N * numpanels);
+  Eigen::ArrayXXd test_shapes = test_space.tabulateShapeFunctions(GaussQR);
+  Eigen::ArrayXXd trial_shapes = trial_space.tabulateShapeFunctions(GaussQR);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    points.middleCols(i * N, N) = geometry.getPoints(i);
+    normals_.middleCols(i * N, N) = geometry.getNormals(i);
+    PanelGeometryCache::ConstValuesView norms = geometry.getDerivativeNorms(i);
+    for (unsigned int k = 0; k < N; ++k) {
+      for (unsigned int I = 0; I < Qtest; ++I)
+        test_weights_(I, i * N + k) =
+            test_shapes(I, k) * GaussQR.w(k) * norms(k);
+      for (unsigned int J = 0; J < Qtrial; ++J)
+        trial_weights_(J, i * N + k) =
+            trial_shapes(J, k) * GaussQR.w(k) * norms(k);
+    }
+  }
+  fmm_ = LaplaceFMM(points, points, options);
+  // Near field: the coinciding and the adjacent panel pairs
+  std::vector<std::pair<unsigned int, unsigned int>> pairs =
+      FindAdjacentPanels(mesh);
+  for (unsigned int i = 0; i < numpanels; ++i)
+    pairs.push_back(std::make_pair(i, i));
+  corrections_.resize(pairs.size());
+  parallel_assembly::ParallelFor(0, pairs.size(), [&](unsigned int c) {
+    unsigned int i = pairs[c].first;
+    unsigned int j = pairs[c].second;
+    // The quadrature evaluated by the FMM for the pair, without the
+    // coinciding nodes
+    Eigen::MatrixXd quadrature = Eigen::MatrixXd::Zero(Qtest, Qtrial);
+    for (unsigned int k = 0; k < N; ++k) {
+      for (unsigned int l = 0; l < N; ++l) {
+        Eigen::Vector2d difference =
+            points.col(i * N + k) - points.col(j * N + l);
+        if (difference.squaredNorm() == 0)
+          continue;
+        double value =
+            kernel == Kernel::SingleLayer
+                ? -1. / (2 * M_PI) * log(difference.norm())
+                : 1. / (2 * M_PI) * difference.dot(normals_.col(j * N + l)) /
+                      difference.squaredNorm();
+        quadrature += value * test_weights_.col(i * N + k) *
+                      trial_weights_.col(j * N + l).transpose();
+      }
+    }
+    corrections_[c].i = i;
+    corrections_[c].j = j;
+    corrections_[c].matrix = near(i, j) - quadrature;
+  });
+}
+
+inline Eigen::VectorXd FastMultipoleOperator::
+operator*(const Eigen::VectorXd &x) const {
+  assert(x.size() == cols_);
+  unsigned int numpanels = trial_dofs_.cols();
+  unsigned int N = trial_weights_.cols() / std::max(1u, numpanels);
+  unsigned int Qtest = test_dofs_.rows();
+  unsigned int Qtrial = trial_dofs_.rows();
+  // Strengths of the sources at the quadrature nodes
+  Eigen::VectorXd strengths = Eigen::VectorXd::Zero(N * numpanels);
+  for (unsigned int j = 0; j < numpanels; ++j)
+    for (unsigned int J = 0; J < Qtrial; ++J)
+      strengths.segment(j * N, N) += x(trial_dofs_(J, j)) *
+                                     trial_weights_.row(J)
+                                         .segment(j * N, N)
+                                         .transpose();
+  // Potentials at the quadrature nodes
+  Eigen::VectorXd potentials;
+  if (kernel_ == Kernel::SingleLayer)
+    potentials = -1. / (2 * M_PI) *
+                 fmm_.Evaluate(strengths, Eigen::Matrix2Xd(2, 0));
+  else
+    potentials = 1. / (2 * M_PI) *
+                 fmm_.Evaluate(Eigen::VectorXd(),
+                               normals_ * strengths.asDiagonal());
+  // Testing with the test space
+  Eigen::VectorXd y = Eigen::VectorXd::Zero(rows_);
+  for (unsigned int i = 0; i < numpanels; ++i)
+    for (unsigned int I = 0; I < Qtest; ++I)
+      y(test_dofs_(I, i)) += test_weights_.row(I)
+                                 .segment(i * N, N)
+                                 .transpose()
+                                 .dot(potentials.segment(i * N, N));
+  // Near field corrections
+  for (const Correction &correction : corrections_) {
+    Eigen::VectorXd x_local(Qtrial);
+    for (unsigned int J = 0; J < Qtrial; ++J)
+      x_local(J) = x(trial_dofs_(J, correction.j));
+    Eigen::VectorXd y_local = correction.matrix * x_local;
+    for (unsigned int I = 0; I < Qtest; ++I)
+      y(test_dofs_(I, correction.i)) += y_local(I);
+  }
+  return y;
+}
+
+} // namespace parametricbem2d
+
+#endif // FASTMULTIPOLEHPP
@@ -8,9 +8,13 @@
 #ifndef GAULEGHPP
 #define GAULEGHPP
 
+#include <atomic>
 #include <cmath>
 #include <exception>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 
 #include "logweight_quadrature.hpp"
 #include <Eigen/Dense>
@@ -75,14 +79,13 @@ gauleg(double a, double b, int n, double eps = 1.e-13) {
 }
 
 /**
- * This function is evaluates a standard Gaussian Quadrature rule for the domain
- * [-1,1] for the given order. The quadrature rule is returned in the form of a
- * QuadRule object
+ * This function computes a standard Gaussian Quadrature rule for the domain
+ * [-1,1] for the given order, see getGaussQR() for the cached version.
  *
  * @param N Order for Gaussian Quadrature
  * @return QuadRule object containing the quadrature rule
  */
-inline QuadRule getGaussQR(unsigned N) {
+inline QuadRule ComputeGaussQR(unsigned N) {
   // Getting standard Gauss Legendre Quadrature weights and nodes
   Eigen::RowVectorXd weights, points;
   std::tie(points, weights) =
@@ -95,4 +98,50 @@ inline QuadRule getGaussQR(unsigned N) {
   return gauss;
 }
 
+/**
+ * This function is evaluates a standard Gaussian Quadrature rule for the domain
+ * [-1,1] for the given order. The quadrature rule is returned in the form of a
+ * QuadRule object. The rules are kept in a process-wide cache: the rule of
+ * each order is computed only once, on its first request, and later requests
+ * return a reference to the stored rule. The cache is safe to use from
+ * multiple threads, and the returned reference stays valid until the end of
+ * the program. The rules of orders below MAX_CACHED_GAUSS_ORDER are published
+ * in a table of atomic pointers, such that looking them up does not take a
+ * lock and the assembly threads do not serialize on it.
+ *
+ * @param N Order for Gaussian Quadrature
+ * @return QuadRule object containing the quadrature rule
+ */
+inline const QuadRule &getGaussQR(unsigned N) {
+  // Orders which are looked up without locking
+  static const unsigned MAX_CACHED_GAUSS_ORDER = 128;
+  if (N < MAX_CACHED_GAUSS_ORDER) {
+    // Pointers to the rules, null until the rule is computed. Objects with
+    // static storage are zero initialized.
+    static std::atomic<const QuadRule *> table[MAX_CACHED_GAUSS_ORDER];
+    const QuadRule *rule = table[N].load(std::memory_order_acquire);
+    if (rule == nullptr) {
+      // Threads computing the same rule concurrently keep the first one
+      // published. The rules are never freed.
+      const QuadRule *computed = new QuadRule(ComputeGaussQR(N));
+      if (table[N].compare_exchange_strong(rule, computed,
+                                           std::memory_order_acq_rel))
+        rule = computed;
+      else
+        delete computed;
+    }
+    return *rule;
+  }
+  // The cached rules of higher orders, indexed by their order. Elements of
+  // std::map are never moved, so references to the stored rules stay valid on
+  // insertion.
+  static std::map<unsigned, QuadRule> rules;
+  static std::mutex rules_mutex;
+  std::lock_guard<std::mutex> lock(rules_mutex);
+  std::map<unsigned, QuadRule>::iterator it = rules.find(N);
+  if (it == rules.end())
+    it = rules.emplace(N, ComputeGaussQR(N)).first;
+  return it->second;
+}
+
 #endif
@@ -0,0 +1,590 @@
+/**
+ * \file hierarchical_matrix.hpp
+ * \brief This file defines a hierarchical matrix (H-matrix) representation of
+ *        Galerkin matrices. The matrix is partitioned into blocks of clusters
+ *        of panels. Blocks for well separated clusters are approximated by
+ *        low rank matrices computed with adaptive cross approximation (ACA),
+ *        the remaining blocks are stored densely. This reduces the storage
+ *        and the cost of a matrix-vector product from \f$O(n^{2})\f$ to
+ *        \f$O(n \log n)\f$ for a fixed accuracy.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef HIERARCHICALMATRIXHPP
+#define HIERARCHICALMATRIXHPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "abstract_bem_space.hpp"
+#include "dof_map.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
+#include "parametrized_mesh.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This structure holds the parameters for the construction of a
+ * HierarchicalMatrix.
+ */
+struct HierarchicalMatrixOptions {
+  /**
+   * A pair of clusters is admissible if the analogue of rho() for clusters,
+   * the larger diameter divided by the distance, is at most eta
+   */
+  double eta = 1.;
+  /**
+   * Relative accuracy of the low rank approximations in the Frobenius norm
+   */
+  double accuracy = 1e-8;
+  /**
+   * Maximum number of panels in a cluster which is not subdivided
+   */
+  unsigned leafsize = 16;
+};
+
+/**
+ * \class HierarchicalMatrix
+ * \brief This class represents a Galerkin matrix as a hierarchical matrix.
+ *        The clusters are sets of panels obtained by recursively bisecting
+ *        their bounding box along its longest side, such that they do not
+ *        depend on the numbering of the panels and panels of different
+ *        boundary components are separated as soon as the components are
+ *        apart. The blocks are computed from the interaction matrices
+ *        of the panels and then mapped to the global coefficients belonging
+ *        to the clusters with the local to global maps of the spaces, as in
+ *        panel oriented assembly (\f$\ref{pc:ass}\f$).
+ */
+class HierarchicalMatrix {
+public:
+  /**
+   * Constructor which builds the block partition and computes the blocks in
+   * parallel, see parallel_assembly::ParallelFor(). The low rank blocks are
+   * computed by ACA with partial pivoting, evaluating only some of the rows
+   * and columns of the interaction matrices.
+   *
+   * @tparam NearKernel Template type for the interaction matrices of
+   *                    arbitrary panel pairs. Should support evaluation of the
+   *                    form near(i,j) which returns the Qtest X Qtrial
+   *                    interaction matrix for the test panel i and the trial
+   *                    panel j (0 based indices)
+   * @tparam FarKernel Template type for the interaction matrices of disjoint
+   *                   panel pairs, as NearKernel
+   * @param mesh ParametrizedMesh object containing all the panels
+   * @param geometry PanelGeometryCache for the mesh, used for the bounding
+   *                 circles of the clusters
+   * @param trial_space The trial space for evaluating the matrix
+   * @param test_space The test space for evaluating the matrix
+   * @param near The interaction matrices for the dense blocks
+   * @param far The interaction matrices for the low rank blocks
+   * @param options The parameters of the approximation
+   */
+  template <typename NearKernel, typename FarKernel>
+  HierarchicalMatrix(const ParametrizedMesh &mesh,
+                     const PanelGeometryCache &geometry,
+                     const AbstractBEMSpace &trial_space,
+                     const AbstractBEMSpace &test_space,
+                     const NearKernel &near, const FarKernel &far,
+                     const HierarchicalMatrixOptions &options =
+                         HierarchicalMatrixOptions());
+
+  /**
+   * This function returns the number of rows of the Galerkin matrix
+   *
+   * @return Dimension of the test space
+   */
+  unsigned int rows() const { return rows_; }
+
+  /**
+   * This function returns the number of columns of the Galerkin matrix
+   *
+   * @return Dimension of the trial space
+   */
+  unsigned int cols() const { return cols_; }
+
+  /**
+   * This function evaluates the matrix-vector product with the Galerkin
+   * matrix
+   *
+   * @param x Vector of coefficients in the trial space
+   * @return The product, a vector of size rows()
+   */
+  Eigen::VectorXd operator*(const Eigen::VectorXd &x) const;
+
+  /**
+   * This function evaluates the approximated Galerkin matrix densely
+   *
+   * @return An Eigen::MatrixXd type Galerkin matrix
+   */
+  Eigen::MatrixXd toDense() const;
+
+  /**
+   * This function returns the number of stored matrix entries, counting the
+   * factors of the low rank blocks
+   *
+   * @return Number of stored entries
+   */
+  unsigned long getNumStoredEntries() const;
+
+  /**
+   * This function returns the number of low rank blocks
+   *
+   * @return Number of low rank blocks
+   */
+  unsigned int getNumLowRankBlocks() const;
+
+  /**
+   * This function returns the largest rank of the low rank blocks
+   *
+   * @return Maximum rank
+   */
+  unsigned int getMaxRank() const;
+
+private:
+  /**
+   * \struct Cluster
+   * \brief A range of the panels in panels_ with a circle containing them and
+   *        the global coefficients of the test and trial spaces belonging to
+   *        them. The positions map the local coefficient (I,i) of the ith
+   *        panel in the cluster to its entry in test_dofs or trial_dofs.
+   */
+  struct Cluster {
+    unsigned int begin, end; // Panels panels_[begin], ..., panels_[end - 1]
+    Eigen::Vector2d center;
+    double radius;
+    std::vector<unsigned int> test_dofs, trial_dofs;
+    Eigen::MatrixXi test_positions, trial_positions;
+  };
+
+  /**
+   * \struct Block
+   * \brief A block of the matrix for a pair of clusters, with the rows and
+   *        columns given by the global coefficients of the clusters. The
+   *        block is either stored densely in U, or as the low rank product
+   *        U * V^T.
+   */
+  struct Block {
+    unsigned int test_cluster, trial_cluster;
+    bool lowrank;
+    Eigen::MatrixXd U, V;
+  };
+
+  /**
+   * This function adds the cluster for the panels panels_[begin], ...,
+   * panels_[end - 1] and its descendants to clusters_. The bounding box of a
+   * cluster which is subdivided is bisected along its longest side, and its
+   * panels are reordered such that its children are the panels with the
+   * centers in either half.
+   *
+   * @param lower Lower left corners of the bounding boxes of all the panels
+   * @param upper Upper right corners of the bounding boxes of all the panels
+   * @return Index of the cluster in clusters_
+   */
+  unsigned int BuildClusterTree(const Eigen::Matrix2Xd &lower,
+                                const Eigen::Matrix2Xd &upper,
+                                unsigned int begin, unsigned int end,
+                                unsigned int leafsize);
+
+  /**
+   * This function sets the global coefficients belonging to a cluster
+   */
+  void SetClusterDofs(Cluster &cluster, const Eigen::MatrixXi &test_dofs,
+                      const Eigen::MatrixXi &trial_dofs);
+
+  /**
+   * This function adds the leaf blocks for the pair of clusters and its
+   * descendants to blocks_, without computing them
+   */
+  void BuildBlockTree(unsigned int test_cluster, unsigned int trial_cluster,
+                      double eta);
+
+  /**
+   * Dimensions of the Galerkin matrix
+   */
+  unsigned int rows_, cols_;
+  /**
+   * Number of local shape functions of the test and trial spaces
+   */
+  unsigned int Qtest_, Qtrial_;
+  /**
+   * Indices of the panels of the mesh, ordered such that every cluster is a
+   * range of them
+   */
+  std::vector<unsigned int> panels_;
+  /**
+   * Clusters, with the children of a cluster c at indices children_[c]
+   */
+  std::vector<Cluster> clusters_;
+  std::vector<std::vector<unsigned int>> children_;
+  /**
+   * Leaf blocks of the block partition
+   */
+  std::vector<Block> blocks_;
+}; // class HierarchicalMatrix
+
+/**
+ * This function computes a low rank approximation U * V^T of a matrix by ACA
+ * with partial pivoting, accessing the matrix only through some of its rows
+ * and columns. If the approximation is not cheaper than the full matrix, the
+ * full matrix is returned in U instead. A zero matrix gives an approximation
+ * of rank 0, with U and V having no columns.
+ *
+ * @tparam GetRow Template type for the rows. Should support evaluation of the
+ *                form row(r) returning the rth row as Eigen::VectorXd
+ * @tparam GetCol Template type for the columns, as GetRow
+ * @param m Number of rows of the matrix
+ * @param n Number of columns of the matrix
+ * @param row The rows of the matrix
+ * @param col The columns of the matrix
+ * @param accuracy Relative accuracy in the Frobenius norm
+ * @param U Left factor, or the full matrix
+ * @param V Right factor, or empty
+ * @return True if U * V^T is the approximation, false if U contains the full
+ *         matrix
+ */
+template <typename GetRow, typename GetCol>
+bool AdaptiveCrossApproximation(unsigned int m, unsigned int n,
+                                const GetRow &row, const GetCol &col,
+                                double accuracy, Eigen::MatrixXd &U,
+                                Eigen::MatrixXd &V) {
+  // The approximation is only worth it for ranks below this
+  unsigned int maxrank = (m * n) / (m + n);
+  std::vector<Eigen::VectorXd> us, vs;
+  std::vector<bool> used_rows(m, false);
+  double norm2 = 0; // Squared Frobenius norm of the approximation
+  unsigned int pivot_row = 0;
+  bool converged = false;
+  while (us.size() < maxrank) {
+    used_rows[pivot_row] = true;
+    // Residual of the pivot row
+    Eigen::VectorXd v = row(pivot_row);
+    for (unsigned int l = 0; l < us.size(); ++l)
+      v -= us[l](pivot_row) * vs[l];
+    unsigned int pivot_col;
+    double pivot = v.cwiseAbs().maxCoeff(&pivot_col);
+    if (pivot > 0) {
+      v /= v(pivot_col);
+      // Residual of the pivot column
+      Eigen::VectorXd u = col(pivot_col);
+      for (unsigned int l = 0; l < us.size(); ++l)
+        u -= vs[l](pivot_col) * us[l];
+      // Updating the norm of the approximation
+      double uv_norm2 = u.squaredNorm() * v.squaredNorm();
+      for (unsigned int l = 0; l < us.size(); ++l)
+        norm2 += 2 * u.dot(us[l]) * v.dot(vs[l]);
+      norm2 += uv_norm2;
+      us.push_back(u);
+      vs.push_back(v);
+      if (uv_norm2 <= accuracy * accuracy * norm2) {
+        converged = true;
+        break;
+      }
+    }
+    // Next pivot row, the largest entry of the last column among the unused
+    // rows
+    double largest = -1;
+    for (unsigned int r = 0; r < m; ++r) {
+      if (used_rows[r])
+        continue;
+      double value = us.empty() || pivot == 0 ? 0 : std::fabs(us.back()(r));
+      if (value > largest) {
+        largest = value;
+        pivot_row = r;
+      }
+    }
+    if (largest < 0) { // All the rows have been used, the matrix is exact
+      converged = true;
+      break;
+    }
+  }
+  if (!converged) { // Storing the full matrix
+    U.resize(m, n);
+    for (unsigned int r = 0; r < m; ++r)
+      U.row(r) = row(r).transpose();
+    V.resize(0, 0);
+    return false;
+  }
+  U.resize(m, us.size());
+  V.resize(n, vs.size());
+  for (unsigned int l = 0; l < us.size(); ++l) {
+    U.col(l) = us[l];
+    V.col(l) = vs[l];
+  }
+  return true;
+}
+
+template <typename NearKernel, typename FarKernel>
+HierarchicalMatrix::HierarchicalMatrix(
+    const ParametrizedMesh &mesh, const PanelGeometryCache &geometry,
+    const AbstractBEMSpace &trial_space, const AbstractBEMSpace &test_space,
+    const NearKernel &near, const FarKernel &far,
+    const HierarchicalMatrixOptions &options) {
+  unsigned int numpanels = mesh.getNumPanels();
+  rows_ = test_space.getSpaceDim(numpanels);
+  cols_ = trial_space.getSpaceDim(numpanels);
+  Qtest_ = test_space.getQ();
+  Qtrial_ = trial_space.getQ();
+  // Tabulating the local to global maps, the entry (I,i) belongs to the Ith
+  // local shape function on the ith panel
+  DofMap test_dofs(test_space, mesh);
+  DofMap trial_dofs(trial_space, mesh);
+  // Building the block partition
+  // Bounding boxes of the tabulated points and the endpoints of the panels
+  Eigen::Matrix2Xd lower(2, numpanels), upper(2, numpanels);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    const AbstractParametrizedCurve &panel = geometry.getPanel(i);
+    Eigen::Matrix2Xd points(2, geometry.getNumNodes() + 2);
+    points << geometry.getPoints(i), panel(-1), panel(1);
+    lower.col(i) = points.rowwise().minCoeff();
+    upper.col(i) = points.rowwise().maxCoeff();
+  }
+  for (unsigned int i = 0; i < numpanels; ++i)
+    panels_.push_back(i);
+  BuildClusterTree(lower, upper, 0, numpanels, std::max(1u, options.leafsize));
+  for (Cluster &cluster : clusters_)
+    SetClusterDofs(cluster, test_dofs.getTable(), trial_dofs.getTable());
+  BuildBlockTree(0, 0, options.eta);
+  // Computing the blocks in parallel
+  parallel_assembly::ParallelFor(0, blocks_.size(), [&](unsigned int b) {
+    Block &block = blocks_[b];
+    const Cluster &tau = clusters_[block.test_cluster];
+    const Cluster &sigma = clusters_[block.trial_cluster];
+    unsigned int m = (tau.end - tau.begin) * Qtest_;
+    unsigned int n = (sigma.end - sigma.begin) * Qtrial_;
+    // Sums the rows of a matrix for the local coefficients of the panels in
+    // a cluster which belong to the same global coefficient
+    auto gather = [](const Eigen::MatrixXd &local, unsigned int numdofs,
+                     const Eigen::MatrixXi &positions) {
+      Eigen::MatrixXd global = Eigen::MatrixXd::Zero(numdofs, local.cols());
+      for (unsigned int i = 0; i < positions.cols(); ++i)
+        for (unsigned int I = 0; I < positions.rows(); ++I)
+          global.row(positions(I, i)) += local.row(i * positions.rows() + I);
+      return global;
+    };
+    Eigen::MatrixXd local;
+    if (block.lowrank) {
+      // Rows and columns of the block for the local coefficients, which are
+      // ordered panel by panel. The interaction matrices of a panel with all
+      // the panels of the other cluster are computed once, when ACA requests
+      // the first row or column of the panel, and give all its Q rows or
+      // columns.
+      std::vector<Eigen::MatrixXd> panel_rows(tau.end - tau.begin);
+      std::vector<Eigen::MatrixXd> panel_cols(sigma.end - sigma.begin);
+      auto row = [&](unsigned int r) {
+        Eigen::MatrixXd &rows = panel_rows[r / Qtest_];
+        if (rows.size() == 0) {
+          unsigned int i = panels_[tau.begin + r / Qtest_];
+          rows.resize(Qtest_, n);
+          for (unsigned int j = sigma.begin; j < sigma.end; ++j)
+            rows.middleCols((j - sigma.begin) * Qtrial_, Qtrial_) =
+                far(i, panels_[j]);
+        }
+        return Eigen::VectorXd(rows.row(r % Qtest_).transpose());
+      };
+      auto col = [&](unsigned int c) {
+        Eigen::MatrixXd &cols = panel_cols[c / Qtrial_];
+        if (cols.size() == 0) {
+          unsigned int j = panels_[sigma.begin + c / Qtrial_];
+          cols.resize(m, Qtrial_);
+          for (unsigned int i = tau.begin; i < tau.end; ++i)
+            cols.middleRows((i - tau.begin) * Qtest_, Qtest_) =
+                far(panels_[i], j);
+        }
+        return Eigen::VectorXd(cols.col(c % Qtrial_));
+      };
+      Eigen::MatrixXd U, V;
+      if (AdaptiveCrossApproximation(m, n, row, col, options.accuracy, U,
+                                     V)) {
+        // Low rank block, possibly of rank 0 for a zero block
+        block.U = gather(U, tau.test_dofs.size(), tau.test_positions);
+        block.V = gather(V, sigma.trial_dofs.size(), sigma.trial_positions);
+        return;
+      }
+      // Not compressible, U contains the full block
+      block.lowrank = false;
+      local = U;
+    } else {
+      // Dense block from the interaction matrices of all the panel pairs
+      local.resize(m, n);
+      for (unsigned int i = tau.begin; i < tau.end; ++i)
+        for (unsigned int j = sigma.begin; j < sigma.end; ++j)
+          local.block((i - tau.begin) * Qtest_, (j - sigma.begin) * Qtrial_,
+                      Qtest_, Qtrial_) = near(panels_[i], panels_[j]);
+    }
+    Eigen::MatrixXd rows_gathered =
+        gather(local, tau.test_dofs.size(), tau.test_positions);
+    block.U = gather(rows_gathered.transpose(), sigma.trial_dofs.size(),
+                     sigma.trial_positions)
+                  .transpose();
+  });
+}
+
+inline unsigned int
+HierarchicalMatrix::BuildClusterTree(const Eigen::Matrix2Xd &lower,
+                                     const Eigen::Matrix2Xd &upper,
+                                     unsigned int begin, unsigned int end,
+                                     unsigned int leafsize) {
+  // Bounding box of the panels in the cluster
+  Eigen::Vector2d box_lower = lower.col(panels_[begin]);
+  Eigen::Vector2d box_upper = upper.col(panels_[begin]);
+  for (unsigned int i = begin; i < end; ++i) {
+    box_lower = box_lower.cwiseMin(lower.col(panels_[i]));
+    box_upper = box_upper.cwiseMax(upper.col(panels_[i]));
+  }
+  Cluster cluster;
+  cluster.begin = begin;
+  cluster.end = end;
+  cluster.center = 0.5 * (box_lower + box_upper);
+  cluster.radius = 0.5 * (box_upper - box_lower).norm();
+  unsigned int index = clusters_.size();
+  clusters_.push_back(cluster);
+  children_.push_back(std::vector<unsigned int>());
+  // Bisection of the bounding box along its longest side, the panels are
+  // assigned to the halves by the centers of their bounding boxes
+  if (end - begin > leafsize) {
+    unsigned int axis;
+    (box_upper - box_lower).maxCoeff(&axis);
+    // Twice the coordinates of the centers along the axis
+    auto center = [&](unsigned int i) {
+      return lower(axis, i) + upper(axis, i);
+    };
+    double split = box_lower(axis) + box_upper(axis);
+    unsigned int middle =
+        std::partition(panels_.begin() + begin, panels_.begin() + end,
+                       [&](unsigned int i) { return center(i) < split; }) -
+        panels_.begin();
+    if (middle == begin || middle == end) {
+      // All the centers in one half, splitting at their median instead
+      middle = begin + (end - begin) / 2;
+      std::nth_element(panels_.begin() + begin, panels_.begin() + middle,
+                       panels_.begin() + end,
+                       [&](unsigned int i, unsigned int j) {
+                         return center(i) < center(j);
+                       });
+    }
+    unsigned int first =
+        BuildClusterTree(lower, upper, begin, middle, leafsize);
+    unsigned int second =
+        BuildClusterTree(lower, upper, middle, end, leafsize);
+    children_[index].push_back(first);
+    children_[index].push_back(second);
+  }
+  return index;
+}
+
+inline void
+HierarchicalMatrix::SetClusterDofs(Cluster &cluster,
+                                   const Eigen::MatrixXi &test_dofs,
+                                   const Eigen::MatrixXi &trial_dofs) {
+  // Collects the distinct global coefficients in ascending order, in
+  // O(s log s) operations for s local coefficients
+  auto collect = [&](const Eigen::MatrixXi &dofs,
+                     std::vector<unsigned int> &list,
+                     Eigen::MatrixXi &positions) {
+    for (unsigned int i = cluster.begin; i < cluster.end; ++i)
+      for (unsigned int I = 0; I < dofs.rows(); ++I)
+        list.push_back(dofs(I, panels_[i]));
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    positions.resize(dofs.rows(), cluster.end - cluster.begin);
+    for (unsigned int i = cluster.begin; i < cluster.end; ++i)
+      for (unsigned int I = 0; I < dofs.rows(); ++I)
+        positions(I, i - cluster.begin) =
+            std::lower_bound(list.begin(), list.end(), dofs(I, panels_[i])) -
+            list.begin();
+  };
+  collect(test_dofs, cluster.test_dofs, cluster.test_positions);
+  collect(trial_dofs, cluster.trial_dofs, cluster.trial_positions);
+}
+
+inline void HierarchicalMatrix::BuildBlockTree(unsigned int test_cluster,
+                                               unsigned int trial_cluster,
+                                               double eta) {
+  const Cluster &tau = clusters_[test_cluster];
+  const Cluster &sigma = clusters_[trial_cluster];
+  // Admissibility as in rho(), with the diameters and distance of the circles
+  double dist = (tau.center - sigma.center).norm() - tau.radius - sigma.radius;
+  bool admissible =
+      dist > 0 && 2 * std::max(tau.radius, sigma.radius) <= eta * dist;
+  if (admissible || children_[test_cluster].empty() ||
+      children_[trial_cluster].empty()) {
+    Block block;
+    block.test_cluster = test_cluster;
+    block.trial_cluster = trial_cluster;
+    block.lowrank = admissible;
+    blocks_.push_back(block);
+    return;
+  }
+  for (unsigned int child_tau : children_[test_cluster])
+    for (unsigned int child_sigma : children_[trial_cluster])
+      BuildBlockTree(child_tau, child_sigma, eta);
+}
+
+inline Eigen::VectorXd HierarchicalMatrix::
+operator*(const Eigen::VectorXd &x) const {
+  assert(x.size() == cols_);
+  Eigen::VectorXd y = Eigen::VectorXd::Zero(rows_);
+  for (const Block &block : blocks_) {
+    const Cluster &tau = clusters_[block.test_cluster];
+    const Cluster &sigma = clusters_[block.trial_cluster];
+    // Gathering the coefficients of the trial cluster
+    Eigen::VectorXd x_block(sigma.trial_dofs.size());
+    for (unsigned int c = 0; c < sigma.trial_dofs.size(); ++c)
+      x_block(c) = x(sigma.trial_dofs[c]);
+    Eigen::VectorXd y_block = block.lowrank
+                                  ? Eigen::VectorXd(block.U *
+                                                    (block.V.transpose() *
+                                                     x_block))
+                                  : Eigen::VectorXd(block.U * x_block);
+    // Adding the product to the coefficients of the test cluster
+    for (unsigned int r = 0; r < tau.test_dofs.size(); ++r)
+      y(tau.test_dofs[r]) += y_block(r);
+  }
+  return y;
+}
+
+inline Eigen::MatrixXd HierarchicalMatrix::toDense() const {
+  Eigen::MatrixXd output = Eigen::MatrixXd::Zero(rows_, cols_);
+  for (const Block &block : blocks_) {
+    const Cluster &tau = clusters_[block.test_cluster];
+    const Cluster &sigma = clusters_[block.trial_cluster];
+    Eigen::MatrixXd entries =
+        block.lowrank ? Eigen::MatrixXd(block.U * block.V.transpose())
+                      : block.U;
+    // Adding the block entries to the coefficients of the clusters
+    for (unsigned int r = 0; r < tau.test_dofs.size(); ++r)
+      for (unsigned int c = 0; c < sigma.trial_dofs.size(); ++c)
+        output(tau.test_dofs[r], sigma.trial_dofs[c]) += entries(r, c);
+  }
+  return output;
+}
+
+inline unsigned long HierarchicalMatrix::getNumStoredEntries() const {
+  unsigned long entries = 0;
+  for (const Block &block : blocks_)
+    entries += block.U.size() + block.V.size();
+  return entries;
+}
+
+inline unsigned int HierarchicalMatrix::getNumLowRankBlocks() const {
+  unsigned int count = 0;
+  for (const Block &block : blocks_)
+    count += block.lowrank;
+  return count;
+}
+
+inline unsigned int HierarchicalMatrix::getMaxRank() const {
+  unsigned int maxrank = 0;
+  for (const Block &block : blocks_)
+    if (block.lowrank)
+      maxrank = std::max(maxrank, (unsigned int)block.U.cols());
+  return maxrank;
+}
+
+} // namespace parametricbem2d
+
+#endif // HIERARCHICALMATRIXHPP
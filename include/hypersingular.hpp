@@ -12,9 +12,13 @@
 #ifndef HYPERSINGULARHPP
 #define HYPERSINGULARHPP
 
+#include <utility>
+
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
 #include "logweight_quadrature.hpp"
+#include "packed_symmetric_matrix.hpp"
+#include "panel_geometry_cache.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -102,6 +106,9 @@ Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
  *
  * ComputeIntegralCoinciding()
  *
+ * For disjoint panels, a lower quadrature order than the one of GaussQR is
+ * used if enabled through adaptive_quadrature::setAccuracy().
+ *
  * @param pi Parametrization for the first panel \f$\Pi\f$.
  * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
  * @param space The BEM space to be used for calculations
@@ -115,13 +122,104 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
                                   const AbstractBEMSpace &space,
                                   const QuadRule &GaussQR);
 
+/**
+ * This function is used to evaluate the Interaction Matrix for the pair of
+ * panels with indices i and j in a mesh, for the bilinear form induced by the
+ * Hypersingular BIO, in the case where the panels are completely disjoint. It
+ * computes the same quadrature as the version above but reads the points,
+ * derivative norms and normals at the quadrature nodes from a
+ * PanelGeometryCache instead of evaluating the parametrizations.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param space The BEM space to be used for calculations
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Interaction Matrix (QXQ)
+ *         where Q is number of local shape functions in BEM space
+ */
+Eigen::MatrixXd ComputeIntegralGeneral(const PanelGeometryCache &geometry,
+                                       unsigned int i, unsigned int j,
+                                       const AbstractBEMSpace &space,
+                                       const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrix as the version above,
+ * writing it into a matrix provided by the caller. It uses the shape
+ * function derivatives tabulated in a TabulatedBEMSpace and does not allocate
+ * memory if interaction_matrix already has the size Q X Q, such that the
+ * assembly can reuse the matrices for all the panel pairs.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param space The BEM space tabulated at the nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrix The Eigen::MatrixXd which is overwritten with the
+ *                           Interaction Matrix (QXQ)
+ */
+void ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                            unsigned int j, const TabulatedBEMSpace &space,
+                            const QuadRule &GaussQR,
+                            Eigen::MatrixXd &interaction_matrix);
+
+/**
+ * This function is used to evaluate the Interaction Matrix for the pair of
+ * panels with indices i and j in a mesh, for the bilinear form induced by the
+ * Hypersingular BIO. The computation is delegated based on cases like
+ * the version above, using the PanelGeometryCache for disjoint panels.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param space The BEM space to be used for calculations
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Interaction Matrix (QXQ)
+ *         where Q is number of local shape functions in BEM space
+ */
+Eigen::MatrixXd InteractionMatrix(const PanelGeometryCache &geometry,
+                                  unsigned int i, unsigned int j,
+                                  const AbstractBEMSpace &space,
+                                  const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrix as the version above,
+ * writing it into a matrix provided by the caller. For disjoint panels, no
+ * memory is allocated, see the corresponding version of
+ * ComputeIntegralGeneral(), also for the lower orders of the adaptive
+ * quadrature once they are tabulated. Coinciding and adjacent panels, O(n)
+ * of the pairs for n panels, are computed by ComputeIntegralCoinciding()
+ * and ComputeIntegralAdjacent(), which allocate their temporaries. This is
+ * the version used for assembly.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param space The BEM space tabulated at the nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrix The Eigen::MatrixXd which is overwritten with the
+ *                           Interaction Matrix (QXQ)
+ */
+void InteractionMatrix(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const TabulatedBEMSpace &space,
+                       const QuadRule &GaussQR,
+                       Eigen::MatrixXd &interaction_matrix);
+
 /**
  * This function is used to evaluate the full Galerkin matrix based on the
  * Bilinear form for Hypersingular BIO. It uses the trial and test spaces and
  * Parametrized mesh specified as inputs. It evaluates the matrix by panel
  * oriented assembly (\f$\ref{pc:ass}\f$) by first evaluating the interaction
  * matrix for all possible pairs of panels and then using the local to global
- * map of BEM spaces to fill the matrix entries.
+ * map of BEM spaces to fill the matrix entries. The interaction matrices are
+ * computed on parallel threads, see parallel_assembly::getNumThreads(). As
+ * the Galerkin matrix is symmetric, only the pairs of panels (i,j) with
+ * i <= j are evaluated and the upper triangle is mirrored, see
+ * parallel_assembly::AssembleSymmetricGalerkinMatrix().
  *
  * @param mesh ParametrizedMesh object containing all the parametrized
  *             panels in the mesh
@@ -134,6 +232,256 @@ Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &space,
                                const unsigned int &N);
 
+/**
+ * This function evaluates the same Galerkin matrix as GalerkinMatrix() for
+ * the Hypersingular BIO, using an already tabulated geometry of the mesh. This
+ * allows several Galerkin matrices to be assembled from a single pass over
+ * the geometry of the panels.
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param geometry PanelGeometryCache for the mesh, tabulated at the nodes of
+ *                 GaussQR
+ * @param space The trial and test BEM space to be used for evaluating
+ *              the Galerkin matrix
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return An Eigen::MatrixXd type Galerkin Matrix for the given mesh and space
+ */
+Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh &mesh,
+                               const PanelGeometryCache &geometry,
+                               const AbstractBEMSpace &space,
+                               const QuadRule &GaussQR);
+
+/**
+ * This function evaluates the same Galerkin matrix as GalerkinMatrix() for
+ * the Hypersingular BIO, but stores only its upper triangle in packed form.
+ * This halves the memory needed for the matrix.
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param space The trial and test BEM space to be used for evaluating
+ *              the Galerkin matrix
+ * @param N Order for Gauss Quadrature
+ * @return The Galerkin Matrix for the given mesh and space in packed storage
+ */
+PackedSymmetricMatrix GalerkinMatrixPacked(const ParametrizedMesh &mesh,
+                                           const AbstractBEMSpace &space,
+                                           const unsigned int &N);
+
+/**
+ * This function is used to evaluate the Interaction Matrices for the pair
+ * of panels \f$\Pi\f$ and \f$\Pi\f$', for the bilinear forms induced by
+ * the Single Layer BIO and the Hypersingular BIO together. By the integration
+ * by parts formula for the Hypersingular BIO, both interaction matrices are
+ * integrals of the same logarithmic kernel, with the values of the reference
+ * shape functions for the Single Layer BIO and their derivatives for the
+ * Hypersingular BIO. Both are computed in a single quadrature sweep which
+ * evaluates the kernel only once. It implements the case where the panels are
+ * coinciding.
+ *
+ * @param pi Parametrization for the first panel \f$\Pi\f$.
+ * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
+ * @param sl_space The BEM space for the Single Layer BIO
+ * @param hs_space The BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Interaction Matrices, the first one
+ *         for the Single Layer BIO and the second one for the Hypersingular
+ *         BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
+                          const AbstractParametrizedCurve &pi_p,
+                          const AbstractBEMSpace &sl_space,
+                          const AbstractBEMSpace &hs_space,
+                          const QuadRule &GaussQR);
+
+/**
+ * This function is used to evaluate the Interaction Matrices for the pair
+ * of panels \f$\Pi\f$ and \f$\Pi\f$' for the Single Layer BIO and the
+ * Hypersingular BIO together, see ComputeIntegralCoinciding(). It implements
+ * the case where the panels are adjacent.
+ *
+ * @param pi Parametrization for the first panel \f$\Pi\f$.
+ * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
+ * @param sl_space The BEM space for the Single Layer BIO
+ * @param hs_space The BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Interaction Matrices, the first one
+ *         for the Single Layer BIO and the second one for the Hypersingular
+ *         BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
+                        const AbstractParametrizedCurve &pi_p,
+                        const AbstractBEMSpace &sl_space,
+                        const AbstractBEMSpace &hs_space,
+                        const QuadRule &GaussQR);
+
+/**
+ * This function is used to evaluate the Interaction Matrices for the pair
+ * of panels \f$\Pi\f$ and \f$\Pi\f$' for the Single Layer BIO and the
+ * Hypersingular BIO together, see ComputeIntegralCoinciding(). It implements
+ * the case where the panels are disjoint.
+ *
+ * @param pi Parametrization for the first panel \f$\Pi\f$.
+ * @param pi_p Parametrization for the second panel \f$\Pi\f$'.
+ * @param sl_space The BEM space for the Single Layer BIO
+ * @param hs_space The BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Interaction Matrices, the first one
+ *         for the Single Layer BIO and the second one for the Hypersingular
+ *         BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
+                       const AbstractParametrizedCurve &pi_p,
+                       const AbstractBEMSpace &sl_space,
+                       const AbstractBEMSpace &hs_space,
+                       const QuadRule &GaussQR);
+
+/**
+ * This function evaluates the same Interaction Matrices as the function above
+ * for disjoint panels, reading the points and the norms of the derivatives
+ * from a PanelGeometryCache.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param sl_space The BEM space for the Single Layer BIO
+ * @param hs_space The BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Interaction Matrices, the first one
+ *         for the Single Layer BIO and the second one for the Hypersingular
+ *         BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const AbstractBEMSpace &sl_space,
+                       const AbstractBEMSpace &hs_space,
+                       const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrices as the version above,
+ * writing them into matrices provided by the caller. No memory is
+ * allocated if the matrices already have the right sizes.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param sl_space The BEM space for the Single Layer BIO, tabulated at the
+ *                 nodes of GaussQR
+ * @param hs_space The BEM space for the Hypersingular BIO, tabulated at the
+ *                 nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrices The pair of matrices which is overwritten with
+ *                             the Interaction Matrices for the Single Layer
+ *                             BIO and the Hypersingular BIO
+ */
+void ComputeIntegralGeneral(
+    const PanelGeometryCache &geometry, unsigned int i, unsigned int j,
+    const TabulatedBEMSpace &sl_space, const TabulatedBEMSpace &hs_space,
+    const QuadRule &GaussQR,
+    std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &interaction_matrices);
+
+/**
+ * This function is used to evaluate the Interaction Matrices for the pair of
+ * panels i and j of a PanelGeometryCache for the Single Layer BIO and the
+ * Hypersingular BIO together, see ComputeIntegralCoinciding(). It calls the
+ * function for the coinciding, adjacent or disjoint case accordingly.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param sl_space The BEM space for the Single Layer BIO
+ * @param hs_space The BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Interaction Matrices, the first one
+ *         for the Single Layer BIO and the second one for the Hypersingular
+ *         BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+InteractionMatrices(const PanelGeometryCache &geometry, unsigned int i,
+                    unsigned int j, const AbstractBEMSpace &sl_space,
+                    const AbstractBEMSpace &hs_space, const QuadRule &GaussQR);
+
+/**
+ * This function computes the same Interaction Matrices as the version above,
+ * writing them into matrices provided by the caller. For disjoint panels,
+ * no memory is allocated, see the corresponding version of
+ * ComputeIntegralGeneral(), also for the lower orders of the adaptive
+ * quadrature once they are tabulated. Coinciding and adjacent panels, O(n)
+ * of the pairs for n panels, are computed by ComputeIntegralCoinciding()
+ * and ComputeIntegralAdjacent(), which allocate their temporaries. This is
+ * the version used for assembly.
+ *
+ * @param geometry PanelGeometryCache tabulated at the nodes of GaussQR
+ * @param i Index of the first panel \f$\Pi\f$ (>=0).
+ * @param j Index of the second panel \f$\Pi\f$' (>=0).
+ * @param sl_space The BEM space for the Single Layer BIO, tabulated at the
+ *                 nodes of GaussQR
+ * @param hs_space The BEM space for the Hypersingular BIO, tabulated at the
+ *                 nodes of GaussQR
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @param interaction_matrices The pair of matrices which is overwritten with
+ *                             the Interaction Matrices for the Single Layer
+ *                             BIO and the Hypersingular BIO
+ */
+void InteractionMatrices(
+    const PanelGeometryCache &geometry, unsigned int i, unsigned int j,
+    const TabulatedBEMSpace &sl_space, const TabulatedBEMSpace &hs_space,
+    const QuadRule &GaussQR,
+    std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &interaction_matrices);
+
+/**
+ * This function evaluates the Galerkin matrices for the Single Layer BIO and
+ * the Hypersingular BIO together by panel oriented assembly
+ * (\f$\ref{pc:ass}\f$), sharing the kernel evaluations between them, see
+ * InteractionMatrices(). The results are identical to the ones of
+ * single_layer::GalerkinMatrix() and GalerkinMatrix(), at roughly the cost
+ * of one of them.
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param geometry PanelGeometryCache for the mesh, tabulated at the nodes of
+ *                 GaussQR
+ * @param sl_space The trial and test BEM space for the Single Layer BIO
+ * @param hs_space The trial and test BEM space for the Hypersingular BIO
+ * @param GaussQR QuadRule object containing the Gaussian Quadrature to be
+ * applied.
+ * @return A pair of Eigen::MatrixXd type Galerkin Matrices, the first one for
+ *         the Single Layer BIO and the second one for the Hypersingular BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+GalerkinMatrices(const ParametrizedMesh &mesh,
+                 const PanelGeometryCache &geometry,
+                 const AbstractBEMSpace &sl_space,
+                 const AbstractBEMSpace &hs_space, const QuadRule &GaussQR);
+
+/**
+ * This function evaluates the Galerkin matrices for the Single Layer BIO and
+ * the Hypersingular BIO together, as the function above.
+ *
+ * @param mesh ParametrizedMesh object containing all the parametrized
+ *             panels in the mesh
+ * @param sl_space The trial and test BEM space for the Single Layer BIO
+ * @param hs_space The trial and test BEM space for the Hypersingular BIO
+ * @param N Order for Gauss Quadrature
+ * @return A pair of Eigen::MatrixXd type Galerkin Matrices, the first one for
+ *         the Single Layer BIO and the second one for the Hypersingular BIO
+ */
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+GalerkinMatrices(const ParametrizedMesh &mesh,
+                 const AbstractBEMSpace &sl_space,
+                 const AbstractBEMSpace &hs_space, const unsigned int &N);
+
 } // namespace hypersingular
 } // namespace parametricbem2d
 
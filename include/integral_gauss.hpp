@@ -13,31 +13,6 @@
 #include "logweight_quadrature.hpp"
 
 namespace parametricbem2d {
-/* This function computes an integral numerically using Gauss Legendre
- * Quadrature Rule of the given order
- *
- * @tparam T Template type for integrand. Should support evaluation.
- * @param integrand The integrand to be integrated
- * @param a Lower end of the integration domain
- * @param b Upper end of the integration domain
- * @param N Order for the quadrature rule
- * @return Integral value
- */
-template <typename T>
-double ComputeIntegral(T integrand, double a, double b, unsigned int N) {
-  if (b < a) {
-    throw std::domain_error("Domain end points not ordered!");
-  }
-  // Getting quadrature weights and points
-  Eigen::RowVectorXd weights, points;
-  std::tie(points, weights) =
-      gauleg(a, b, N, std::numeric_limits<double>::epsilon());
-  double integral = 0.;
-  for (unsigned int i = 0; i < N; ++i)
-    integral += weights(i) * integrand(points(i));
-  return integral;
-}
-
 /* This function computes an integral numerically using Gauss Legendre
  * Quadrature Quadrature Rule of the given order
  *
@@ -66,6 +41,23 @@ double ComputeIntegral(T integrand, double a, double b,
   return integral * diff;
 }
 
+/* This function computes an integral numerically using Gauss Legendre
+ * Quadrature Rule of the given order. The rule is taken from the cache of
+ * getGaussQR().
+ *
+ * @tparam T Template type for integrand. Should support evaluation.
+ * @param integrand The integrand to be integrated
+ * @param a Lower end of the integration domain
+ * @param b Upper end of the integration domain
+ * @param N Order for the quadrature rule
+ * @return Integral value
+ */
+template <typename T>
+double ComputeIntegral(T integrand, double a, double b, unsigned int N) {
+  // Getting the quadrature rule on [-1,1] without recomputing it
+  return ComputeIntegral(integrand, a, b, getGaussQR(N));
+}
+
 /* This function computes a log weighted integral numerically using a Log
  * weighted Quadrature Rule of the given order, derived from Gauss Laguerre rule
  *
@@ -97,14 +89,13 @@ double ComputeLogIntegral(T integrand, double a, unsigned int N) {
  * @return Integral value
  */
 template <typename T> double ComputeLoogIntegral(T integrand, unsigned int N) {
-  // Getting the log weighted quadrature rule
-  std::vector<double> wts, pts;
-  std::tie(pts, wts) = getLogWeightQR(N);
+  // Getting the log weighted quadrature rule, without copying it
+  LogWeightQRView logweightQR = getLogWeightQRView(N);
   double integral = 0.;
   // Computing the integral
   for (unsigned int i = 0; i < N; ++i) {
-    double x = pts[i];
-    integral += wts[i] * integrand(x);
+    double x = logweightQR.x[i];
+    integral += logweightQR.w[i] * integrand(x);
   }
   return integral;
 }
@@ -138,6 +129,63 @@ double ComputeLoogIntegral(T integrand, double a, const QuadRule &QR) {
   return a * integral_l + a * log(a) * integral_g;
 }
 
+/* This function applies a Gauss Legendre Quadrature Rule on the domain [a,b]
+ * by passing every transformed node together with its transformed weight to
+ * the function accumulate. It is used for vector or matrix valued integrands,
+ * where all the components are accumulated by the caller from a single
+ * evaluation at each node.
+ *
+ * @tparam T Template type for the accumulation. Should support evaluation of
+ *           the form accumulate(x,w) for a node x and its weight w
+ * @param accumulate The function accumulating the weighted integrand values
+ * @param a Lower end of the integration domain
+ * @param b Upper end of the integration domain
+ * @param GaussQR Gaussian Quadrature in form of a QuadRule object
+ */
+template <typename T>
+void AccumulateIntegral(const T &accumulate, double a, double b,
+                        const QuadRule &GaussQR) {
+  if (b < a) {
+    throw std::domain_error("Domain end points not ordered!");
+  }
+  unsigned N = GaussQR.n;
+  double mean = 0.5 * (b + a);
+  double diff = 0.5 * (b - a);
+  for (unsigned int i = 0; i < N; ++i)
+    accumulate(GaussQR.x(i) * diff + mean, GaussQR.w(i) * diff);
+}
+
+/* This function applies the log weighted quadrature used in
+ * ComputeLoogIntegral() on the domain [0,a] by passing every node together
+ * with its weight to the function accumulate. The weights already contain the
+ * log weight, such that \f$\sum_{k} w_{k} f(x_{k}) \approx \int_{0}^{a}
+ * \log(x) f(x) dx\f$.
+ *
+ * @tparam T Template type for the accumulation. Should support evaluation of
+ *           the form accumulate(x,w) for a node x and its weight w
+ * @param accumulate The function accumulating the weighted integrand values
+ * @param a Upper end of the integration domain
+ * @param QR Gaussian Quadrature in form of a QuadRule object
+ */
+template <typename T>
+void AccumulateLoogIntegral(const T &accumulate, double a, const QuadRule &QR) {
+  if (a < 0) {
+    throw std::invalid_argument("Integration domain should be non-negative!");
+  }
+  unsigned N = QR.n;
+  // Getting the log weighted quadrature rule for the domain [0,1], without
+  // copying it
+  LogWeightQRView logweightQR = getLogWeightQRView(N);
+  // Log weighted part, transformed from [0,1] to [0,a]
+  for (unsigned int i = 0; i < N; ++i)
+    accumulate(a * logweightQR.x[i], a * logweightQR.w[i]);
+  // Non-weighted part coming from the transformation, \f$a\log(a)\int_{0}^{1}
+  // f(ax) dx\f$
+  double factor = a * log(a);
+  AccumulateIntegral(
+      [&](double x, double w) { accumulate(a * x, factor * w); }, 0, 1, QR);
+}
+
 /* This function computes a Gauss Lguerre integral using the respective
  * Quadrature Rule.
  *
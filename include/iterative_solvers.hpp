@@ -0,0 +1,215 @@
+/**
+ * \file iterative_solvers.hpp
+ * \brief This file defines Krylov subspace solvers for the linear systems
+ *        arising from the BEM discretizations. The solvers only access the
+ *        system matrix through matrix-vector products, such that the cost of
+ *        a solve is governed by the number of iterations instead of the cubic
+ *        cost of a factorization. The products can be evaluated with a
+ *        compressed operator, e.g. a HierarchicalMatrix.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef ITERATIVESOLVERSHPP
+#define ITERATIVESOLVERSHPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This namespace contains the iterative solvers and the types for their
+ * parameters and results.
+ */
+namespace iterative_solvers {
+/**
+ * This structure holds the parameters of the iterative solvers.
+ */
+struct SolverOptions {
+  /**
+   * The iteration stops when the residual norm relative to the norm of the
+   * right hand side is below this tolerance
+   */
+  double tolerance = 1e-10;
+  /**
+   * Maximum number of iterations, each with one matrix-vector product. The
+   * products for the residuals at the restarts of GMRES are not counted.
+   */
+  unsigned max_iterations = 1000;
+  /**
+   * Dimension of the Krylov subspace after which GMRES is restarted
+   */
+  unsigned restart = 100;
+};
+
+/**
+ * This structure holds the result of an iterative solver.
+ */
+struct SolverResult {
+  /**
+   * The computed solution
+   */
+  Eigen::VectorXd solution;
+  /**
+   * Number of iterations performed
+   */
+  unsigned iterations = 0;
+  /**
+   * Whether the tolerance was reached within the maximum number of iterations
+   */
+  bool converged = false;
+  /**
+   * Relative residual norms, starting with the one of the initial guess zero
+   * and followed by one entry per iteration
+   */
+  std::vector<double> residuals;
+};
+
+/**
+ * This function solves the linear system Ax = b for a symmetric positive
+ * definite matrix A with the conjugate gradient method, starting from x = 0.
+ *
+ * @tparam MatVec Template type for the matrix-vector product. Should support
+ *                evaluation of the form A(x) for an Eigen::VectorXd x,
+ *                returning Ax as an Eigen::VectorXd
+ * @param A The matrix-vector product with the system matrix
+ * @param b The right hand side
+ * @param options The tolerance and maximum number of iterations
+ * @return A SolverResult object containing the solution and the convergence
+ *         history
+ */
+template <typename MatVec>
+SolverResult CG(const MatVec &A, const Eigen::VectorXd &b,
+                const SolverOptions &options = SolverOptions()) {
+  SolverResult result;
+  result.solution = Eigen::VectorXd::Zero(b.size());
+  double b_norm = b.norm();
+  if (b_norm == 0) { // Trivial solution
+    result.converged = true;
+    result.residuals.push_back(0);
+    return result;
+  }
+  // Residual and search direction
+  Eigen::VectorXd r = b;
+  Eigen::VectorXd p = r;
+  double rr = r.squaredNorm();
+  result.residuals.push_back(1);
+  while (result.iterations < options.max_iterations) {
+    if (std::sqrt(rr) <= options.tolerance * b_norm)
+      break;
+    Eigen::VectorXd Ap = A(p);
+    double alpha = rr / p.dot(Ap);
+    result.solution += alpha * p;
+    r -= alpha * Ap;
+    double rr_new = r.squaredNorm();
+    p = r + rr_new / rr * p;
+    rr = rr_new;
+    ++result.iterations;
+    result.residuals.push_back(std::sqrt(rr) / b_norm);
+  }
+  result.converged = std::sqrt(rr) <= options.tolerance * b_norm;
+  return result;
+}
+
+/**
+ * This function solves the linear system Ax = b for a general square matrix A
+ * with the restarted GMRES method, starting from x = 0. The Krylov basis is
+ * orthogonalized by the modified Gram-Schmidt process and the least squares
+ * problems are solved by Givens rotations. If the least squares problem
+ * becomes singular, the current iterate is returned without convergence.
+ *
+ * @tparam MatVec Template type for the matrix-vector product. Should support
+ *                evaluation of the form A(x) for an Eigen::VectorXd x,
+ *                returning Ax as an Eigen::VectorXd
+ * @param A The matrix-vector product with the system matrix
+ * @param b The right hand side
+ * @param options The tolerance, maximum number of iterations and restart
+ *                length
+ * @return A SolverResult object containing the solution and the convergence
+ *         history
+ */
+template <typename MatVec>
+SolverResult GMRES(const MatVec &A, const Eigen::VectorXd &b,
+                   const SolverOptions &options = SolverOptions()) {
+  SolverResult result;
+  unsigned n = b.size();
+  result.solution = Eigen::VectorXd::Zero(n);
+  double b_norm = b.norm();
+  if (b_norm == 0) { // Trivial solution
+    result.converged = true;
+    result.residuals.push_back(0);
+    return result;
+  }
+  unsigned m = std::max(1u, std::min(options.restart, n));
+  bool breakdown = false;
+  // Krylov basis, Hessenberg matrix and the Givens rotations
+  Eigen::MatrixXd basis(n, m + 1);
+  Eigen::MatrixXd H = Eigen::MatrixXd::Zero(m + 1, m);
+  Eigen::VectorXd cs(m), sn(m), g(m + 1);
+  Eigen::VectorXd r = b;
+  double r_norm = b_norm;
+  result.residuals.push_back(1);
+  while (!breakdown && result.iterations < options.max_iterations &&
+         r_norm > options.tolerance * b_norm) {
+    // Starting a cycle with the current residual
+    basis.col(0) = r / r_norm;
+    g.setZero();
+    g(0) = r_norm;
+    unsigned k = 0;
+    while (k < m && result.iterations < options.max_iterations) {
+      // Arnoldi step
+      Eigen::VectorXd w = A(basis.col(k));
+      for (unsigned i = 0; i <= k; ++i) {
+        H(i, k) = w.dot(basis.col(i));
+        w -= H(i, k) * basis.col(i);
+      }
+      H(k + 1, k) = w.norm();
+      if (H(k + 1, k) > 0)
+        basis.col(k + 1) = w / H(k + 1, k);
+      // Applying the previous rotations to the new column
+      for (unsigned i = 0; i < k; ++i) {
+        double temp = cs(i) * H(i, k) + sn(i) * H(i + 1, k);
+        H(i + 1, k) = -sn(i) * H(i, k) + cs(i) * H(i + 1, k);
+        H(i, k) = temp;
+      }
+      // New rotation eliminating the subdiagonal entry
+      double denominator = std::hypot(H(k, k), H(k + 1, k));
+      if (denominator == 0) { // Breakdown with a singular Hessenberg matrix
+        breakdown = true;
+        ++result.iterations;
+        result.residuals.push_back(std::fabs(g(k)) / b_norm);
+        break;
+      }
+      cs(k) = H(k, k) / denominator;
+      sn(k) = H(k + 1, k) / denominator;
+      H(k, k) = denominator;
+      H(k + 1, k) = 0;
+      g(k + 1) = -sn(k) * g(k);
+      g(k) = cs(k) * g(k);
+      ++k;
+      ++result.iterations;
+      // The residual norm of the least squares problem
+      result.residuals.push_back(std::fabs(g(k)) / b_norm);
+      if (std::fabs(g(k)) <= options.tolerance * b_norm)
+        break;
+    }
+    // Updating the solution with the least squares solution
+    Eigen::VectorXd y = H.topLeftCorner(k, k)
+                            .triangularView<Eigen::Upper>()
+                            .solve(g.head(k));
+    result.solution += basis.leftCols(k) * y;
+    // Recomputing the residual for the restart
+    r = b - A(result.solution);
+    r_norm = r.norm();
+  }
+  result.converged = r_norm <= options.tolerance * b_norm;
+  return result;
+}
+
+} // namespace iterative_solvers
+} // namespace parametricbem2d
+
+#endif // ITERATIVESOLVERSHPP
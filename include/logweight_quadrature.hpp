@@ -25,6 +25,17 @@ struct QuadRule {
   Eigen::VectorXd w; // vector of quadrature weights
 };
 
+/**
+ * This Struct object gives read-only access to a stored log weighted
+ * quadrature rule. The nodes and weights point into static tables, so that no
+ * memory is allocated or copied when a rule is requested.
+ */
+struct LogWeightQRView {
+  std::size_t n;   // number of nodes/weights
+  const double *x; // pointer to the n quadrature nodes in [0,1]
+  const double *w; // pointer to the n quadrature weights
+};
+
 class test {
 public:
   unsigned x;
@@ -60,4 +71,16 @@ QuadRule getLogWeightQR(double a, int n);
  */
 std::pair<std::vector<double>, std::vector<double>> getLogWeightQR(int N);
 
+/**
+ * This function returns the same log weighted quadrature rule as
+ * getLogWeightQR(int), available for orders from 2 to 256, as a view into the
+ * static tables storing all the rules. The lookup takes constant time and does
+ * not allocate memory, which makes it suitable for the inner loops of the
+ * Galerkin matrix assembly.
+ *
+ * @param N Desired order for the quadrature rule
+ * @return LogWeightQRView struct pointing to the nodes and weights
+ */
+LogWeightQRView getLogWeightQRView(int N);
+
 #endif
@@ -12,8 +12,10 @@
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
 #include "adj_double_layer.hpp"
+#include "dof_map.hpp"
 #include "double_layer.hpp"
 #include "hypersingular.hpp"
+#include "iterative_solvers.hpp"
 #include "parametrized_mesh.hpp"
 #include "single_layer.hpp"
 #include <Eigen/Dense>
@@ -36,11 +38,13 @@ inline Eigen::VectorXd MassVector(const ParametrizedMesh &mesh,
   // Getting the number of reference shape functions in the space
   unsigned q = space.getQ();
   // Getting the panels
-  PanelVector panels = mesh.getPanels();
+  const PanelVector &panels = mesh.getPanels();
   unsigned numpanels = mesh.getNumPanels();
   // Getting the space dimensions to fix vector sizes
   unsigned int rows = space.getSpaceDim(numpanels);
   Eigen::VectorXd output = Eigen::VectorXd::Zero(rows);
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
   // Vector to store evaluation in reference coordinates
   Eigen::VectorXd local(q);
   for (unsigned panel = 0; panel < numpanels; ++panel) {
@@ -55,10 +59,8 @@ inline Eigen::VectorXd MassVector(const ParametrizedMesh &mesh,
     }
     // Local to global mapping of the elements
     for (unsigned int I = 0; I < q; ++I) {
-      // int II = space.LocGlobMap(I + 1, panel + 1, numpanels) - 1;
-      int II = space.LocGlobMap2(I + 1, panel + 1, mesh) - 1;
       // Filling the vector entries
-      output(II) += local(I);
+      output(dofs(I, panel)) += local(I);
     }
   }
   return output;
@@ -124,6 +126,59 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = lhs.lu().solve(rhs_vector);
   return sol.segment(0, W.rows());
 }
+
+/**
+ * This function solves the Neumann boundary value problem in the same way as
+ * the function above, but solves the linear system iteratively with the
+ * conjugate gradient method, see iterative_solvers::CG(). Instead of the
+ * augmented system, which is indefinite, the stabilized system with the
+ * symmetric positive definite matrix \f$W + cc^{T}\f$ is solved, using only
+ * products with W. As the constants are in the kernel of W, the vanishing mean
+ * condition \f$c^{T}u = 0\f$ of the augmented system is then enforced by
+ * subtracting a constant from the solution. The Galerkin matrices are still
+ * assembled densely as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param Tn Neumann boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the Dirichlet trace of
+ * the solution u
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> Tn,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  ContinuousSpace<1> trial_space;
+  ContinuousSpace<1> test_space;
+  // Space used for interpolation of Neumann data
+  DiscontinuousSpace<0> Tn_interpol_space;
+  // Computing W matrix
+  Eigen::MatrixXd W = hypersingular::GalerkinMatrix(mesh, trial_space, order);
+  // Computing Kp matrix
+  Eigen::MatrixXd Kp = adj_double_layer::GalerkinMatrix(mesh, Tn_interpol_space,
+                                                        test_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, Tn_interpol_space, order);
+  // Vector for storing Neumann data
+  Eigen::VectorXd Tn_N = Tn_interpol_space.Interpolate(Tn, mesh);
+  // Build rhs vector for solving
+  Eigen::VectorXd rhs = (0.5 * M - Kp) * Tn_N;
+  // The vector c used in the stabilized formulation
+  Eigen::VectorXd c = MassVector(mesh, test_space, order);
+  // Solving for coefficients with products by the stabilized lhs W + c c^T
+  iterative_solvers::SolverResult result = iterative_solvers::CG(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        return W * x + c * c.dot(x);
+      },
+      rhs, options);
+  // Enforcing the vanishing mean condition, c.sum() is the length of the
+  // boundary
+  result.solution.array() -= c.dot(result.solution) / c.sum();
+  return result;
+}
 } // namespace direct_first_kind
 
 /**
@@ -180,6 +235,60 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = lhs.lu().solve(rhs_vector);
   return sol.segment(0, Tn_N.rows());
 }
+
+/**
+ * This function solves the Neumann boundary value problem in the same way as
+ * the function above, but solves the augmented linear system iteratively with
+ * the GMRES method, see iterative_solvers::GMRES(), using only products with
+ * the Galerkin matrices M and K. The Galerkin matrices are still assembled
+ * densely as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param Tn Neumann boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the Dirichlet trace of
+ * the solution u
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> Tn,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  DiscontinuousSpace<0> trial_space;
+  DiscontinuousSpace<0> test_space;
+  // Space used for interpolation of Neumann data
+  DiscontinuousSpace<0> Tn_interpol_space;
+  // Computing V matrix
+  Eigen::MatrixXd V =
+      single_layer::GalerkinMatrix(mesh, Tn_interpol_space, order);
+  // Computing K matrix
+  Eigen::MatrixXd K =
+      double_layer::GalerkinMatrix(mesh, trial_space, test_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, trial_space, order);
+  // Vector for storing Neumann data
+  Eigen::VectorXd Tn_N = Tn_interpol_space.Interpolate(Tn, mesh);
+  // The vector c used in augmented formulation
+  Eigen::VectorXd c = MassVector(mesh, test_space, order);
+  unsigned dims = c.rows();
+  // Build rhs vector for solving
+  Eigen::VectorXd rhs_vector(dims + 1);
+  rhs_vector << V * Tn_N, 0;
+  // Solving for coefficients with products by the augmented lhs matrix
+  iterative_solvers::SolverResult result = iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        Eigen::VectorXd y(dims + 1);
+        y << 0.5 * (M * x.head(dims)) + K * x.head(dims) + c * x(dims),
+            c.dot(x.head(dims));
+        return y;
+      },
+      rhs_vector, options);
+  // Dropping the Lagrange multiplier
+  result.solution.conservativeResize(dims);
+  return result;
+}
 } // namespace direct_second_kind
 
 /**
@@ -232,6 +341,56 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = lhs.lu().solve(rhs_vector);
   return sol.segment(0, Tn_N.rows());
 }
+
+/**
+ * This function solves the Neumann boundary value problem in the same way as
+ * the function above, but solves the linear system iteratively with the
+ * conjugate gradient method, see iterative_solvers::CG(). Instead of the
+ * augmented system, which is indefinite, the stabilized system with the
+ * symmetric positive definite matrix \f$W + cc^{T}\f$ is solved, using only
+ * products with W. As the constants are in the kernel of W, the vanishing mean
+ * condition \f$c^{T}u = 0\f$ of the augmented system is then enforced by
+ * subtracting a constant from the solution. The Galerkin matrices are still
+ * assembled densely as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param Tn Neumann boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the density of the
+ * double layer potential
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> Tn,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  ContinuousSpace<1> trial_space;
+  ContinuousSpace<1> test_space;
+  // Space used for interpolation of Neumann data
+  DiscontinuousSpace<0> Tn_interpol_space;
+  // Computing W matrix
+  Eigen::MatrixXd W = hypersingular::GalerkinMatrix(mesh, trial_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, Tn_interpol_space, order);
+  // Vector for storing Neumann data
+  Eigen::VectorXd Tn_N = Tn_interpol_space.Interpolate(Tn, mesh);
+  // Build rhs vector for solving
+  Eigen::VectorXd rhs = -M * Tn_N;
+  // The vector c used in the stabilized formulation
+  Eigen::VectorXd c = MassVector(mesh, test_space, order);
+  // Solving for coefficients with products by the stabilized lhs W + c c^T
+  iterative_solvers::SolverResult result = iterative_solvers::CG(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        return W * x + c * c.dot(x);
+      },
+      rhs, options);
+  // Enforcing the vanishing mean condition, c.sum() is the length of the
+  // boundary
+  result.solution.array() -= c.dot(result.solution) / c.sum();
+  return result;
+}
 } // namespace indirect_first_kind
 
 /**
@@ -283,6 +442,57 @@ Eigen::VectorXd solve(const ParametrizedMesh &mesh,
   Eigen::VectorXd sol = lhs.lu().solve(rhs_vector);
   return sol.segment(0, Tn_N.rows());
 }
+
+/**
+ * This function solves the Neumann boundary value problem in the same way as
+ * the function above, but solves the augmented linear system iteratively with
+ * the GMRES method, see iterative_solvers::GMRES(), using only products with
+ * the Galerkin matrices M and K'. The Galerkin matrices are still assembled
+ * densely as above, only the factorization is avoided.
+ *
+ * @param mesh Parametrized mesh representing the boundary \f$\Gamma\f$.
+ * @param Tn Neumann boundary condition in 2D using a function of the form
+ *          double(double,double)
+ * @param order The order for gauss/log-weighted quadrature
+ * @param options The parameters for the iterative solver
+ * @return An iterative_solvers::SolverResult object whose solution represents
+ * the density of the
+ * single layer potential
+ */
+iterative_solvers::SolverResult
+solve(const ParametrizedMesh &mesh, std::function<double(double, double)> Tn,
+      unsigned order, const iterative_solvers::SolverOptions &options) {
+  // Same trial and test spaces
+  DiscontinuousSpace<0> trial_space;
+  DiscontinuousSpace<0> test_space;
+  // Space used for interpolation of Neumann data
+  DiscontinuousSpace<0> Tn_interpol_space;
+  // Computing Kp matrix
+  Eigen::MatrixXd Kp =
+      adj_double_layer::GalerkinMatrix(mesh, trial_space, test_space, order);
+  // Computing mass matrix
+  Eigen::MatrixXd M = MassMatrix(mesh, test_space, Tn_interpol_space, order);
+  // Vector for storing Neumann data
+  Eigen::VectorXd Tn_N = Tn_interpol_space.Interpolate(Tn, mesh);
+  // The vector c used in augmented formulation
+  Eigen::VectorXd c = MassVector(mesh, test_space, order);
+  unsigned dims = c.rows();
+  // Build rhs vector for solving
+  Eigen::VectorXd rhs_vector(dims + 1);
+  rhs_vector << M * Tn_N, 0;
+  // Solving for coefficients with products by the augmented lhs matrix
+  iterative_solvers::SolverResult result = iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        Eigen::VectorXd y(dims + 1);
+        y << 0.5 * (M * x.head(dims)) + Kp * x.head(dims) + c * x(dims),
+            c.dot(x.head(dims));
+        return y;
+      },
+      rhs_vector, options);
+  // Dropping the Lagrange multiplier
+  result.solution.conservativeResize(dims);
+  return result;
+}
 } // namespace indirect_second_kind
 } // namespace neumann_bvp
 } // namespace parametricbem2d
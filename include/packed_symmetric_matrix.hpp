@@ -0,0 +1,147 @@
+/**
+ * \file packed_symmetric_matrix.hpp
+ * \brief This file defines a class for storing symmetric matrices, such as
+ *        the Galerkin matrices for the Single Layer and Hypersingular BIOs,
+ *        using only their upper triangle.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef PACKEDSYMMETRICMATRIXHPP
+#define PACKEDSYMMETRICMATRIXHPP
+
+#include <cassert>
+#include <utility>
+
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * \class PackedSymmetricMatrix
+ * \brief This class stores a symmetric matrix of size dim X dim in packed
+ *        storage: the upper triangle is stored column after column in a
+ *        vector of size dim(dim+1)/2, as in the LAPACK packed format. The
+ *        entry (i,j) with i <= j is at position i + j(j+1)/2.
+ */
+class PackedSymmetricMatrix {
+public:
+  /**
+   * Constructor for a matrix of size dim X dim with all entries zero
+   *
+   * @param dim Number of rows and columns
+   */
+  explicit PackedSymmetricMatrix(unsigned int dim)
+      : dim_(dim), data_(Eigen::VectorXd::Zero(dim * (dim + 1) / 2)) {}
+
+  /**
+   * This function returns the number of rows of the matrix
+   *
+   * @return Number of rows
+   */
+  unsigned int rows() const { return dim_; }
+
+  /**
+   * This function returns the number of columns of the matrix
+   *
+   * @return Number of columns
+   */
+  unsigned int cols() const { return dim_; }
+
+  /**
+   * This function gives access to the entry (i,j), which is the same as the
+   * entry (j,i)
+   *
+   * @param i Row index (>=0)
+   * @param j Column index (>=0)
+   * @return Reference to the stored entry
+   */
+  double &operator()(unsigned int i, unsigned int j) {
+    return data_(Index(i, j));
+  }
+
+  /**
+   * This function returns the entry (i,j), which is the same as the entry
+   * (j,i)
+   *
+   * @param i Row index (>=0)
+   * @param j Column index (>=0)
+   * @return The entry (i,j)
+   */
+  double operator()(unsigned int i, unsigned int j) const {
+    return data_(Index(i, j));
+  }
+
+  /**
+   * This function returns the packed upper triangle
+   *
+   * @return Vector of size dim(dim+1)/2 containing the upper triangle
+   */
+  const Eigen::VectorXd &getData() const { return data_; }
+
+  /**
+   * This function converts the matrix to a dense matrix with both triangles
+   * filled
+   *
+   * @return The full dim X dim matrix
+   */
+  Eigen::MatrixXd toDense() const {
+    Eigen::MatrixXd dense(dim_, dim_);
+    for (unsigned int j = 0; j < dim_; ++j) {
+      for (unsigned int i = 0; i <= j; ++i) {
+        dense(i, j) = data_(i + j * (j + 1) / 2);
+        dense(j, i) = dense(i, j);
+      }
+    }
+    return dense;
+  }
+
+  /**
+   * This function evaluates the product of the matrix with a vector, reading
+   * every stored entry once
+   *
+   * @param x Vector of size dim
+   * @return The product of the matrix with x
+   */
+  Eigen::VectorXd operator*(const Eigen::VectorXd &x) const {
+    assert(static_cast<unsigned int>(x.rows()) == dim_);
+    Eigen::VectorXd y = Eigen::VectorXd::Zero(dim_);
+    for (unsigned int j = 0; j < dim_; ++j) {
+      // Column j of the upper triangle
+      const double *column = data_.data() + j * (j + 1) / 2;
+      for (unsigned int i = 0; i < j; ++i) {
+        y(i) += column[i] * x(j);
+        y(j) += column[i] * x(i);
+      }
+      y(j) += column[j] * x(j);
+    }
+    return y;
+  }
+
+private:
+  /**
+   * This function returns the position of the entry (i,j) in the packed
+   * storage
+   *
+   * @param i Row index (>=0)
+   * @param j Column index (>=0)
+   * @return Position in data_
+   */
+  unsigned int Index(unsigned int i, unsigned int j) const {
+    assert(i < dim_ && j < dim_);
+    if (i > j)
+      std::swap(i, j);
+    return i + j * (j + 1) / 2;
+  }
+
+  /**
+   * Number of rows and columns
+   */
+  unsigned int dim_;
+  /**
+   * The packed upper triangle
+   */
+  Eigen::VectorXd data_;
+}; // class PackedSymmetricMatrix
+} // namespace parametricbem2d
+
+#endif // PACKEDSYMMETRICMATRIXHPP
@@ -0,0 +1,307 @@
+/**
+ * \file panel_geometry_cache.hpp
+ * \brief This file declares a class which tabulates the geometry of all the
+ *        panels in a mesh at the nodes of a quadrature rule.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef PANELGEOMETRYCACHEHPP
+#define PANELGEOMETRYCACHEHPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "abstract_bem_space.hpp"
+#include "abstract_parametrized_curve.hpp"
+#include "logweight_quadrature.hpp"
+#include "parametrized_mesh.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * \class PanelGeometryCache
+ * \brief This class stores the points \f$\gamma\f$(t), the derivatives
+ *        \f$\dot{\gamma}\f$(t), the double derivatives \f$\ddot{\gamma}\f$(t),
+ *        the norms \f$\|\dot{\gamma}\f$(t)\f$\|\f$ and the unit normals of
+ *        all the panels in a mesh, evaluated at the nodes of a given
+ *        quadrature rule on [-1,1]. The values are computed once at
+ *        construction and stored contiguously, node after node and panel
+ *        after panel, so that the quadrature for disjoint panel pairs can
+ *        read them instead of evaluating the parametrizations for every pair.
+ */
+class PanelGeometryCache {
+public:
+  /**
+   * Type for a read-only view of the 2D quantities for the nodes of a panel
+   */
+  using ConstPointsView =
+      Eigen::Block<const Eigen::Matrix2Xd, 2, Eigen::Dynamic, true>;
+  /**
+   * Type for a read-only view of the scalar quantities for the nodes of a
+   * panel
+   */
+  using ConstValuesView = Eigen::VectorBlock<const Eigen::VectorXd>;
+
+  /**
+   * Constructor which tabulates the geometry of all the panels in the mesh at
+   * the nodes of the quadrature rule.
+   *
+   * @param mesh ParametrizedMesh object containing all the panels
+   * @param GaussQR QuadRule object on [-1,1] whose nodes are used
+   */
+  PanelGeometryCache(const ParametrizedMesh &mesh, const QuadRule &GaussQR);
+
+  /**
+   * The geometry for the lower orders is owned by this object, see
+   * getLowerOrder(), so it is not copied.
+   */
+  PanelGeometryCache(const PanelGeometryCache &) = delete;
+  PanelGeometryCache &operator=(const PanelGeometryCache &) = delete;
+
+  /**
+   * Destructor which frees the geometry tabulated for the lower orders
+   */
+  ~PanelGeometryCache();
+
+  /**
+   * This function is used for getting the number of panels in the cache
+   *
+   * @return number of panels
+   */
+  unsigned int getNumPanels() const { return panels_.size(); }
+
+  /**
+   * This function is used for getting the number of quadrature nodes per
+   * panel
+   *
+   * @return number of quadrature nodes
+   */
+  unsigned int getNumNodes() const { return numnodes_; }
+
+  /**
+   * This function is used for getting the parametrization of a panel
+   *
+   * @param i Index of the panel (>=0)
+   * @return The parametrized curve for the ith panel
+   */
+  const AbstractParametrizedCurve &getPanel(unsigned int i) const {
+    return *panels_[i];
+  }
+
+  /**
+   * This function is used for getting the connectivity of the panels, copied
+   * from the mesh
+   *
+   * @return The MeshTopology object for the panels
+   */
+  const MeshTopology &getTopology() const { return topology_; }
+
+  /**
+   * This function returns the geometry of the panels tabulated at the nodes of
+   * the Gauss rule of a lower order, as used by the adaptive quadrature for
+   * disjoint panels, see adaptive_quadrature::SelectOrder(). The geometry for
+   * an order is tabulated on its first request and kept until this object is
+   * destroyed, such that only the few orders actually used are tabulated. The
+   * lookup does not take a lock and can be done from several threads.
+   *
+   * @param order Order of the Gauss rule (< getNumNodes())
+   * @return PanelGeometryCache tabulated at the nodes of getGaussQR(order)
+   */
+  const PanelGeometryCache &getLowerOrder(unsigned int order) const;
+
+  /**
+   * This function returns the tabulated points \f$\gamma\f$(t) for a panel.
+   * The kth column corresponds to the kth quadrature node.
+   *
+   * @param i Index of the panel (>=0)
+   * @return Read-only view of the tabulated values
+   */
+  ConstPointsView getPoints(unsigned int i) const {
+    return points_.middleCols(i * numnodes_, numnodes_);
+  }
+
+  /**
+   * This function returns the tabulated points \f$\gamma\f$(t) for all the
+   * panels, node after node and panel after panel
+   *
+   * @return The tabulated values, one column per node
+   */
+  const Eigen::Matrix2Xd &getPoints() const { return points_; }
+
+  /**
+   * This function returns the tabulated derivatives \f$\dot{\gamma}\f$(t)
+   * for a panel. The kth column corresponds to the kth quadrature node.
+   *
+   * @param i Index of the panel (>=0)
+   * @return Read-only view of the tabulated values
+   */
+  ConstPointsView getDerivatives(unsigned int i) const {
+    return derivatives_.middleCols(i * numnodes_, numnodes_);
+  }
+
+  /**
+   * This function returns the tabulated double derivatives
+   * \f$\ddot{\gamma}\f$(t) for a panel. The kth column corresponds to the kth
+   * quadrature node.
+   *
+   * @param i Index of the panel (>=0)
+   * @return Read-only view of the tabulated values
+   */
+  ConstPointsView getDoubleDerivatives(unsigned int i) const {
+    return double_derivatives_.middleCols(i * numnodes_, numnodes_);
+  }
+
+  /**
+   * This function returns the tabulated unit normals for a panel. The kth
+   * column corresponds to the kth quadrature node.
+   *
+   * @param i Index of the panel (>=0)
+   * @return Read-only view of the tabulated values
+   */
+  ConstPointsView getNormals(unsigned int i) const {
+    return normals_.middleCols(i * numnodes_, numnodes_);
+  }
+
+  /**
+   * This function returns the tabulated unit normals for all the panels, node
+   * after node and panel after panel
+   *
+   * @return The tabulated values, one column per node
+   */
+  const Eigen::Matrix2Xd &getNormals() const { return normals_; }
+
+  /**
+   * This function returns the tabulated norms of the derivatives for a
+   * panel. The kth entry corresponds to the kth quadrature node.
+   *
+   * @param i Index of the panel (>=0)
+   * @return Read-only view of the tabulated values
+   */
+  ConstValuesView getDerivativeNorms(unsigned int i) const {
+    return derivative_norms_.segment(i * numnodes_, numnodes_);
+  }
+
+  /**
+   * This function returns the length of a panel, computed with the quadrature
+   * rule from the tabulated norms of the derivatives
+   *
+   * @param i Index of the panel (>=0)
+   * @return Length of the panel
+   */
+  double getLength(unsigned int i) const { return lengths_(i); }
+
+  /**
+   * This function returns a cheap estimate of the admissibility
+   * \f$\rho\f$ (see rho()) of a pair of panels. The distance between the
+   * panels is bounded from below using circles around the panels, which
+   * contain the endpoints and the tabulated points. The estimate is therefore
+   * larger than \f$\rho\f$ up to the sampling of the panels, and infinite if
+   * the circles intersect.
+   *
+   * @param i Index of the first panel (>=0)
+   * @param j Index of the second panel (>=0)
+   * @return Estimate of the admissibility for the given pair of panels
+   */
+  double estimateRho(unsigned int i, unsigned int j) const;
+
+  /**
+   * This function returns a cheap estimate of the admissibility of a panel
+   * with respect to a point, the length of the panel divided by the distance
+   * to the point. The distance is bounded from below as in
+   * estimateRho(unsigned int, unsigned int) const.
+   *
+   * @param x The point
+   * @param i Index of the panel (>=0)
+   * @return Estimate of the admissibility, infinite if the point lies in the
+   *         circle around the panel
+   */
+  double estimateRho(const Eigen::Vector2d &x, unsigned int i) const;
+
+  /**
+   * This function finds for every point the panels whose admissibility with
+   * respect to the point, see estimateRho(const Eigen::Vector2d &, unsigned
+   * int) const, is larger than rho. The panels are sorted into the cells of a
+   * uniform grid, such that the cost is linear in the number of points and
+   * panels for meshes with panels of similar size.
+   *
+   * @param points The points, one per column
+   * @param rho Admissibility (>0) above which a panel is close to a point
+   * @return The indices of the close panels for every point
+   */
+  std::vector<std::vector<unsigned int>>
+  findNearPanels(const Eigen::Matrix2Xd &points, double rho) const;
+
+private:
+  /**
+   * Constructor which tabulates the geometry of the given panels, used for
+   * the geometry of the lower orders.
+   *
+   * @param panels The panels of the mesh
+   * @param topology The connectivity of the panels
+   * @param GaussQR QuadRule object on [-1,1] whose nodes are used
+   */
+  PanelGeometryCache(const PanelVector &panels, const MeshTopology &topology,
+                     const QuadRule &GaussQR);
+
+  /**
+   * The panels of the mesh, used for the cases which are not covered by the
+   * tabulated values
+   */
+  const PanelVector panels_;
+  /**
+   * The connectivity of the panels, used for classifying the panel pairs
+   */
+  const MeshTopology topology_;
+  /**
+   * Number of quadrature nodes per panel
+   */
+  unsigned int numnodes_;
+  /**
+   * Tabulated points, derivatives, double derivatives and unit normals
+   */
+  Eigen::Matrix2Xd points_, derivatives_, double_derivatives_, normals_;
+  /**
+   * Tabulated norms of the derivatives
+   */
+  Eigen::VectorXd derivative_norms_;
+  /**
+   * Lengths of the panels
+   */
+  Eigen::VectorXd lengths_;
+  /**
+   * Centers and radii of the circles containing the panels
+   */
+  Eigen::Matrix2Xd centers_;
+  Eigen::VectorXd radii_;
+  /**
+   * The geometry tabulated for the lower orders, indexed by the order. The
+   * pointers are null until the geometry is requested by getLowerOrder().
+   */
+  std::unique_ptr<std::atomic<const PanelGeometryCache *>[]> lower_orders_;
+}; // class PanelGeometryCache
+
+/**
+ * This function tabulates a function \f$\Phi = \sum_{i} c_{i} b^{i}_{N}\f$
+ * in a BEM space at the quadrature nodes of all the panels, multiplied by the
+ * quadrature weights and the norms \f$\|\dot{\gamma}\f$(t)\f$\|\f$. The
+ * integral of \f$\Phi\f$ times a smooth function over the boundary is the
+ * dot product of the result with the values of the function at
+ * PanelGeometryCache::getPoints().
+ *
+ * @param geometry PanelGeometryCache for the mesh and GaussQR
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @param space The BEM space of the function
+ * @param coeffs The coefficients \f$c_{i}\f$ of the function
+ * @param GaussQR QuadRule object on [-1,1] used for the geometry
+ * @return The weighted values, node after node and panel after panel
+ */
+Eigen::VectorXd WeightedDensity(const PanelGeometryCache &geometry,
+                                const ParametrizedMesh &mesh,
+                                const AbstractBEMSpace &space,
+                                const Eigen::VectorXd &coeffs,
+                                const QuadRule &GaussQR);
+} // namespace parametricbem2d
+
+#endif // PANELGEOMETRYCACHEHPP
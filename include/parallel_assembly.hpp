@@ -0,0 +1,418 @@
+/**
+ * \file parallel_assembly.hpp
+ * \brief This file defines a multithreaded engine for the panel oriented
+ *        assembly (\f$\ref{pc:ass}\f$) of Galerkin matrices. The interaction
+ *        matrices for the panel pairs are computed concurrently and scattered
+ *        into the global matrix in the same order as the serial assembly, so
+ *        that the result does not depend on the number of threads used. The
+ *        interaction matrices are written into storage which is allocated
+ *        once per assembly and reused for all the panel pairs; only the
+ *        kernels for coinciding and adjacent panels allocate temporaries.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#ifndef PARALLELASSEMBLYHPP
+#define PARALLELASSEMBLYHPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dof_map.hpp"
+#include "parametrized_mesh.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+/**
+ * This namespace contains the functions for controlling the number of threads
+ * and for distributing the work of panel oriented assembly among them.
+ */
+namespace parallel_assembly {
+/**
+ * This function gives access to the thread count requested through
+ * setNumThreads(). A value of zero means that the thread count is chosen
+ * automatically at runtime.
+ *
+ * @return Reference to the requested number of threads
+ */
+inline std::atomic<unsigned> &RequestedNumThreads() {
+  static std::atomic<unsigned> requested(0);
+  return requested;
+}
+
+/**
+ * This function is used to fix the number of threads used by the assembly
+ * routines. Passing zero restores the automatic choice described in
+ * getNumThreads().
+ *
+ * @param numthreads Number of threads to be used for assembly
+ */
+inline void setNumThreads(unsigned numthreads) {
+  RequestedNumThreads() = numthreads;
+}
+
+/**
+ * This function returns the thread count used unless fixed by
+ * setNumThreads(). It is read from the environment variable
+ * PARAMETRICBEM2D_NUM_THREADS and otherwise equals the number of hardware
+ * threads available on the machine. Both are only queried at the first call.
+ *
+ * @return Default number of threads (>=1)
+ */
+inline unsigned DefaultNumThreads() {
+  static const unsigned numthreads = [] {
+    // Thread count specified through the environment
+    const char *env = std::getenv("PARAMETRICBEM2D_NUM_THREADS");
+    if (env != nullptr && std::atoi(env) > 0)
+      return static_cast<unsigned>(std::atoi(env));
+    // hardware_concurrency() may return 0 if it cannot be determined
+    return std::max(1u, std::thread::hardware_concurrency());
+  }();
+  return numthreads;
+}
+
+/**
+ * This function returns the number of threads used by the assembly routines.
+ * Unless fixed by setNumThreads(), it is read from the environment variable
+ * PARAMETRICBEM2D_NUM_THREADS and otherwise equals the number of hardware
+ * threads available on the machine, see DefaultNumThreads().
+ *
+ * @return Number of threads (>=1) to be used for assembly
+ */
+inline unsigned getNumThreads() {
+  unsigned requested = RequestedNumThreads();
+  if (requested > 0)
+    return requested;
+  return DefaultNumThreads();
+}
+
+/**
+ * This function evaluates func(k) for all k in [begin,end) using
+ * getNumThreads() threads. The indices are handed out dynamically to balance
+ * the load, which is uneven for panel pairs. An exception thrown by func on
+ * any thread is rethrown on the calling thread.
+ *
+ * @tparam Func Template type for the loop body. Should support evaluation of
+ *              the form func(unsigned)
+ * @param begin First index of the loop
+ * @param end One past the last index of the loop
+ * @param func The loop body
+ */
+template <typename Func>
+void ParallelFor(unsigned begin, unsigned end, const Func &func) {
+  if (end <= begin)
+    return;
+  unsigned numthreads = std::min(getNumThreads(), end - begin);
+  // Serial execution without the overhead of spawning threads
+  if (numthreads == 1) {
+    for (unsigned k = begin; k < end; ++k)
+      func(k);
+    return;
+  }
+  // The next index to be processed, shared by all the threads
+  std::atomic<unsigned> next(begin);
+  std::exception_ptr error = nullptr;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    try {
+      for (unsigned k = next++; k < end; k = next++)
+        func(k);
+    } catch (...) {
+      // Storing the first exception and stopping all the threads
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      next = end;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < numthreads; ++t)
+    threads.emplace_back(worker);
+  // The calling thread takes part in the work as well
+  worker();
+  for (std::thread &thread : threads)
+    thread.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/**
+ * This function adds the contributions of the pairs of panels (i,j), with i
+ * in [test_begin,test_end) and j in [trial_begin,trial_end), to a Galerkin
+ * matrix (\f$\ref{pc:ass}\f$) using multiple threads. The interaction
+ * matrices are computed in parallel for blocks of rows of panel pairs and
+ * then added to the matrix using the tabulated local to global maps. The
+ * addition is done in the same panel pair order as the serial loop over
+ * (i,j), which makes the result bit-identical to the serial assembly,
+ * independent of the number of threads. The storage for the interaction
+ * matrices of a block is reused by all the blocks.
+ *
+ * @tparam Kernel Template type for the interaction matrix evaluation. Should
+ *                support evaluation of the form kernel(i,j,interaction_matrix)
+ *                which writes the Qtest X Qtrial interaction matrix for the
+ *                test panel i and the trial panel j (0 based indices) into
+ *                the Eigen::MatrixXd interaction_matrix, which keeps its
+ *                storage from the previous call
+ * @param trial_dofs The local to global map of the trial space on the mesh
+ * @param test_dofs The local to global map of the test space on the mesh
+ * @param test_begin First test panel
+ * @param test_end One past the last test panel
+ * @param trial_begin First trial panel
+ * @param trial_end One past the last trial panel
+ * @param kernel The interaction matrix evaluation as described above
+ * @param output The matrix to which the contributions are added. The global
+ *               shape functions row_offset and col_offset correspond to its
+ *               first row and column.
+ * @param row_offset Global test shape function of the first row (0 based)
+ * @param col_offset Global trial shape function of the first column (0
+ *                   based)
+ */
+template <typename Kernel>
+void AddPanelPairContributions(const DofMap &trial_dofs,
+                               const DofMap &test_dofs, unsigned int test_begin,
+                               unsigned int test_end, unsigned int trial_begin,
+                               unsigned int trial_end, const Kernel &kernel,
+                               Eigen::MatrixXd &output,
+                               unsigned int row_offset = 0,
+                               unsigned int col_offset = 0) {
+  if (test_end <= test_begin || trial_end <= trial_begin)
+    return;
+  unsigned int numtrial = trial_end - trial_begin;
+  // Getting the number of local shape functions in the trial and test spaces
+  unsigned int Qtest = test_dofs.getQ();
+  unsigned int Qtrial = trial_dofs.getQ();
+  // Number of panel rows whose interaction matrices are kept in memory at a
+  // time. Several rows per thread keep the threads busy between the scatters.
+  unsigned int blocksize = std::min(test_end - test_begin, 4 * getNumThreads());
+  std::vector<Eigen::MatrixXd> interaction_matrices(
+      blocksize * numtrial, Eigen::MatrixXd(Qtest, Qtrial));
+  for (unsigned int first = test_begin; first < test_end; first += blocksize) {
+    unsigned int last = std::min(test_end, first + blocksize);
+    // Computing the interaction matrices for all panel pairs in the block
+    ParallelFor(0, (last - first) * numtrial, [&](unsigned int k) {
+      kernel(first + k / numtrial, trial_begin + k % numtrial,
+             interaction_matrices[k]);
+    });
+    // Local to global mapping of the elements in interaction matrices, in the
+    // same order as the serial assembly
+    for (unsigned int i = first; i < last; ++i) {
+      const int *II = test_dofs.getPanelDofs(i);
+      for (unsigned int j = trial_begin; j < trial_end; ++j) {
+        const int *JJ = trial_dofs.getPanelDofs(j);
+        const Eigen::MatrixXd &interaction_matrix =
+            interaction_matrices[(i - first) * numtrial + j - trial_begin];
+        // Filling the Galerkin matrix entries
+        for (unsigned int I = 0; I < Qtest; ++I)
+          for (unsigned int J = 0; J < Qtrial; ++J)
+            output(II[I] - row_offset, JJ[J] - col_offset) +=
+                interaction_matrix(I, J);
+      }
+    }
+  }
+}
+
+/**
+ * This function evaluates a Galerkin matrix by panel oriented assembly
+ * (\f$\ref{pc:ass}\f$) using multiple threads, see
+ * AddPanelPairContributions().
+ *
+ * @tparam Kernel Template type for the interaction matrix evaluation, see
+ *                AddPanelPairContributions()
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @param trial_dofs The local to global map of the trial space on the mesh
+ * @param test_dofs The local to global map of the test space on the mesh
+ * @param kernel The interaction matrix evaluation as described above
+ * @return An Eigen::MatrixXd type Galerkin Matrix for the given mesh and spaces
+ */
+template <typename Kernel>
+Eigen::MatrixXd AssembleGalerkinMatrix(const ParametrizedMesh &mesh,
+                                       const DofMap &trial_dofs,
+                                       const DofMap &test_dofs,
+                                       const Kernel &kernel) {
+  // Getting number of panels in the mesh
+  unsigned int numpanels = mesh.getNumPanels();
+  assert(trial_dofs.getNumPanels() == numpanels &&
+         test_dofs.getNumPanels() == numpanels);
+  // Initializing the Galerkin matrix with zeros
+  Eigen::MatrixXd output =
+      Eigen::MatrixXd::Zero(test_dofs.getSpaceDim(), trial_dofs.getSpaceDim());
+  AddPanelPairContributions(trial_dofs, test_dofs, 0, numpanels, 0, numpanels,
+                            kernel, output);
+  return output;
+}
+
+/**
+ * This function evaluates the block of a Galerkin matrix which couples two
+ * boundary components of the mesh, by panel oriented assembly using
+ * multiple threads. The rows of the block belong to the global shape
+ * functions of the component c in the test space and its columns to the ones
+ * of the component d in the trial space, see DofMap::getComponentOffset().
+ * Only the pairs of panels of the components c and d contribute to the
+ * block, such that the blocks can be computed independently of each other,
+ * e.g. with a cheaper kernel or a compressed representation for well
+ * separated components. Computing all the blocks with the same kernel gives
+ * the matrix of AssembleGalerkinMatrix().
+ *
+ * @tparam Kernel Template type for the interaction matrix evaluation, see
+ *                AddPanelPairContributions()
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @param trial_dofs The local to global map of the trial space on the mesh
+ * @param test_dofs The local to global map of the test space on the mesh
+ * @param c Index of the boundary component for the test space
+ * @param d Index of the boundary component for the trial space
+ * @param kernel The interaction matrix evaluation as described above
+ * @return The block of the Galerkin Matrix for the components c and d
+ */
+template <typename Kernel>
+Eigen::MatrixXd AssembleGalerkinBlock(const ParametrizedMesh &mesh,
+                                      const DofMap &trial_dofs,
+                                      const DofMap &test_dofs, unsigned int c,
+                                      unsigned int d, const Kernel &kernel) {
+  assert(c < mesh.getNumComponents() && d < mesh.getNumComponents());
+  // Global shape functions of the components
+  unsigned int row_offset = test_dofs.getComponentOffset(c);
+  unsigned int col_offset = trial_dofs.getComponentOffset(d);
+  unsigned int rows = test_dofs.getComponentOffset(c + 1) - row_offset;
+  unsigned int cols = trial_dofs.getComponentOffset(d + 1) - col_offset;
+  Eigen::MatrixXd output = Eigen::MatrixXd::Zero(rows, cols);
+  AddPanelPairContributions(
+      trial_dofs, test_dofs, mesh.getComponentOffset(c),
+      mesh.getComponentOffset(c + 1), mesh.getComponentOffset(d),
+      mesh.getComponentOffset(d + 1), kernel, output, row_offset, col_offset);
+  return output;
+}
+
+/**
+ * This function evaluates kernel(i,j,result) for all the pairs of panels (i,j)
+ * with i <= j using multiple threads, and passes the results to scatter. The
+ * results are passed in the order of the serial loop over (i,j), independent
+ * of the number of threads. The results for a block of panel rows are stored
+ * in objects which are reused by all the blocks.
+ *
+ * @tparam Result Type of the result for a pair of panels, default
+ *                constructible
+ * @tparam Kernel Template type for the evaluation for a pair of panels.
+ *                Should support evaluation of the form kernel(i,j,result) (0
+ *                based indices), which overwrites the Result object result
+ * @tparam Scatter Template type for processing the results. Should support
+ *                 evaluation of the form scatter(i,j,result)
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @param kernel The evaluation for a pair of panels as described above
+ * @param scatter The processing of the results as described above
+ */
+template <typename Result, typename Kernel, typename Scatter>
+void ForEachUpperPanelPair(const ParametrizedMesh &mesh, const Kernel &kernel,
+                           const Scatter &scatter) {
+  // Getting number of panels in the mesh
+  unsigned int numpanels = mesh.getNumPanels();
+  // Number of panel rows whose results are kept in memory at a time. Several
+  // rows per thread keep the threads busy between the scatters.
+  unsigned int blocksize = std::min(numpanels, 4 * getNumThreads());
+  std::vector<Result> results(static_cast<std::size_t>(blocksize) * numpanels);
+  for (unsigned int first = 0; first < numpanels; first += blocksize) {
+    unsigned int last = std::min(numpanels, first + blocksize);
+    // Evaluating the kernel for the panel pairs (i,j) with i <= j, one row i
+    // of the block per task. The results of the row start at (i - first) *
+    // numpanels, such that the index does not depend on the number of panels
+    // before the block.
+    ParallelFor(first, last, [&](unsigned int i) {
+      std::size_t row = static_cast<std::size_t>(i - first) * numpanels;
+      for (unsigned int j = i; j < numpanels; ++j)
+        kernel(i, j, results[row + j]);
+    });
+    // Processing the results in the same order for any number of threads
+    for (unsigned int i = first; i < last; ++i) {
+      std::size_t row = static_cast<std::size_t>(i - first) * numpanels;
+      for (unsigned int j = i; j < numpanels; ++j)
+        scatter(i, j, results[row + j]);
+    }
+  }
+}
+
+/**
+ * This function adds the contributions of the pairs of panels (i,j) and
+ * (j,i) to the upper triangle of a symmetric Galerkin matrix, given the
+ * interaction matrix for (i,j) with i <= j. The contribution of (j,i) is
+ * taken as the transpose of the one of (i,j). The interaction matrix of
+ * coinciding panels is symmetrized, such that the assembled matrix is exactly
+ * symmetric.
+ *
+ * @tparam Add Template type for storing the entries. Should support
+ *             evaluation of the form add(row,col,value) with row <= col
+ * @param dofs The local to global map of the trial and test space
+ * @param i Index of the first panel (0 based)
+ * @param j Index of the second panel (0 based, >= i)
+ * @param interaction_matrix The Q X Q interaction matrix for the panels i and j
+ * @param add The function adding a value to an entry of the upper triangle
+ */
+template <typename Add>
+void ScatterSymmetric(const DofMap &dofs, unsigned int i, unsigned int j,
+                      const Eigen::MatrixXd &interaction_matrix,
+                      const Add &add) {
+  // Getting the number of local shape functions in the space
+  unsigned int Q = dofs.getQ();
+  // Adds a contribution to the Galerkin matrix if it is in the upper triangle
+  auto scatter = [&](unsigned int row, unsigned int col, double value) {
+    if (row <= col)
+      add(row, col, value);
+  };
+  // Local to global mapping of the elements in the interaction matrix
+  const int *II = dofs.getPanelDofs(i);
+  const int *JJ = dofs.getPanelDofs(j);
+  for (unsigned int I = 0; I < Q; ++I) {
+    for (unsigned int J = 0; J < Q; ++J) {
+      // Removing the asymmetry due to the quadrature for coinciding panels
+      double value =
+          i == j ? 0.5 * (interaction_matrix(I, J) + interaction_matrix(J, I))
+                 : interaction_matrix(I, J);
+      // Contribution of the pair (i,j)
+      scatter(II[I], JJ[J], value);
+      // Contribution of the pair (j,i)
+      if (i != j)
+        scatter(JJ[J], II[I], value);
+    }
+  }
+}
+
+/**
+ * This function performs the panel oriented assembly (\f$\ref{pc:ass}\f$) of
+ * a symmetric Galerkin matrix using multiple threads. The interaction
+ * matrices are computed only for the panel pairs (i,j) with i <= j, see
+ * ForEachUpperPanelPair(), and only the contributions to the upper triangle
+ * of the Galerkin matrix are passed to add, see ScatterSymmetric().
+ *
+ * @tparam Kernel Template type for the interaction matrix evaluation. Should
+ *                support evaluation of the form kernel(i,j,interaction_matrix)
+ *                which writes the Q X Q interaction matrix for the panels i
+ *                and j (0 based indices) into the Eigen::MatrixXd
+ *                interaction_matrix, see AddPanelPairContributions()
+ * @tparam Add Template type for storing the entries. Should support
+ *             evaluation of the form add(row,col,value) with row <= col
+ * @param mesh ParametrizedMesh object containing all the panels
+ * @param dofs The local to global map of the trial and test space
+ * @param kernel The interaction matrix evaluation as described above
+ * @param add The function adding a value to an entry of the upper triangle
+ */
+template <typename Kernel, typename Add>
+void AssembleSymmetricGalerkinMatrix(const ParametrizedMesh &mesh,
+                                     const DofMap &dofs, const Kernel &kernel,
+                                     const Add &add) {
+  ForEachUpperPanelPair<Eigen::MatrixXd>(
+      mesh, kernel,
+      [&](unsigned int i, unsigned int j,
+          const Eigen::MatrixXd &interaction_matrix) {
+        ScatterSymmetric(dofs, i, j, interaction_matrix, add);
+      });
+}
+
+} // namespace parallel_assembly
+} // namespace parametricbem2d
+
+#endif // PARALLELASSEMBLYHPP
@@ -52,6 +52,21 @@ public:
    */
   Eigen::Vector2d DoubleDerivative(double) const;
 
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Evaluate(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Derivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void DoubleDerivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
   /**
    * See documentation in AbstractParametrizedCurve
    */
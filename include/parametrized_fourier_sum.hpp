@@ -11,6 +11,8 @@
 
 #include "abstract_parametrized_curve.hpp"
 
+#include <memory>
+
 namespace parametricbem2d {
 /**
  * \class ParametrizedFourierSum
@@ -60,23 +62,70 @@ public:
    */
   Eigen::Vector2d DoubleDerivative(double) const;
 
+  /**
+   * This function evaluates the parametrization together with its first and
+   * second derivative at the parameter t, in one pass over the terms of the
+   * sum. Instead of evaluating cos(nt) and sin(nt) for every term, they are
+   * obtained from cos(t) and sin(t) by the angle addition formulas, and no
+   * memory is allocated.
+   *
+   * @param t Parameter value within the parameter range
+   * @param point Is set to \f$\gamma\f$(t)
+   * @param derivative Is set to \f$\dot{\gamma}\f$(t)
+   * @param double_derivative Is set to \f$\ddot{\gamma}\f$(t)
+   */
+  void EvaluateWithDerivatives(double t, Eigen::Vector2d &point,
+                               Eigen::Vector2d &derivative,
+                               Eigen::Vector2d &double_derivative) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Evaluate(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Derivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void DoubleDerivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
   /**
    * See documentation in AbstractParametrizedCurve
    */
   PanelVector split(unsigned int) const;
 
 private:
+  /**
+   * Constructor sharing the coefficient lists with another parametrization,
+   * used by split() such that all the parts refer to the same coefficients
+   * instead of holding copies of them.
+   *
+   * @param center Constant term 'c' in the parametrization
+   * @param cos_list Shared coefficient list for cosine terms
+   * @param sin_list Shared coefficient list for sine terms
+   * @param tmin Lower end of the actual parameter interval
+   * @param tmax Upper end of the actual parameter interval
+   */
+  ParametrizedFourierSum(Eigen::Vector2d center,
+                         std::shared_ptr<const CoefficientsList> cos_list,
+                         std::shared_ptr<const CoefficientsList> sin_list,
+                         double tmin, double tmax);
+
   /**
    * List of coefficients for the cosine terms in Fourier Sum based
-   * parametrization
+   * parametrization, shared by all the parts obtained with split()
    */
-  const CoefficientsList cosine_;
+  const std::shared_ptr<const CoefficientsList> cosine_;
 
   /**
    * List of coefficients for the sine terms in Fourier Sum based
-   * parametrization
+   * parametrization, shared by all the parts obtained with split()
    */
-  const CoefficientsList sine_;
+  const std::shared_ptr<const CoefficientsList> sine_;
 
   /**
    * Storing the actual range of parameter within the parameter range
@@ -11,12 +11,114 @@
 
 #include "abstract_parametrized_curve.hpp"
 
+#include <cassert>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include <Eigen/Dense>
 
 namespace parametricbem2d {
+/**
+ * This enumeration lists the relations between two panels of a mesh which
+ * require different quadrature rules in the assembly.
+ */
+enum class PanelRelation {
+  Coinciding, // The same panel
+  Adjacent,   // Distinct panels sharing an end point
+  Disjoint    // Panels without a common point
+};
+
+/**
+ * \class MeshTopology
+ * \brief This class stores the connectivity of the panels in a mesh: for
+ *        every panel, the panel starting at its end point and the panel
+ *        ending at its starting point, and the chain of connected panels it
+ *        belongs to. It is built once from the end points of the panels,
+ *        such that the relation of two panels can be looked up in O(1)
+ *        without evaluating the parametrizations.
+ */
+class MeshTopology {
+public:
+  /**
+   * Constructor which determines the connectivity of the panels. The end
+   * point of a panel and the starting point of another one are identified
+   * if their distance is below 100 times the machine epsilon. The cost is
+   * \f$O(n \log n)\f$ for n panels.
+   *
+   * @param panels PanelVector containing the panels of the mesh
+   */
+  explicit MeshTopology(const PanelVector &panels);
+
+  /**
+   * This function returns the panel following a panel, which starts at the
+   * end point of the given one.
+   *
+   * @param i Index of the panel (0 based)
+   * @return Index of the next panel, or the number of panels if there is none
+   */
+  unsigned int getNext(unsigned int i) const { return next_[i]; }
+
+  /**
+   * This function returns the panel preceding a panel, which ends at the
+   * starting point of the given one.
+   *
+   * @param i Index of the panel (0 based)
+   * @return Index of the previous panel, or the number of panels if there is
+   *         none
+   */
+  unsigned int getPrevious(unsigned int i) const { return previous_[i]; }
+
+  /**
+   * This function returns the chain containing a panel. The chains are the
+   * maximal sequences of connected panels, found from the end points of the
+   * panels in any order, and numbered in the order of their lowest panel
+   * indices. They are not the boundary components of ParametrizedMesh, which
+   * are ranges of consecutive panels, see ParametrizedMesh::getComponent().
+   *
+   * @param i Index of the panel (0 based)
+   * @return Index of the chain (0 based)
+   */
+  unsigned int getChain(unsigned int i) const { return chain_[i]; }
+
+  /**
+   * This function returns the number of chains of connected panels.
+   *
+   * @return Number of chains
+   */
+  unsigned int getNumChains() const { return numchains_; }
+
+  /**
+   * This function classifies a pair of panels for the choice of the
+   * quadrature rule.
+   *
+   * @param i Index of the first panel (0 based)
+   * @param j Index of the second panel (0 based)
+   * @return The relation between the panels i and j
+   */
+  PanelRelation getRelation(unsigned int i, unsigned int j) const {
+    if (i == j)
+      return PanelRelation::Coinciding;
+    if (next_[i] == j || next_[j] == i)
+      return PanelRelation::Adjacent;
+    return PanelRelation::Disjoint;
+  }
+
+private:
+  /**
+   * Indices of the next and the previous panels
+   */
+  std::vector<unsigned int> next_, previous_;
+  /**
+   * Indices of the chains of the panels
+   */
+  std::vector<unsigned int> chain_;
+  /**
+   * Number of chains
+   */
+  unsigned int numchains_;
+}; // class MeshTopology
+
 /**
  * \class ParametrizedMesh
  * \brief This class represents a mesh which is comprised of panels in the
@@ -24,7 +126,11 @@ namespace parametricbem2d {
  *        matrices using the parametric BEM approach. It stores the panels
  *        using PanelVector and enforces additional constraints which
  *        require the end point of a panel to be the starting point of the
- *        next, such that the panels form a curved polygon.
+ *        next, such that the panels form a curved polygon. A mesh may consist
+ *        of any number of boundary components (e.g. the outer boundary and
+ *        the holes of a perforated domain), each given by consecutive panels.
+ *        The components are found at construction and described by a table
+ *        of offsets, see getComponentOffset().
  */
 class ParametrizedMesh {
 public:
@@ -36,11 +142,26 @@ public:
 
   /**
    * This function is used for retrieving a PanelVector containing all the
-   * parametrized curve panels in the parametrized mesh.
+   * parametrized curve panels in the parametrized mesh. The panels are not
+   * copied, such that the access is free of allocations and reference count
+   * updates.
+   *
+   * @return A reference to the PanelVector containing all the parametrized
+   *         panels in the mesh, valid as long as the mesh object
+   */
+  const PanelVector &getPanels() const;
+
+  /**
+   * This function is used for accessing the ith panel in the parametrized
+   * mesh without copying the PanelVector.
    *
-   * @return A PanelVector containing all the parametrized panels in the mesh
+   * @param i Index of the panel (0 based)
+   * @return A reference to the ith parametrized panel in the mesh
    */
-  PanelVector getPanels() const;
+  const AbstractParametrizedCurve &getPanel(unsigned int i) const {
+    assert(i < panels_.size()); // Asserting requested index is within limits
+    return *panels_[i];
+  }
 
   /**
    * This function is used for getting the number of panels in the
@@ -61,12 +182,60 @@ public:
    * This function is used for getting the split value for the mesh. If split
    * is non zero, it indicates the position where the second boundary begins
    * in the mesh object; the domain is annular. A zero value indicates there is
-   * only one boundary in the mesh object
+   * only one boundary in the mesh object. Meshes with more boundaries are
+   * described by getComponentOffset().
    *
    * @return The position in the mesh where the second boundary begins
    */
   unsigned getSplit() const { return split_; }
 
+  /**
+   * This function is used for getting the number of boundary components in
+   * the mesh. A new component begins after every panel whose end point is not
+   * the starting point of the next panel.
+   *
+   * @return Number of boundary components (>=1 for a non empty mesh)
+   */
+  unsigned int getNumComponents() const { return offsets_.size() - 1; }
+
+  /**
+   * This function is used for getting the position in the mesh where a
+   * boundary component begins. The panels of the component c are the ones
+   * with the indices getComponentOffset(c) to getComponentOffset(c+1)-1.
+   *
+   * @param c Index of the component (<= getNumComponents())
+   * @return Index of the first panel of the component c, or the number of
+   *         panels for c = getNumComponents()
+   */
+  unsigned int getComponentOffset(unsigned int c) const {
+    assert(c < offsets_.size()); // Asserting requested index is within limits
+    return offsets_[c];
+  }
+
+  /**
+   * This function is used for getting the boundary component containing a
+   * panel. The components are the ranges of consecutive panels given by
+   * getComponentOffset(); the numbering of the global shape functions in
+   * AbstractBEMSpace::LocGlobMap2() and DofMap relies on them. If the panels
+   * of every boundary are stored consecutively, the components coincide with
+   * the chains of MeshTopology::getChain().
+   *
+   * @param i Index of the panel (0 based)
+   * @return Index of the component containing the panel i
+   */
+  unsigned int getComponent(unsigned int i) const {
+    assert(i < components_.size()); // Asserting index is within limits
+    return components_[i];
+  }
+
+  /**
+   * This function is used for getting the connectivity of the panels, which
+   * is determined once at construction.
+   *
+   * @return The MeshTopology object for the mesh
+   */
+  const MeshTopology &getTopology() const { return topology_; }
+
   //void addPanels(const PanelVector& panels) {
   //  panels_.insert()
   //}
@@ -76,6 +245,19 @@ private:
    * Private const field for the PanelVector of the mesh
    */
   const PanelVector panels_;
+  /**
+   * Private field for the connectivity of the panels
+   */
+  MeshTopology topology_;
+  /**
+   * Private field for the positions where the boundary components begin,
+   * followed by the number of panels
+   */
+  std::vector<unsigned int> offsets_;
+  /**
+   * Private field for the boundary components containing the panels
+   */
+  std::vector<unsigned int> components_;
   /**
    * Private unsigned field used to distinguish one boundary from another in the
    * mesh (annular domain). Indicates the starting position of second boundary.
@@ -11,12 +11,17 @@
 
 #include "abstract_parametrized_curve.hpp"
 
+#include <memory>
+
 namespace parametricbem2d {
 /**
  * \class ParametrizedPolynomial
  * \brief This class represents a polynomial parametrization
  *        of the form \f$\gamma\f$(t) = \f$$\sum_{n=0}^{N} a_n t^{n}$\f$ and
- *        inherits from the Abstract base class representing parametrized curves
+ *        inherits from the Abstract base class representing parametrized
+ *        curves. Alternatively, the coefficients can refer to the Chebyshev
+ *        polynomials, \f$\gamma\f$(t) = \f$$\sum_{n=0}^{N} a_n T_n(t)$\f$,
+ *        which is numerically stable for high degrees.
  * @see abstract_parametrized_curve.hpp
  */
 class ParametrizedPolynomial : public AbstractParametrizedCurve {
@@ -26,6 +31,13 @@ public:
    */
   using CoefficientsList = typename Eigen::Matrix<double, 2, Eigen::Dynamic>;
 
+  /**
+   * The polynomial bases the coefficients can refer to. Polynomials in the
+   * monomial basis are evaluated with the Horner scheme, polynomials in the
+   * Chebyshev basis with the Clenshaw recurrence.
+   */
+  enum class Basis { Monomial, Chebyshev };
+
   /**
    * Constructor with a coefficient list type parameter that is Eigen::MatrixXd
    * with size: 2 X N. Here N-1 is the degree of the polynomial
@@ -35,9 +47,11 @@ public:
    *             linearly mapped to the standard interval
    * @param tmax Upper end of the actual parameter interval used which is
    *             linearly mapped to the standard interval
+   * @param basis The basis the coefficients refer to, the Chebyshev
+   *              polynomials are defined on [-1,1]
    */
   ParametrizedPolynomial(CoefficientsList coeffs, double tmin = -1.,
-                         double tmax = 1.);
+                         double tmax = 1., Basis basis = Basis::Monomial);
 
   /**
    * See documentation in AbstractParametrizedCurve
@@ -54,6 +68,36 @@ public:
    */
   Eigen::Vector2d DoubleDerivative(double) const;
 
+  /**
+   * This function evaluates the parametrization together with its first and
+   * second derivative at the parameter t, in one pass over the coefficients
+   * (Horner scheme or Clenshaw recurrence, depending on the basis) and
+   * without allocating memory.
+   *
+   * @param t Parameter value within the parameter range
+   * @param point Is set to \f$\gamma\f$(t)
+   * @param derivative Is set to \f$\dot{\gamma}\f$(t)
+   * @param double_derivative Is set to \f$\ddot{\gamma}\f$(t)
+   */
+  void EvaluateWithDerivatives(double t, Eigen::Vector2d &point,
+                               Eigen::Vector2d &derivative,
+                               Eigen::Vector2d &double_derivative) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Evaluate(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void Derivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
+  /**
+   * See documentation in AbstractParametrizedCurve
+   */
+  void DoubleDerivative(const Eigen::ArrayXd &, Eigen::Matrix2Xd &) const;
+
   /**
    * See documentation in AbstractParametrizedCurve
    */
@@ -61,9 +105,23 @@ public:
 
 private:
   /**
-   * List of coefficients for the polynomial parametrization
+   * Constructor sharing the coefficient list with another parametrization,
+   * used by split() such that all the parts refer to the same coefficients
+   * instead of holding copies of them.
+   *
+   * @param coeffs Shared coefficient list for the parametrization
+   * @param tmin Lower end of the actual parameter interval
+   * @param tmax Upper end of the actual parameter interval
+   * @param basis The basis the coefficients refer to
    */
-  const CoefficientsList coeffs_;
+  ParametrizedPolynomial(std::shared_ptr<const CoefficientsList> coeffs,
+                         double tmin, double tmax, Basis basis);
+
+  /**
+   * List of coefficients for the polynomial parametrization, shared by all
+   * the parts obtained with split()
+   */
+  const std::shared_ptr<const CoefficientsList> coeffs_;
 
   /**
    * Storing the actual range of parameter within the parameter range
@@ -71,6 +129,11 @@ private:
    * for the split functionality to make part Fourier Sum parameterizations.
    */
   const double tmin_, tmax_;
+
+  /**
+   * The basis the coefficients refer to
+   */
+  const Basis basis_;
 }; // class ParametrizedPolynomial
 } // namespace parametricbem2d
 
@@ -55,6 +55,40 @@ Eigen::Vector2d ParametrizedCircularArc::DoubleDerivative(double t) const {
   return double_derivative;
 }
 
+void ParametrizedCircularArc::Evaluate(const Eigen::ArrayXd &t,
+                                       Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  // Polar angles for all the parameters at once
+  double mean = (phi_start_ + phi_end_) / 2.;
+  double difference = (phi_end_ - phi_start_) / 2.;
+  Eigen::ArrayXd phi = t * difference + mean;
+  out.resize(2, t.size());
+  out.row(0) = (center_(0) + radius_ * phi.cos()).transpose();
+  out.row(1) = (center_(1) + radius_ * phi.sin()).transpose();
+}
+
+void ParametrizedCircularArc::Derivative(const Eigen::ArrayXd &t,
+                                         Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  double mean = (phi_start_ + phi_end_) / 2.;
+  double difference = (phi_end_ - phi_start_) / 2.;
+  Eigen::ArrayXd phi = t * difference + mean;
+  out.resize(2, t.size());
+  out.row(0) = (-radius_ * difference * phi.sin()).transpose();
+  out.row(1) = (radius_ * difference * phi.cos()).transpose();
+}
+
+void ParametrizedCircularArc::DoubleDerivative(const Eigen::ArrayXd &t,
+                                               Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  double mean = (phi_start_ + phi_end_) / 2.;
+  double diff = (phi_end_ - phi_start_) / 2.;
+  Eigen::ArrayXd phi = t * diff + mean;
+  out.resize(2, t.size());
+  out.row(0) = (-radius_ * diff * diff * phi.cos()).transpose();
+  out.row(1) = (-radius_ * diff * diff * phi.sin()).transpose();
+}
+
 PanelVector ParametrizedCircularArc::split(unsigned int N) const {
   // PanelVector for storing the part parametrizations
   PanelVector parametrization_parts;
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <iostream>
 #include <math.h>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -24,76 +25,106 @@ ParametrizedFourierSum::ParametrizedFourierSum(Eigen::Vector2d center,
                                                CoefficientsList cos_list,
                                                CoefficientsList sin_list,
                                                double tmin, double tmax)
+    : ParametrizedFourierSum(center,
+                             std::make_shared<CoefficientsList>(cos_list),
+                             std::make_shared<CoefficientsList>(sin_list),
+                             tmin, tmax) {}
+
+ParametrizedFourierSum::ParametrizedFourierSum(
+    Eigen::Vector2d center, std::shared_ptr<const CoefficientsList> cos_list,
+    std::shared_ptr<const CoefficientsList> sin_list, double tmin, double tmax)
     : center_(center), cosine_(cos_list), sine_(sin_list), tmin_(tmin),
       tmax_(tmax) {
   // Checking consistency
-  assert(cosine_.cols() == sine_.cols());
+  assert(cosine_->cols() == sine_->cols());
 }
 
 Eigen::Vector2d ParametrizedFourierSum::operator()(double t) const {
-  assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
-  // Number of cosine/sine terms in the sum
-  int N = cosine_.cols();
-  // Vectors for storing the cosine and sine values
-  Eigen::VectorXd cos_theta(N);
-  Eigen::VectorXd sin_theta(N);
-  // Filling the cosine and sine vectors
-  for (int i = 0; i < N; ++i) {
-    // Computing cosine and sine values at the parameter value t
-    cos_theta(i) = cos((i + 1) * t);
-    sin_theta(i) = sin((i + 1) * t);
-  }
-  // Matrix multiplication to create the Fourier Sum (in vector form)
-  // [2 x N] X [N x 1] = [2 x 1]
-  Eigen::Vector2d point = cosine_ * cos_theta + sine_ * sin_theta;
-  return point + center_;
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
+  return point;
 }
 
 Eigen::Vector2d ParametrizedFourierSum::Derivative(double t) const {
-  assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
-  // Number of cosine/sine terms in the sum
-  int N = cosine_.cols();
-  // Vectors for storing the cosine and sine derivatives
-  Eigen::VectorXd cos_theta_dot(N);
-  Eigen::VectorXd sin_theta_dot(N);
-  // Filling the vectors with derivatives
-  for (int i = 0; i < N; ++i) {
-    // Computing the derivatives for cosine and sine terms
-    cos_theta_dot(i) = -(i + 1) * (tmax_ - tmin_) / 2 * sin((i + 1) * t);
-    sin_theta_dot(i) = (i + 1) * (tmax_ - tmin_) / 2 * cos((i + 1) * t);
-  }
-  // Matrix multiplication to create the derivative of Fourier Sum (in vector
-  // form) [2 x N] X [N x 1] = [2 x 1]
-  Eigen::Vector2d derivative = cosine_ * cos_theta_dot + sine_ * sin_theta_dot;
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
   return derivative;
 }
 
 Eigen::Vector2d ParametrizedFourierSum::DoubleDerivative(double t) const {
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
+  return double_derivative;
+}
+
+void ParametrizedFourierSum::EvaluateWithDerivatives(
+    double t, Eigen::Vector2d &point, Eigen::Vector2d &derivative,
+    Eigen::Vector2d &double_derivative) const {
   assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
+  // Derivative of the map from the standard interval to [tmin,tmax]
+  double scale = (tmax_ - tmin_) / 2;
+  t = t * scale + (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
+  // cos(t) and sin(t), the only trigonometric evaluations
+  double cos_t = cos(t);
+  double sin_t = sin(t);
+  // cos(nt) and sin(nt) for the current term n
+  double cos_nt = cos_t;
+  double sin_nt = sin_t;
+  // Components of the sums, accumulated in scalars to avoid temporaries
+  double x = 0, y = 0, dx = 0, dy = 0, ddx = 0, ddy = 0;
+  // Coefficients, stored column major: (x,y) of the n-th term at 2(n-1)
+  const double *a = cosine_->data();
+  const double *b = sine_->data();
   // Number of cosine/sine terms in the sum
-  int N = cosine_.cols();
-  // Vectors for storing the cosine and sine double derivatives
-  Eigen::VectorXd cos_theta_ddot(N);
-  Eigen::VectorXd sin_theta_ddot(N);
-  // Filling the vectors with double derivatives
-  for (int i = 0; i < N; ++i) {
-    // Computing the double derivatives for cosine and sine terms
-    cos_theta_ddot(i) = -(i + 1) * (i + 1) * (tmax_ - tmin_) / 2 *
-                        (tmax_ - tmin_) / 2 * cos((i + 1) * t);
-    sin_theta_ddot(i) = -(i + 1) * (i + 1) * (tmax_ - tmin_) / 2 *
-                        (tmax_ - tmin_) / 2 * sin((i + 1) * t);
+  int N = cosine_->cols();
+  for (int n = 1; n <= N; ++n, a += 2, b += 2) {
+    // n-th term of the sum and of its derivative
+    double term_x = a[0] * cos_nt + b[0] * sin_nt;
+    double term_y = a[1] * cos_nt + b[1] * sin_nt;
+    x += term_x;
+    y += term_y;
+    dx += n * (b[0] * cos_nt - a[0] * sin_nt);
+    dy += n * (b[1] * cos_nt - a[1] * sin_nt);
+    ddx -= n * n * term_x;
+    ddy -= n * n * term_y;
+    // Angle addition formulas for cos((n+1)t) and sin((n+1)t)
+    double cos_next = cos_nt * cos_t - sin_nt * sin_t;
+    sin_nt = sin_nt * cos_t + cos_nt * sin_t;
+    cos_nt = cos_next;
+  }
+  point << center_(0) + x, center_(1) + y;
+  derivative << scale * dx, scale * dy;
+  double_derivative << scale * scale * ddx, scale * scale * ddy;
+}
+
+void ParametrizedFourierSum::Evaluate(const Eigen::ArrayXd &t,
+                                      Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = point;
+  }
+}
+
+void ParametrizedFourierSum::Derivative(const Eigen::ArrayXd &t,
+                                        Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = derivative;
+  }
+}
+
+void ParametrizedFourierSum::DoubleDerivative(const Eigen::ArrayXd &t,
+                                              Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = double_derivative;
   }
-  // Matrix multiplication to create the double derivative of Fourier Sum
-  // [2 x N] X [N x 1] = [2 x 1]
-  Eigen::Vector2d double_derivative =
-      cosine_ * cos_theta_ddot + sine_ * sin_theta_ddot;
-  return double_derivative;
 }
 
 PanelVector ParametrizedFourierSum::split(unsigned int N) const {
@@ -106,9 +137,10 @@ PanelVector ParametrizedFourierSum::split(unsigned int N) const {
     double tmax = tmin_ + (i + 1) * (tmax_ - tmin_) / N;
     if (i == N - 1)
       tmax = tmax_;
-    // Adding the part parametrization to the vector with a shared pointer
-    parametrization_parts.push_back(std::make_shared<ParametrizedFourierSum>(
-        center_, cosine_, sine_, tmin, tmax));
+    // Adding the part parametrization to the vector with a shared pointer,
+    // the part refers to the coefficients of this parametrization
+    parametrization_parts.push_back(std::shared_ptr<ParametrizedFourierSum>(
+        new ParametrizedFourierSum(center_, cosine_, sine_, tmin, tmax)));
   }
   return parametrization_parts;
 }
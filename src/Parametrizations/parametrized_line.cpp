@@ -46,6 +46,29 @@ Eigen::Vector2d ParametrizedLine::DoubleDerivative(double t) const {
   return double_derivative;
 }
 
+void ParametrizedLine::Evaluate(const Eigen::ArrayXd &t,
+                                Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  out.resize(2, t.size());
+  // Linear interpolation of x & y coordinates for all the parameters at once
+  for (unsigned i = 0; i < 2; ++i)
+    out.row(i) =
+        (t * (end_(i) - start_(i)) / 2 + (end_(i) + start_(i)) / 2).transpose();
+}
+
+void ParametrizedLine::Derivative(const Eigen::ArrayXd &t,
+                                  Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  // The derivative is constant
+  out = ((end_ - start_) / 2).replicate(1, t.size());
+}
+
+void ParametrizedLine::DoubleDerivative(const Eigen::ArrayXd &t,
+                                        Eigen::Matrix2Xd &out) const {
+  assert(IsWithinParameterRange(t));
+  out = Eigen::Matrix2Xd::Zero(2, t.size());
+}
+
 PanelVector ParametrizedLine::split(unsigned int N) const {
   // PanelVector for storing the part parametrizations
   PanelVector parametrization_parts;
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <cmath>
 #include <iostream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -21,54 +22,132 @@ namespace parametricbem2d {
 using CoefficientsList = typename ParametrizedPolynomial::CoefficientsList;
 
 ParametrizedPolynomial::ParametrizedPolynomial(CoefficientsList coeffs,
-                                               double tmin, double tmax)
-    : coeffs_(coeffs), tmin_(tmin), tmax_(tmax) {
-  assert(coeffs.cols() >= 3); // Asserting degree is at least 2
+                                               double tmin, double tmax,
+                                               Basis basis)
+    : ParametrizedPolynomial(std::make_shared<CoefficientsList>(coeffs), tmin,
+                             tmax, basis) {}
+
+ParametrizedPolynomial::ParametrizedPolynomial(
+    std::shared_ptr<const CoefficientsList> coeffs, double tmin, double tmax,
+    Basis basis)
+    : coeffs_(coeffs), tmin_(tmin), tmax_(tmax), basis_(basis) {
+  assert(coeffs_->cols() >= 3); // Asserting degree is at least 2
 }
 
 Eigen::Vector2d ParametrizedPolynomial::operator()(double t) const {
-  assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
-  // Number of terms in the polynomial
-  int N = coeffs_.cols();
-  // The output vector
-  Eigen::VectorXd point = Eigen::VectorXd::Zero(2);
-  // Filling the cosine and sine vectors
-  for (int i = 0; i < N; ++i) {
-    point += std::pow(t, i) * coeffs_.col(i);
-  }
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
   return point;
 }
 
 Eigen::Vector2d ParametrizedPolynomial::Derivative(double t) const {
-  assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
-  // Number of terms in the polynomial
-  int N = coeffs_.cols();
-  // The output vector
-  Eigen::VectorXd derivative = Eigen::VectorXd::Zero(2);
-  // Filling the cosine and sine vectors
-  for (int i = 1; i < N; ++i) {
-    derivative += i * std::pow(t, i - 1) * coeffs_.col(i);
-  }
-  return derivative * (tmax_ - tmin_) / 2;
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
+  return derivative;
 }
 
 Eigen::Vector2d ParametrizedPolynomial::DoubleDerivative(double t) const {
+  Eigen::Vector2d point, derivative, double_derivative;
+  EvaluateWithDerivatives(t, point, derivative, double_derivative);
+  return double_derivative;
+}
+
+void ParametrizedPolynomial::EvaluateWithDerivatives(
+    double t, Eigen::Vector2d &point, Eigen::Vector2d &derivative,
+    Eigen::Vector2d &double_derivative) const {
   assert(IsWithinParameterRange(t));
-  t = t * (tmax_ - tmin_) / 2 +
-      (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
+  // Derivative of the map from the standard interval to [tmin,tmax]
+  double scale = (tmax_ - tmin_) / 2;
+  t = t * scale + (tmax_ + tmin_) / 2; // converting to the range [tmin,tmax]
   // Number of terms in the polynomial
-  int N = coeffs_.cols();
-  // The output vector
-  Eigen::VectorXd double_derivative = Eigen::VectorXd::Zero(2);
-  // Filling the cosine and sine vectors
-  for (int i = 2; i < N; ++i) {
-    double_derivative += i * (i - 1) * std::pow(t, i - 2) * coeffs_.col(i);
+  int N = coeffs_->cols();
+  // Coefficients, stored column major: (x,y) of the n-th term at 2n
+  const double *c = coeffs_->data();
+  // Value, derivative and double derivative, accumulated in scalars
+  double x, y, dx, dy, ddx, ddy;
+  if (basis_ == Basis::Monomial) {
+    // Horner scheme for the polynomial and its derivatives, where ddx and ddy
+    // accumulate half of the double derivative
+    x = c[2 * (N - 1)];
+    y = c[2 * (N - 1) + 1];
+    dx = dy = ddx = ddy = 0;
+    for (int n = N - 2; n >= 0; --n) {
+      ddx = ddx * t + dx;
+      ddy = ddy * t + dy;
+      dx = dx * t + x;
+      dy = dy * t + y;
+      x = x * t + c[2 * n];
+      y = y * t + c[2 * n + 1];
+    }
+    ddx *= 2;
+    ddy *= 2;
+  } else {
+    // Clenshaw recurrence b_n = c_n + 2t b_{n+1} - b_{n+2} and its
+    // derivatives with respect to t. The values for n+1 and n+2 are kept.
+    double bx1 = 0, by1 = 0, bx2 = 0, by2 = 0;
+    double dbx1 = 0, dby1 = 0, dbx2 = 0, dby2 = 0;
+    double ddbx1 = 0, ddby1 = 0, ddbx2 = 0, ddby2 = 0;
+    for (int n = N - 1; n >= 1; --n) {
+      double ddbx = 4 * dbx1 + 2 * t * ddbx1 - ddbx2;
+      double ddby = 4 * dby1 + 2 * t * ddby1 - ddby2;
+      double dbx = 2 * bx1 + 2 * t * dbx1 - dbx2;
+      double dby = 2 * by1 + 2 * t * dby1 - dby2;
+      double bx = c[2 * n] + 2 * t * bx1 - bx2;
+      double by = c[2 * n + 1] + 2 * t * by1 - by2;
+      ddbx2 = ddbx1;
+      ddby2 = ddby1;
+      ddbx1 = ddbx;
+      ddby1 = ddby;
+      dbx2 = dbx1;
+      dby2 = dby1;
+      dbx1 = dbx;
+      dby1 = dby;
+      bx2 = bx1;
+      by2 = by1;
+      bx1 = bx;
+      by1 = by;
+    }
+    // Final step, using T_1(t) = t instead of 2t
+    x = c[0] + t * bx1 - bx2;
+    y = c[1] + t * by1 - by2;
+    dx = bx1 + t * dbx1 - dbx2;
+    dy = by1 + t * dby1 - dby2;
+    ddx = 2 * dbx1 + t * ddbx1 - ddbx2;
+    ddy = 2 * dby1 + t * ddby1 - ddby2;
+  }
+  point << x, y;
+  derivative << scale * dx, scale * dy;
+  double_derivative << scale * scale * ddx, scale * scale * ddy;
+}
+
+void ParametrizedPolynomial::Evaluate(const Eigen::ArrayXd &t,
+                                      Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = point;
+  }
+}
+
+void ParametrizedPolynomial::Derivative(const Eigen::ArrayXd &t,
+                                        Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = derivative;
+  }
+}
+
+void ParametrizedPolynomial::DoubleDerivative(const Eigen::ArrayXd &t,
+                                              Eigen::Matrix2Xd &out) const {
+  out.resize(2, t.size());
+  Eigen::Vector2d point, derivative, double_derivative;
+  for (unsigned k = 0; k < t.size(); ++k) {
+    EvaluateWithDerivatives(t(k), point, derivative, double_derivative);
+    out.col(k) = double_derivative;
   }
-  return double_derivative * (tmax_ - tmin_) / 2 * (tmax_ - tmin_) / 2;
 }
 
 PanelVector ParametrizedPolynomial::split(unsigned int N) const {
@@ -81,9 +160,10 @@ PanelVector ParametrizedPolynomial::split(unsigned int N) const {
     double tmax = tmin_ + (i + 1) * (tmax_ - tmin_) / N;
     if (i==N-1)
       tmax = tmax_;
-    // Adding the part parametrization to the vector with a shared pointer
-    parametrization_parts.push_back(
-        std::make_shared<ParametrizedPolynomial>(coeffs_, tmin, tmax));
+    // Adding the part parametrization to the vector with a shared pointer,
+    // the part refers to the coefficients of this parametrization
+    parametrization_parts.push_back(std::shared_ptr<ParametrizedPolynomial>(
+        new ParametrizedPolynomial(coeffs_, tmin, tmax, basis_)));
   }
   return parametrization_parts;
 }
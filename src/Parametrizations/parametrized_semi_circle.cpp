@@ -44,6 +44,31 @@ namespace parametricbem2d {
     return -M_PI*M_PI/4.*operator() (t);
   }
 
+  void ParametrizedSemiCircle::Evaluate(const Eigen::ArrayXd &t,
+                                        Eigen::Matrix2Xd &out) const {
+    assert(IsWithinParameterRange(t));
+    // Polar angles for all the parameters at once
+    Eigen::ArrayXd phi = M_PI*t/2.;
+    out.resize(2,t.size());
+    out.row(0) = (radius_*phi.cos()).transpose();
+    out.row(1) = (radius_*phi.sin()).transpose();
+  }
+
+  void ParametrizedSemiCircle::Derivative(const Eigen::ArrayXd &t,
+                                          Eigen::Matrix2Xd &out) const {
+    assert(IsWithinParameterRange(t));
+    Eigen::ArrayXd phi = M_PI*t/2.;
+    out.resize(2,t.size());
+    out.row(0) = (-radius_*M_PI*phi.sin()/2.).transpose();
+    out.row(1) = (M_PI*radius_*phi.cos()/2.).transpose();
+  }
+
+  void ParametrizedSemiCircle::DoubleDerivative(const Eigen::ArrayXd &t,
+                                                Eigen::Matrix2Xd &out) const {
+    Evaluate(t,out);
+    out *= -M_PI*M_PI/4.;
+  }
+
   PanelVector ParametrizedSemiCircle::split(unsigned int N) const {
     // PanelVector for storing the part parametrizations
     PanelVector parametrization_parts;
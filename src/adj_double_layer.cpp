@@ -31,12 +31,10 @@ Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &test_space,
                                const unsigned int &N) {
   // Getting the adjoint double layer matrix by calculating the double layer
-  // Galerkin matrix and transposing it
-  /*return parametricbem2d::double_layer::GalerkinMatrix(mesh, trial_space,
-                                                       test_space, N)
-      .transpose();*/
+  // Galerkin matrix with the roles of the spaces swapped and transposing it
   return parametricbem2d::double_layer::GalerkinMatrix(mesh, test_space,
-                                                       trial_space, N);
+                                                       trial_space, N)
+      .transpose();
 }
 
 } // namespace adj_double_layer
@@ -17,10 +17,16 @@
 
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
+#include "adaptive_quadrature.hpp"
 #include "discontinuous_space.hpp"
+#include "dof_map.hpp"
+#include "fast_multipole.hpp"
 #include "gauleg.hpp"
+#include "hierarchical_matrix.hpp"
 #include "integral_gauss.hpp"
 #include "logweight_quadrature.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -41,8 +47,62 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
            (pi(-1) - pi_p(1)).norm() / 100. < tol) // Adjacent Panels case
     return ComputeIntegralAdjacent(pi, pi_p, trial_space, test_space, GaussQR);
 
-  else // Disjoint panels case
-    return ComputeIntegralGeneral(pi, pi_p, trial_space, test_space, GaussQR);
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order = adaptive_quadrature::SelectOrder(pi, pi_p, GaussQR.n);
+    return ComputeIntegralGeneral(
+        pi, pi_p, trial_space, test_space,
+        order < GaussQR.n ? getGaussQR(order) : GaussQR);
+  }
+}
+
+Eigen::MatrixXd InteractionMatrix(const PanelGeometryCache &geometry,
+                                  unsigned int i, unsigned int j,
+                                  const AbstractBEMSpace &trial_space,
+                                  const AbstractBEMSpace &test_space,
+                                  const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  InteractionMatrix(geometry, i, j, TabulatedBEMSpace(trial_space, GaussQR),
+                    TabulatedBEMSpace(test_space, GaussQR), GaussQR,
+                    interaction_matrix);
+  return interaction_matrix;
+}
+
+void InteractionMatrix(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const TabulatedBEMSpace &trial_space,
+                       const TabulatedBEMSpace &test_space,
+                       const QuadRule &GaussQR,
+                       Eigen::MatrixXd &interaction_matrix) {
+  // Parametrizations for the panels i and j
+  const AbstractParametrizedCurve &pi = geometry.getPanel(i);
+  const AbstractParametrizedCurve &pi_p = geometry.getPanel(j);
+  // Relation of the panels, looked up in the topology of the mesh
+  PanelRelation relation = geometry.getTopology().getRelation(i, j);
+
+  if (relation == PanelRelation::Coinciding) // Same Panels case
+    interaction_matrix = ComputeIntegralCoinciding(
+        pi, pi_p, trial_space.getSpace(), test_space.getSpace(), GaussQR);
+
+  else if (relation == PanelRelation::Adjacent) // Adjacent Panels case
+    interaction_matrix = ComputeIntegralAdjacent(
+        pi, pi_p, trial_space.getSpace(), test_space.getSpace(), GaussQR);
+
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order =
+        adaptive_quadrature::SelectOrder(geometry, i, j, GaussQR.n);
+    // Using the geometry tabulated for the lower order
+    if (order < GaussQR.n)
+      ComputeIntegralGeneral(geometry.getLowerOrder(order), i, j,
+                             trial_space.getLowerOrder(order),
+                             test_space.getLowerOrder(order),
+                             getGaussQR(order), interaction_matrix);
+    else // Using the tabulated geometry
+      ComputeIntegralGeneral(geometry, i, j, trial_space, test_space, GaussQR,
+                             interaction_matrix);
+  }
 }
 
 Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
@@ -56,56 +116,57 @@ Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
   // The number of Reference Shape Functions in test space
   int Qtest = test_space.getQ();
 
-  // Interaction matrix with size Qtest x Qtrial
-  Eigen::MatrixXd interaction_matrix(Qtest, Qtrial);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Qtest; ++i) {
-    for (int j = 0; j < Qtrial; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:Kidp}\f$
-      auto F = [&](double t) {
-        return trial_space.evaluateShapeFunction(j, t) *
-               pi_p.Derivative(t).norm();
-      };
-
-      auto G = [&](double s) {
-        return test_space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
-
-      // Lambda expression for the integrand in \f$\eqref{eq:Kidp}\f$
-      auto integrand = [&](double s, double t) {
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        double k;
-        // Finding the tangent of pi_p to get its normal
-        Eigen::Vector2d tangent = pi_p.Derivative(t);
-        Eigen::Vector2d normal;
-        // Outward normal vector
-        normal << tangent(1), -tangent(0);
-        // Normalizing the normal vector
-        normal = normal / normal.norm();
-        if (fabs(s - t) > sqrt_epsilon) // Away from singularity
-          k = (pi(s) - pi_p(t)).dot(normal) / (pi(s) - pi_p(t)).squaredNorm();
-        else // Near singularity
-          // Limit evaluated analytically for s -> t
-          k = 0.5 * pi.DoubleDerivative(0.5 * (t + s)).dot(normal) /
-              pi.Derivative(0.5 * (t + s)).squaredNorm();
-
-        return k * F(t) * G(s);
-      };
-
-      double integral = 0;
+  // Tabulating the points, the normals of pi_p and the functions F and G in
+  // \f$\eqref{eq:Kidp}\f$ at the Gauss nodes, the kth column corresponds to
+  // the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N), normals(2, N);
+  Eigen::MatrixXd F(Qtrial, N), G(Qtest, N);
+  // Reference shape functions at the Gauss nodes
+  Eigen::ArrayXXd trial_shapes = trial_space.tabulateShapeFunctions(GaussQR);
+  Eigen::ArrayXXd test_shapes = test_space.tabulateShapeFunctions(GaussQR);
+  for (unsigned int k = 0; k < N; ++k) {
+    double t = GaussQR.x(k);
+    pi_nodes.col(k) = pi(t);
+    pi_p_nodes.col(k) = pi_p(t);
+    // Finding the tangent of pi_p to get its normal
+    Eigen::Vector2d tangent = pi_p.Derivative(t);
+    Eigen::Vector2d normal;
+    // Outward normal vector
+    normal << tangent(1), -tangent(0);
+    // Normalizing the normal vector
+    normals.col(k) = normal / normal.norm();
+    double pi_norm = pi.Derivative(t).norm();
+    double pi_p_norm = tangent.norm();
+    for (int q = 0; q < Qtrial; ++q)
+      F(q, k) = trial_shapes(q, k) * pi_p_norm;
+    for (int q = 0; q < Qtest; ++q)
+      G(q, k) = test_shapes(q, k) * pi_norm;
+  }
 
-      // Tensor product quadrature for double integral in \f$\eqref{eq:Kidp}\f$
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          integral += GaussQR.w(i) * GaussQR.w(j) *
-                      integrand(GaussQR.x(i), GaussQR.x(j));
-        }
-      }
-      // Filling the matrix entry
-      interaction_matrix(i, j) = 1. / (2. * M_PI) * integral;
+  // Interaction matrix with size Qtest x Qtrial
+  Eigen::MatrixXd interaction_matrix = Eigen::MatrixXd::Zero(Qtest, Qtrial);
+  // Tensor product quadrature for double integral in \f$\eqref{eq:Kidp}\f$.
+  // The kernel is evaluated once per pair of nodes for all the (I,J) entries.
+  double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double s = GaussQR.x(k);
+      double t = GaussQR.x(l);
+      double kernel;
+      if (fabs(s - t) > sqrt_epsilon) // Away from singularity
+        kernel = (pi_nodes.col(k) - pi_p_nodes.col(l)).dot(normals.col(l)) /
+                 (pi_nodes.col(k) - pi_p_nodes.col(l)).squaredNorm();
+      else // Near singularity
+        // Limit evaluated analytically for s -> t
+        kernel = 0.5 * pi.DoubleDerivative(0.5 * (t + s)).dot(normals.col(l)) /
+                 pi.Derivative(0.5 * (t + s)).squaredNorm();
+      kernel *= GaussQR.w(k) * GaussQR.w(l);
+      for (int I = 0; I < Qtest; ++I)
+        for (int J = 0; J < Qtrial; ++J)
+          interaction_matrix(I, J) += kernel * F(J, l) * G(I, k);
     }
   }
-  return interaction_matrix;
+  return 1. / (2. * M_PI) * interaction_matrix;
 }
 
 Eigen::MatrixXd ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
@@ -113,152 +174,114 @@ Eigen::MatrixXd ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
                                         const AbstractBEMSpace &trial_space,
                                         const AbstractBEMSpace &test_space,
                                         const QuadRule &GaussQR) {
-  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
   // The number of Reference Shape Functions in trial space
   int Qtrial = trial_space.getQ();
   // The number of Reference Shape Functions in test space
   int Qtest = test_space.getQ();
-  // Interaction matrix with size Qtest x Qtrial
-  Eigen::MatrixXd interaction_matrix(Qtest, Qtrial);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Qtest; ++i) {
-    for (int j = 0; j < Qtrial; ++j) {
-      // Panel lengths for local arclength parametrization in
-      // \f$\eqref{eq:ap}\f$. Actual values are not required so a length of 1 is
-      // used for both the panels
-
-      // when transforming the parametrizations from [-1,1]->\Pi to local
-      // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
-      // that the common point between the panels corresponds to the parameter 0
-      // in both arclength parametrizations
-      bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
-                  std::numeric_limits<double>::epsilon();
-
-      double length_pi =
-          2 * pi.Derivative(swap ? -1 : 1)
-                  .norm(); // Length for panel pi to ensure norm of arclength
-                           // parametrization is 1 at the common point
-      double length_pi_p =
-          2 * pi_p.Derivative(swap ? 1 : -1)
-                  .norm(); // Length for panel pi_p to ensure norm of arclength
-                           // parametrization is 1 at the common point
-      // Lambda expressions for functions F,G and the integrand in
-      // \f$\eqref{eq:Kitrf}\f$
-      auto F = [&](double t_pr) { // Function associated with panel pi_p
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        return trial_space.evaluateShapeFunction(j, t) *
-               pi_p.Derivative(t).norm();
-      };
+  // Panel lengths for local arclength parametrization in
+  // \f$\eqref{eq:ap}\f$. Actual values are not required so a length of 1 is
+  // used for both the panels
 
-      auto G = [&](double s_pr) { // Function associated with panel pi
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        return test_space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
+  // when transforming the parametrizations from [-1,1]->\Pi to local
+  // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
+  // that the common point between the panels corresponds to the parameter 0
+  // in both arclength parametrizations
+  bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
+              std::numeric_limits<double>::epsilon();
 
-      // Lambda expressions for the integrand in \f$\eqref{eq:Kitrf}\f$ in polar
-      // coordinates
-      auto integrand = [&](double r, double phi) {
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        // Transforming to local arclength parameter range
-        double s_pr = r * cos(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        // Transforming to local arclength parameter range
-        double t_pr = r * sin(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        // Getting the tangent vector to find the normal vector
-        Eigen::Vector2d tangent = pi_p.Derivative(t);
-        Eigen::Vector2d normal;
-        // Outward normal vector
-        normal << tangent(1), -tangent(0);
-        // Normalizing the normal vector
-        normal = normal / normal.norm();
-        if (r > sqrt_epsilon) // Away from singularity
-          // Stable evaluation according to \f$\eqref{eq:Vbstab}\f$
-          return r * (pi(s) - pi_p(t)).dot(normal) /
-                 (pi(s) - pi_p(t)).squaredNorm();
-        else { // near singularity
-          // Transforming 0 to standard parameter range [-1,1] using swap
-          double s0 = swap ? -1 : 1;
-          double t0 = swap ? 1 : -1;
-          // Using the analytic limit for r - > 0, \f$\eqref{eq:Nexp}\f$
-          Eigen::Vector2d b_r_phi =
-              (swap ? 1 : -1) *
-              (pi.Derivative(s0) * cos(phi) * 2 / length_pi +
-               pi_p.Derivative(t0) * sin(phi) * 2 / length_pi_p);
-          return b_r_phi.dot(normal) / b_r_phi.squaredNorm();
-        }
-      };
+  double length_pi =
+      2 * pi.Derivative(swap ? -1 : 1)
+              .norm(); // Length for panel pi to ensure norm of arclength
+                       // parametrization is 1 at the common point
+  double length_pi_p =
+      2 * pi_p.Derivative(swap ? 1 : -1)
+              .norm(); // Length for panel pi_p to ensure norm of arclength
+                       // parametrization is 1 at the common point
 
-      // The integral is split into two parts according to eq. 1.4.178
-      // part 1 is where phi goes from 0 to alpha
-      // part 2 is where phi goes from alpha to pi/2
-      double alpha = atan(length_pi_p / length_pi); // the split point
-
-      // i_J -> part J of the integral
-      double i1 = 0., i2 = 0.;
-      // part 1 (phi from 0 to alpha)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi (0 to alpha)
-        double phi = alpha / 2 * (1 + GaussQR.x(i));
-        // Computing inner integral with fixed phi
-        double inner = 0.; // inner integral
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi / cos(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Transforming Gauss quadrature node into r
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner += GaussQR.w(j) * integrand(r, phi) * F(r * sin(phi)) *
-                   G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r using Gauss quadrature nodes
-        inner *= rmax / 2;
-        // Multiplying the integral with appropriate constants for
-        // transformation to phi using Gauss quadrature nodes
-        i1 += GaussQR.w(i) * inner * alpha / 2;
-      }
+  // Values of the functions F and G in \f$\eqref{eq:Kitrf}\f$ for all the
+  // reference shape functions of the trial and test spaces respectively
+  Eigen::VectorXd F(Qtrial), G(Qtest);
+  // Lambda expression evaluating F and G at the local arclength parameters
+  // t_pr (panel pi_p) and s_pr (panel pi)
+  auto evaluateFG = [&](double t_pr, double s_pr) {
+    // Transforming the local arclength parameters to standard parameter
+    // range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    trial_space.evaluateShapeFunctions(t, F);
+    test_space.evaluateShapeFunctions(s, G);
+    F *= pi_p.Derivative(t).norm();
+    G *= pi.Derivative(s).norm();
+  };
 
-      // part 2 (phi from alpha to pi/2)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi (alpha to pi/2)
-        double phi =
-            GaussQR.x(i) * (M_PI / 2. - alpha) / 2. + (M_PI / 2. + alpha) / 2.;
-        double inner = 0.; // inner integral
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi_p / sin(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Transforming Gauss quadrature node into r
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner += GaussQR.w(j) * integrand(r, phi) * F(r * sin(phi)) *
-                   G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r using Gauss quadrature nodes
-        inner *= rmax / 2;
-        // Multiplying the integral with appropriate constants for
-        // transformation to phi using Gauss quadrature nodes
-        i2 += GaussQR.w(i) * inner * (M_PI / 2. - alpha) / 2.;
-      }
-      // Summing up the parts to get the final integral
-      double integral = i1 + i2;
-      // Multiplying the integral with appropriate constants for transformation
-      // to local arclength variables
-      integral *= 4 / length_pi / length_pi_p;
-      // Filling the matrix entry
-      interaction_matrix(i, j) = 1 / (2 * M_PI) * integral;
+  // Lambda expressions for the integrand in \f$\eqref{eq:Kitrf}\f$ in polar
+  // coordinates
+  auto integrand = [&](double r, double phi) {
+    double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+    // Transforming to local arclength parameter range
+    double s_pr = r * cos(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    // Transforming to local arclength parameter range
+    double t_pr = r * sin(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    // Getting the tangent vector to find the normal vector
+    Eigen::Vector2d tangent = pi_p.Derivative(t);
+    Eigen::Vector2d normal;
+    // Outward normal vector
+    normal << tangent(1), -tangent(0);
+    // Normalizing the normal vector
+    normal = normal / normal.norm();
+    if (r > sqrt_epsilon) // Away from singularity
+      // Stable evaluation according to \f$\eqref{eq:Vbstab}\f$
+      return r * (pi(s) - pi_p(t)).dot(normal) /
+             (pi(s) - pi_p(t)).squaredNorm();
+    else { // near singularity
+      // Transforming 0 to standard parameter range [-1,1] using swap
+      double s0 = swap ? -1 : 1;
+      double t0 = swap ? 1 : -1;
+      // Using the analytic limit for r - > 0, \f$\eqref{eq:Nexp}\f$
+      Eigen::Vector2d b_r_phi =
+          (swap ? 1 : -1) * (pi.Derivative(s0) * cos(phi) * 2 / length_pi +
+                             pi_p.Derivative(t0) * sin(phi) * 2 / length_pi_p);
+      return b_r_phi.dot(normal) / b_r_phi.squaredNorm();
     }
-  }
-  return interaction_matrix;
+  };
+
+  // The integral is split into two parts according to eq. 1.4.178
+  // part 1 is where phi goes from 0 to alpha
+  // part 2 is where phi goes from alpha to pi/2
+  double alpha = atan(length_pi_p / length_pi); // the split point
+
+  // The integral for all the pairs of reference shape functions
+  Eigen::MatrixXd integral = Eigen::MatrixXd::Zero(Qtest, Qtrial);
+  // Computing the integral for part 1 or part 2, with a single evaluation of
+  // the integrand, F and G per quadrature node
+  auto integrate_part = [&](bool part1) {
+    AccumulateIntegral(
+        [&](double phi, double w_phi) {
+          // Upper limit for inner 'r' integral
+          double rmax = part1 ? length_pi / cos(phi) : length_pi_p / sin(phi);
+          // Evaluating the inner 'r' integral with Gauss Legendre quadrature
+          AccumulateIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                double weight = w_phi * w_r * integrand(r, phi);
+                for (int I = 0; I < Qtest; ++I)
+                  for (int J = 0; J < Qtrial; ++J)
+                    integral(I, J) += weight * F(J) * G(I);
+              },
+              0, rmax, GaussQR);
+        },
+        part1 ? 0 : alpha, part1 ? alpha : M_PI / 2, GaussQR);
+  };
+  integrate_part(true);  // part 1 (phi from 0 to alpha)
+  integrate_part(false); // part 2 (phi from alpha to pi/2)
+
+  // Multiplying the integral with appropriate constants for transformation
+  // to local arclength variables
+  return 1 / (2 * M_PI) * 4 / length_pi / length_pi_p * integral;
 }
 
 Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
@@ -267,108 +290,148 @@ Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
                                        const AbstractBEMSpace &test_space,
                                        const QuadRule &GaussQR) {
   unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
-  // Calculating the quadrature order for stable evaluation of integrands for
-  // disjoint panels as mentioned in \f$\ref{par:distpan}\f$
-  unsigned n0 = 9; // Order for admissible cases
-  // Admissibility criteria
-  double eta = 0.5;
-  // Calculating the quadrature order
-  // N = n0 * std::max(1., 1. + 51 * log(rho(pi, pi_p) / eta));
-  // QuadRule GaussQR = getGaussQR(N);
-  // std::cout << "ComputeIntegralGeneral used with order " << N << std::endl;
+  // The quadrature order for stable evaluation of integrands for disjoint
+  // panels as mentioned in \f$\ref{par:distpan}\f$ is chosen by the caller,
+  // see adaptive_quadrature::SelectOrder()
   // The number of Reference Shape Functions in space
   int Qtrial = trial_space.getQ();
   // The number of Reference Shape Functions in space
   int Qtest = test_space.getQ();
+
+  // Tabulating the points, the normals of pi_p and the functions F and G in
+  // \f$\eqref{eq:titg}\f$ for Double Layer BIO at the Gauss nodes, the kth
+  // column corresponds to the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N), normals(2, N);
+  Eigen::MatrixXd F(Qtrial, N), G(Qtest, N);
+  // Reference shape functions at the Gauss nodes
+  Eigen::ArrayXXd trial_shapes = trial_space.tabulateShapeFunctions(GaussQR);
+  Eigen::ArrayXXd test_shapes = test_space.tabulateShapeFunctions(GaussQR);
+  for (unsigned int k = 0; k < N; ++k) {
+    double t = GaussQR.x(k);
+    pi_nodes.col(k) = pi(t);
+    pi_p_nodes.col(k) = pi_p(t);
+    // Finding the tangent of pi_p to get its normal
+    Eigen::Vector2d tangent = pi_p.Derivative(t);
+    Eigen::Vector2d normal;
+    // Outward normal vector
+    normal << tangent(1), -tangent(0);
+    // Normalizing the normal vector
+    normals.col(k) = normal / normal.norm();
+    double pi_norm = pi.Derivative(t).norm();
+    double pi_p_norm = tangent.norm();
+    for (int q = 0; q < Qtrial; ++q)
+      F(q, k) = trial_shapes(q, k) * pi_p_norm;
+    for (int q = 0; q < Qtest; ++q)
+      G(q, k) = test_shapes(q, k) * pi_norm;
+  }
+
   // Interaction matrix with size Qtest x Qtrial
-  Eigen::MatrixXd interaction_matrix(Qtest, Qtrial);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Qtest; ++i) {
-    for (int j = 0; j < Qtrial; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:titg}\f$ for
-      // Double Layer BIO
-      auto F = [&](double t) { // Function associated with panel pi_p
-        return trial_space.evaluateShapeFunction(j, t) *
-               pi_p.Derivative(t).norm();
-      };
+  Eigen::MatrixXd interaction_matrix = Eigen::MatrixXd::Zero(Qtest, Qtrial);
+  // Tensor product quadrature for double integral, evaluating \f$\hat{K}\f$
+  // in \f$\eqref{eq:titg}\f$ once per pair of nodes for all the (I,J) entries
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      Eigen::Vector2d diff = pi_nodes.col(k) - pi_p_nodes.col(l);
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      diff.dot(normals.col(l)) / diff.squaredNorm();
+      for (int I = 0; I < Qtest; ++I)
+        for (int J = 0; J < Qtrial; ++J)
+          interaction_matrix(I, J) += kernel * F(J, l) * G(I, k);
+    }
+  }
+  return 1 / (2 * M_PI) * interaction_matrix;
+}
 
-      auto G = [&](double s) { // Function associated with panel pi
-        return test_space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
-      // Lambda expression for \f$\hat{K}\f$ in \f$\eqref{eq:titg}\f$ for double
-      // Layer BIO
-      auto integrand = [&](double s, double t) {
-        // Finding the tangent of pi_p to get its normal
-        Eigen::Vector2d tangent = pi_p.Derivative(t);
-        Eigen::Vector2d normal;
-        // Outward normal vector
-        normal << tangent(1), -tangent(0);
-        // Normalizing the normal vector
-        normal = normal / normal.norm();
-        return (pi(s) - pi_p(t)).dot(normal) / (pi(s) - pi_p(t)).squaredNorm();
-      };
+Eigen::MatrixXd ComputeIntegralGeneral(const PanelGeometryCache &geometry,
+                                       unsigned int i, unsigned int j,
+                                       const AbstractBEMSpace &trial_space,
+                                       const AbstractBEMSpace &test_space,
+                                       const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  ComputeIntegralGeneral(geometry, i, j,
+                         TabulatedBEMSpace(trial_space, GaussQR),
+                         TabulatedBEMSpace(test_space, GaussQR), GaussQR,
+                         interaction_matrix);
+  return interaction_matrix;
+}
 
-      double integral = 0.;
-
-      // Getting quadrature weights and points
-      Eigen::RowVectorXd weights, points;
-      std::tie(points, weights) =
-          gauleg(-1, 1, N, std::numeric_limits<double>::epsilon());
-
-      // Tensor product quadrature for double integral
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          double s = GaussQR.x(i);
-          double t = GaussQR.x(j);
-          integral +=
-              GaussQR.w(i) * GaussQR.w(j) * integrand(s, t) * F(t) * G(s);
-        }
+void ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                            unsigned int j,
+                            const TabulatedBEMSpace &trial_space,
+                            const TabulatedBEMSpace &test_space,
+                            const QuadRule &GaussQR,
+                            Eigen::MatrixXd &interaction_matrix) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
+  assert(geometry.getNumNodes() == N);
+  // Tabulated points and derivative norms of the panels pi (i) and pi_p (j)
+  PanelGeometryCache::ConstPointsView pi = geometry.getPoints(i);
+  PanelGeometryCache::ConstPointsView pi_p = geometry.getPoints(j);
+  PanelGeometryCache::ConstValuesView pi_norms = geometry.getDerivativeNorms(i);
+  PanelGeometryCache::ConstValuesView pi_p_norms =
+      geometry.getDerivativeNorms(j);
+  // Tabulated outward unit normals of the panel pi_p
+  PanelGeometryCache::ConstPointsView normals = geometry.getNormals(j);
+  // The number of Reference Shape Functions in trial and test spaces
+  int Qtrial = trial_space.getQ();
+  int Qtest = test_space.getQ();
+  // Reference shape functions of the trial and test spaces at the Gauss nodes
+  const Eigen::ArrayXXd &trial_shapes = trial_space.getValues();
+  const Eigen::ArrayXXd &test_shapes = test_space.getValues();
+  // Interaction matrix with size Qtest x Qtrial, keeping the storage of the
+  // argument
+  interaction_matrix.setZero(Qtest, Qtrial);
+  // Tensor product quadrature rule, k and l index the nodes on pi and pi_p.
+  // The kernel is evaluated once per pair of nodes for all the (I,J) entries.
+  // The functions F and G in \f$\eqref{eq:titg}\f$ are evaluated on the fly
+  // from the tabulated shape functions, without temporary tables.
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      // \f$\hat{K}\f$ in \f$\eqref{eq:titg}\f$ for double Layer BIO
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      (pi.col(k) - pi_p.col(l)).dot(normals.col(l)) /
+                      (pi.col(k) - pi_p.col(l)).squaredNorm();
+      double pi_norm = pi_norms(k), pi_p_norm = pi_p_norms(l);
+      for (int I = 0; I < Qtest; ++I) {
+        double G = test_shapes(I, k) * pi_norm;
+        for (int J = 0; J < Qtrial; ++J)
+          interaction_matrix(I, J) +=
+              kernel * (trial_shapes(J, l) * pi_p_norm) * G;
       }
-      // Filling the matrix entry
-      interaction_matrix(i, j) = 1 / (2 * M_PI) * integral;
     }
   }
-  return interaction_matrix;
+  interaction_matrix *= 1 / (2 * M_PI);
 }
 
 Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &trial_space,
                                const AbstractBEMSpace &test_space,
                                const unsigned int &N) {
-  // Getting number of panels in the mesh
-  unsigned int numpanels = mesh.getNumPanels();
-  // Getting dimensions for trial and test spaces
-  unsigned int rows = test_space.getSpaceDim(numpanels);
-  unsigned int cols = trial_space.getSpaceDim(numpanels);
-  // Getting the panels from the mesh
-  PanelVector panels = mesh.getPanels();
-  // Getting the number of local shape functions in the trial and test spaces
-  unsigned int Qtest = test_space.getQ();
-  unsigned int Qtrial = trial_space.getQ();
-  // Initializing the Galerkin matrix with zeros
-  Eigen::MatrixXd output = Eigen::MatrixXd::Zero(rows, cols);
-  // Panel oriented assembly \f$\ref{pc:ass}\f$
-  QuadRule LogWeightQR = getLogWeightQR(1, N);
-  QuadRule GaussQR = getGaussQR(N);
-  for (unsigned int i = 0; i < numpanels; ++i) {
-    for (unsigned int j = 0; j < numpanels; ++j) {
-      // Getting the interaction matrix for the pair of panels i and j
-      Eigen::MatrixXd interaction_matrix = InteractionMatrix(
-          *panels[i], *panels[j], trial_space, test_space, GaussQR);
-      // Local to global mapping of the elements in interaction matrix
-      for (unsigned int I = 0; I < Qtest; ++I) {
-        for (unsigned int J = 0; J < Qtrial; ++J) {
-          // int II = test_space.LocGlobMap(I + 1, i + 1, numpanels) - 1;
-          // int JJ = trial_space.LocGlobMap(J + 1, j + 1, numpanels) - 1;
-          int II = test_space.LocGlobMap2(I + 1, i + 1, mesh) - 1;
-          int JJ = trial_space.LocGlobMap2(J + 1, j + 1, mesh) - 1;
-          // Filling the Galerkin matrix entries
-          output(II, JJ) += interaction_matrix(I, J);
-        }
-      }
-    }
-  }
-  return output;
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return GalerkinMatrix(mesh, geometry, trial_space, test_space, GaussQR);
+}
+
+Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh &mesh,
+                               const PanelGeometryCache &geometry,
+                               const AbstractBEMSpace &trial_space,
+                               const AbstractBEMSpace &test_space,
+                               const QuadRule &GaussQR) {
+  // Tabulating the local to global maps of the spaces
+  DofMap trial_dofs(trial_space, mesh);
+  DofMap test_dofs(test_space, mesh);
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace trial_shapes(trial_space, GaussQR);
+  TabulatedBEMSpace test_shapes(test_space, GaussQR);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$, distributed over threads
+  return parallel_assembly::AssembleGalerkinMatrix(
+      mesh, trial_dofs, test_dofs,
+      [&](unsigned int i, unsigned int j,
+          Eigen::MatrixXd &interaction_matrix) {
+        // Interaction matrix for the pair of panels i and j
+        InteractionMatrix(geometry, i, j, trial_shapes, test_shapes, GaussQR,
+                          interaction_matrix);
+      });
 }
 
 double Potential(const Eigen::Vector2d &x, const Eigen::VectorXd &coeffs,
@@ -376,46 +439,203 @@ double Potential(const Eigen::Vector2d &x, const Eigen::VectorXd &coeffs,
                  const unsigned int &N) {
   // Getting the number of panels in the mesh
   unsigned int numpanels = mesh.getNumPanels();
-  // Getting dimensions of BEM space
-  unsigned int dims = space.getSpaceDim(numpanels);
   // asserting that the space dimension matches with coefficients
-  assert(coeffs.rows() == dims);
+  assert(coeffs.rows() == space.getSpaceDim(numpanels));
   // Getting the panels from the mesh
-  PanelVector panels = mesh.getPanels();
+  const PanelVector &panels = mesh.getPanels();
   // Getting the number of local shape functions in the BEM space
   unsigned int Q = space.getQ();
-  // Getting general Gauss Quadrature rule
-  QuadRule GaussQR = getGaussQR(N);
-  // Initializing the double layer potential vector for the bases, with zeros
-  Eigen::VectorXd potentials = Eigen::VectorXd::Zero(dims);
-  // Looping over all the panels
-  for (unsigned panel = 0; panel < numpanels; ++panel) {
-    // Looping over all reference shape functions
-    for (unsigned i = 0; i < Q; ++i) {
-      // The local integrand for a panel and a reference shape function
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Local coefficients on a panel and values of the reference shape functions
+  Eigen::VectorXd local(Q), shapes(Q);
+  double potential = 0.;
+  // Looping over all the panels, without tabulating the geometry
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    const AbstractParametrizedCurve &panel = *panels[i];
+    for (unsigned int I = 0; I < Q; ++I)
+      local(I) = coeffs(space.LocGlobMap2(I + 1, i + 1, mesh) - 1);
+    auto integrand = [&](double t, const Eigen::Vector2d &y,
+                         const Eigen::Vector2d &tangent) {
+      space.evaluateShapeFunctions(t, shapes);
+      Eigen::Vector2d normal;
+      // Outward normal vector
+      normal << tangent(1), -tangent(0);
+      // Normalizing the normal vector
+      normal /= normal.norm();
+      // Double Layer Potential
+      return 1. / 2. / M_PI * (x - y).dot(normal) / (x - y).squaredNorm() *
+             local.dot(shapes) * tangent.norm();
+    };
+    // Gauss rule on the panel, which is subdivided if it is close to x as in
+    // PotentialNearFieldCorrection()
+    potential +=
+        adaptive_quadrature::IntegrateOverPanel(panel, x, integrand, GaussQR);
+  }
+  return potential;
+}
+
+Eigen::VectorXd PotentialNearFieldCorrection(const Eigen::Matrix2Xd &points,
+                                             const Eigen::VectorXd &coeffs,
+                                             const ParametrizedMesh &mesh,
+                                             const PanelGeometryCache &geometry,
+                                             const AbstractBEMSpace &space,
+                                             const QuadRule &GaussQR) {
+  unsigned int N = GaussQR.n;
+  // Number of local shape functions in the BEM space
+  unsigned int Q = space.getQ();
+  Eigen::ArrayXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  // Panels which are too close to the points for the Gauss rule
+  std::vector<std::vector<unsigned int>> near =
+      geometry.findNearPanels(points, adaptive_quadrature::POTENTIAL_RHO);
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  Eigen::VectorXd corrections = Eigen::VectorXd::Zero(points.cols());
+  parallel_assembly::ParallelFor(0, points.cols(), [&](unsigned int k) {
+    Eigen::Vector2d x = points.col(k);
+    for (unsigned int i : near[k]) {
+      const AbstractParametrizedCurve &panel = geometry.getPanel(i);
+      // Local coefficients on the panel
+      Eigen::VectorXd local(Q);
+      for (unsigned int I = 0; I < Q; ++I)
+        local(I) = coeffs(dofs(I, i));
+      // Values of the reference shape functions in the integrand
+      Eigen::VectorXd shapes(Q);
       auto integrand = [&](double t) {
-        Eigen::Vector2d y = panels[panel]->operator()(t);
-        Eigen::Vector2d tangent = panels[panel]->Derivative(t);
+        space.evaluateShapeFunctions(t, shapes);
+        double phi = local.dot(shapes);
+        Eigen::Vector2d y = panel(t);
+        Eigen::Vector2d tangent = panel.Derivative(t);
         Eigen::Vector2d normal;
         // Outward normal vector
         normal << tangent(1), -tangent(0);
         // Normalizing the normal vector
         normal /= normal.norm();
-        double dotprod = (x - y).dot(normal) / (x - y).squaredNorm();
         // Double Layer Potential
-        return 1. / 2. / M_PI * dotprod * space.evaluateShapeFunction(i, t) *
-               tangent.norm();
+        return 1. / 2. / M_PI * (x - y).dot(normal) / (x - y).squaredNorm() *
+               phi * tangent.norm();
       };
-      // Local to global mapping
-      double local = ComputeIntegral(integrand, -1, 1, GaussQR);
-      // unsigned ii = space.LocGlobMap(i + 1, panel + 1, numpanels) - 1;
-      unsigned ii = space.LocGlobMap2(i + 1, panel + 1, mesh) - 1;
-      // Filling the potentials vector
-      potentials(ii) += local;
+      // Gauss rule on the panel, as in the evaluation for all the panels
+      Eigen::ArrayXd dx =
+          x(0) - geometry.getPoints(i).row(0).transpose().array();
+      Eigen::ArrayXd dy =
+          x(1) - geometry.getPoints(i).row(1).transpose().array();
+      Eigen::ArrayXd normals_x = geometry.getNormals(i).row(0).transpose();
+      Eigen::ArrayXd normals_y = geometry.getNormals(i).row(1).transpose();
+      double fixed = 1. / 2. / M_PI *
+                     (density.segment(i * N, N) *
+                      (dx * normals_x + dy * normals_y) /
+                      (dx.square() + dy.square()))
+                         .sum();
+      corrections(k) +=
+          adaptive_quadrature::IntegrateNearPoint(panel, x, integrand,
+                                                  GaussQR) -
+          fixed;
     }
-  }
-  // Dot product with coefficients to get the final double layer potential
-  return coeffs.dot(potentials);
+  });
+  return corrections;
+}
+
+Eigen::VectorXd Potentials(const Eigen::Matrix2Xd &points,
+                           const Eigen::VectorXd &coeffs,
+                           const ParametrizedMesh &mesh,
+                           const AbstractBEMSpace &space,
+                           const unsigned int &N) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the quadrature nodes, normals and the weighted density once
+  PanelGeometryCache geometry(mesh, GaussQR);
+  Eigen::ArrayXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  Eigen::ArrayXd nodes_x = geometry.getPoints().row(0).transpose();
+  Eigen::ArrayXd nodes_y = geometry.getPoints().row(1).transpose();
+  Eigen::ArrayXd normals_x = geometry.getNormals().row(0).transpose();
+  Eigen::ArrayXd normals_y = geometry.getNormals().row(1).transpose();
+  Eigen::VectorXd potentials(points.cols());
+  parallel_assembly::ParallelFor(0, points.cols(), [&](unsigned int k) {
+    Eigen::ArrayXd dx = points(0, k) - nodes_x;
+    Eigen::ArrayXd dy = points(1, k) - nodes_y;
+    // Double Layer Potential
+    potentials(k) = 1. / 2. / M_PI *
+                    (density * (dx * normals_x + dy * normals_y) /
+                     (dx.square() + dy.square()))
+                        .sum();
+  });
+  // Subdividing the panels close to the points
+  return potentials + PotentialNearFieldCorrection(points, coeffs, mesh,
+                                                   geometry, space, GaussQR);
+}
+
+Eigen::VectorXd FastMultipolePotential(const Eigen::Matrix2Xd &points,
+                                       const Eigen::VectorXd &coeffs,
+                                       const ParametrizedMesh &mesh,
+                                       const AbstractBEMSpace &space,
+                                       const unsigned int &N,
+                                       const FastMultipoleOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the quadrature nodes, normals and the weighted density once
+  PanelGeometryCache geometry(mesh, GaussQR);
+  Eigen::VectorXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  // Dipoles along the normals at the quadrature nodes
+  LaplaceFMM fmm(geometry.getPoints(), points, options);
+  Eigen::VectorXd potentials =
+      1. / 2. / M_PI *
+      fmm.Evaluate(Eigen::VectorXd(),
+                   geometry.getNormals() * density.asDiagonal());
+  // Subdividing the panels close to the points
+  return potentials + PotentialNearFieldCorrection(points, coeffs, mesh,
+                                                   geometry, space, GaussQR);
+}
+
+HierarchicalMatrix
+HierarchicalGalerkinMatrix(const ParametrizedMesh &mesh,
+                           const AbstractBEMSpace &trial_space,
+                           const AbstractBEMSpace &test_space,
+                           const unsigned int &N,
+                           const HierarchicalMatrixOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace trial_shapes(trial_space, GaussQR);
+  TabulatedBEMSpace test_shapes(test_space, GaussQR);
+  return HierarchicalMatrix(
+      mesh, geometry, trial_space, test_space,
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the pair of panels i and j
+        Eigen::MatrixXd interaction_matrix;
+        InteractionMatrix(geometry, i, j, trial_shapes, test_shapes, GaussQR,
+                          interaction_matrix);
+        return interaction_matrix;
+      },
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the disjoint panels i and j
+        Eigen::MatrixXd interaction_matrix;
+        ComputeIntegralGeneral(geometry, i, j, trial_shapes, test_shapes,
+                               GaussQR, interaction_matrix);
+        return interaction_matrix;
+      },
+      options);
+}
+
+FastMultipoleOperator
+FastMultipoleGalerkinOperator(const ParametrizedMesh &mesh,
+                              const AbstractBEMSpace &trial_space,
+                              const AbstractBEMSpace &test_space,
+                              const unsigned int &N,
+                              const FastMultipoleOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return FastMultipoleOperator(
+      mesh, geometry, trial_space, test_space, GaussQR,
+      FastMultipoleOperator::Kernel::DoubleLayer,
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the pair of panels i and j
+        return InteractionMatrix(geometry, i, j, trial_space, test_space,
+                                 GaussQR);
+      },
+      options);
 }
 
 } // namespace double_layer
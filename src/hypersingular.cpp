@@ -13,14 +13,20 @@
 
 #include <limits>
 #include <math.h>
+#include <utility>
 #include <vector>
 
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
+#include "adaptive_quadrature.hpp"
 #include "discontinuous_space.hpp"
+#include "dof_map.hpp"
 #include "gauleg.hpp"
 #include "integral_gauss.hpp"
 #include "logweight_quadrature.hpp"
+#include "packed_symmetric_matrix.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -39,8 +45,57 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
            (pi(-1) - pi_p(1)).norm() / 100. < tol) // Adjacent Panels case
     return ComputeIntegralAdjacent(pi, pi_p, space, GaussQR);
 
-  else // Disjoint panels case
-    return ComputeIntegralGeneral(pi, pi_p, space, GaussQR);
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order = adaptive_quadrature::SelectOrder(pi, pi_p, GaussQR.n);
+    return ComputeIntegralGeneral(
+        pi, pi_p, space, order < GaussQR.n ? getGaussQR(order) : GaussQR);
+  }
+}
+
+Eigen::MatrixXd InteractionMatrix(const PanelGeometryCache &geometry,
+                                  unsigned int i, unsigned int j,
+                                  const AbstractBEMSpace &space,
+                                  const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  InteractionMatrix(geometry, i, j, TabulatedBEMSpace(space, GaussQR), GaussQR,
+                    interaction_matrix);
+  return interaction_matrix;
+}
+
+void InteractionMatrix(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const TabulatedBEMSpace &space,
+                       const QuadRule &GaussQR,
+                       Eigen::MatrixXd &interaction_matrix) {
+  // Parametrizations for the panels i and j
+  const AbstractParametrizedCurve &pi = geometry.getPanel(i);
+  const AbstractParametrizedCurve &pi_p = geometry.getPanel(j);
+  // Relation of the panels, looked up in the topology of the mesh
+  PanelRelation relation = geometry.getTopology().getRelation(i, j);
+
+  if (relation == PanelRelation::Coinciding) // Same Panels case
+    interaction_matrix =
+        ComputeIntegralCoinciding(pi, pi_p, space.getSpace(), GaussQR);
+
+  else if (relation == PanelRelation::Adjacent) // Adjacent Panels case
+    interaction_matrix =
+        ComputeIntegralAdjacent(pi, pi_p, space.getSpace(), GaussQR);
+
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order =
+        adaptive_quadrature::SelectOrder(geometry, i, j, GaussQR.n);
+    // Using the geometry tabulated for the lower order
+    if (order < GaussQR.n)
+      ComputeIntegralGeneral(geometry.getLowerOrder(order), i, j,
+                             space.getLowerOrder(order), getGaussQR(order),
+                             interaction_matrix);
+    else // Using the tabulated geometry
+      ComputeIntegralGeneral(geometry, i, j, space, GaussQR,
+                             interaction_matrix);
+  }
 }
 
 Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
@@ -49,312 +104,744 @@ Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
                                           const QuadRule &GaussQR) {
   unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
                           // to be used for log weighted quadrature
-                          // std::cout << "Coinciding" << std::endl;
   int Q = space.getQ(); // No. of Reference Shape Functions in trial/test space
-  // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:Vidp}\f$
-      auto F = [&](double t) { // Function associated with panel pi_p
-        return space.evaluateShapeFunctionDot(j, t);
-      };
-
-      auto G = [&](double s) { // Function associated with panel pi
-        return space.evaluateShapeFunctionDot(i, s);
-      };
-
-      // Lambda expression for the 1st integrand in \f$\eqref{eq:Isplit}\f$
-      auto integrand1 = [&](double s, double t) {
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        double s_st;
-        if (fabs(s - t) > sqrt_epsilon) // Away from singularity
-          // Simply evaluating the expression
-          s_st = (pi(s) - pi_p(t)).squaredNorm() / (s - t) / (s - t);
-        else // Near singularity
-          // Using analytic limit for s - > t given in \f$\eqref{eq:Sdef}\f$
-          s_st = pi.Derivative(0.5 * (t + s)).squaredNorm();
-        return 0.5 * log(s_st) * F(t) * G(s);
-      };
-
-      double i1 = 0., i2 = 0.; // The two integrals in \f$\eqref{eq:Isplit}\f$
-
-      // Tensor product quadrature for double 1st integral in
-      // \f$\eqref{eq:Isplit}\f$
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          i1 += GaussQR.w(i) * GaussQR.w(j) *
-                integrand1(GaussQR.x(i), GaussQR.x(j));
-        }
-      }
+  // Lambda expression for the values of the functions F and G in
+  // \f$\eqref{eq:Vidp}\f$ for all the reference shape functions. Both are
+  // given by the derivatives of the reference shape functions.
+  auto evaluate = [&](double t, Eigen::Ref<Eigen::VectorXd> values) {
+    space.evaluateShapeFunctionDots(t, values);
+  };
+  // Tabulating the points and the values of F and G at the Gauss nodes, the
+  // kth column corresponds to the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd FG_nodes(Q, N);
+  for (unsigned int k = 0; k < N; ++k) {
+    pi_nodes.col(k) = pi(GaussQR.x(k));
+    pi_p_nodes.col(k) = pi_p(GaussQR.x(k));
+    evaluate(GaussQR.x(k), FG_nodes.col(k));
+  }
 
-      // Lambda expression for inner integrand in transformed coordinates in
-      // \f$\eqref{eq:I21}\f$
-      auto integrand2 = [&](double w, double z) {
-        return F(0.5 * (w - z)) * G(0.5 * (w + z)) +
-               F(0.5 * (w + z)) * G(0.5 * (w - z));
-      };
-
-      // Integral of integrand2 above w.r.t. w, as a function of z
-      auto inner2_z = [&](double z) {
-        // Integrand 2 as a function of w only (fixed z), to integrate w.r.t. w
-        auto integrand2_w = [&](double w) { return integrand2(w, z); };
-        // Computing the integral w.r.t. w
-        return ComputeIntegral(integrand2_w, -2 + z, 2 - z, GaussQR);
-      };
-      // i2 = ComputeLogwtIntegral(inner2_z, 2,GaussQR);
-      i2 = ComputeLoogIntegral(inner2_z, 2, GaussQR);
-      // Filling the matrix entry
-      interaction_matrix(i, j) = -1. / (2. * M_PI) * (i1 + 0.5 * i2);
+  // The two integrals in \f$\eqref{eq:Isplit}\f$ for all the pairs of
+  // reference shape functions, computed in a single quadrature sweep
+  Eigen::MatrixXd i1 = Eigen::MatrixXd::Zero(Q, Q);
+  Eigen::MatrixXd i2 = Eigen::MatrixXd::Zero(Q, Q);
+
+  // Tensor product quadrature for double 1st integral in
+  // \f$\eqref{eq:Isplit}\f$. The kernel is evaluated once per pair of nodes.
+  double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double s = GaussQR.x(k);
+      double t = GaussQR.x(l);
+      double s_st;
+      if (fabs(s - t) > sqrt_epsilon) // Away from singularity
+        // Simply evaluating the expression
+        s_st = (pi_nodes.col(k) - pi_p_nodes.col(l)).squaredNorm() / (s - t) /
+               (s - t);
+      else // Near singularity
+        // Using analytic limit for s - > t given in \f$\eqref{eq:Sdef}\f$
+        s_st = pi.Derivative(0.5 * (t + s)).squaredNorm();
+      double kernel = GaussQR.w(k) * GaussQR.w(l) * 0.5 * log(s_st);
+      for (int I = 0; I < Q; ++I)
+        for (int J = 0; J < Q; ++J)
+          i1(I, J) += kernel * FG_nodes(J, l) * FG_nodes(I, k);
     }
   }
-  return interaction_matrix;
+
+  // Values of F and G at the points 0.5(w-z) and 0.5(w+z) of the integrand in
+  // transformed coordinates in \f$\eqref{eq:I21}\f$
+  Eigen::VectorXd FG_minus(Q), FG_plus(Q);
+  // Calculating the second integral by log weighted quadrature in z of the
+  // Gauss Legendre quadrature in w
+  AccumulateLoogIntegral(
+      [&](double z, double w_z) {
+        AccumulateIntegral(
+            [&](double w, double w_w) {
+              evaluate(0.5 * (w - z), FG_minus);
+              evaluate(0.5 * (w + z), FG_plus);
+              double weight = w_z * w_w;
+              for (int I = 0; I < Q; ++I)
+                for (int J = 0; J < Q; ++J)
+                  i2(I, J) += weight * (FG_minus(J) * FG_plus(I) +
+                                        FG_plus(J) * FG_minus(I));
+            },
+            -2 + z, 2 - z, GaussQR);
+      },
+      2, GaussQR);
+  return -1. / (2. * M_PI) * (i1 + 0.5 * i2);
 }
 
 Eigen::MatrixXd ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
                                         const AbstractParametrizedCurve &pi_p,
                                         const AbstractBEMSpace &space,
                                         const QuadRule &GaussQR) {
-  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
-                          // to be used for log weighted quadrature
-                          // std::cout << "adjacent" << std::endl;
   int Q = space.getQ(); // No. of Reference Shape Functions in trial/test space
-  // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // when transforming the parametrizations from [-1,1]->\Pi to local
-      // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
-      // that the common point between the panels corresponds to the parameter 0
-      // in both arclength parametrizations
-      bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
-                  std::numeric_limits<double>::epsilon();
-
-      double length_pi =
-          2 * pi.Derivative(swap ? -1 : 1)
-                  .norm(); // Length for panel pi to ensure norm of arclength
-                           // parametrization is 1 at the common point
-      double length_pi_p =
-          2 * pi_p.Derivative(swap ? 1 : -1)
-                  .norm(); // Length for panel pi_p to ensure norm of arclength
-                           // parametrization is 1 at the common point
-
-      // Lambda expressions for the functions F,G and D(r,phi) in
-      // \f$\eqref{eq:Isplitapn}\f$
-      auto F = [&](double t_pr) { // Function associated with panel pi_p
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        return space.evaluateShapeFunctionDot(j, t);
-      };
-
-      auto G = [&](double s_pr) { // Function associated with panel pi
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        return space.evaluateShapeFunctionDot(i, s);
-      };
-
-      auto D_r_phi = [&](double r, double phi) { // \f$\eqref{eq:Ddef}\f$
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        // Transforming to local arclength parameter range
-        double s_pr = r * cos(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        // Transforming to local arclength parameter range
-        double t_pr = r * sin(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        if (r > sqrt_epsilon) // Away from singularity, simply use the formula
-          return (pi(s) - pi_p(t)).squaredNorm() / r / r;
-        else // Near singularity, use analytically evaluated limit for r -> 0
-          return 1 + sin(2 * phi) * pi.Derivative(s).dot(pi_p.Derivative(t)) *
-                         4 / length_pi / length_pi_p;
-      };
-
-      // The two integrals in \f$\eqref{eq:Isplitapn}\f$ have to be further
-      // split into two parts part 1 is where phi goes from 0 to alpha part 2 is
-      // where phi goes from alpha to pi/2
-      double alpha = atan(length_pi_p / length_pi); // the split point
-
-      // Integrand for the second double integral in equation
-      // \f$\eqref{eq:Isplitapn}\f$, without the log weight
-      auto integrand2 = [&](double r, double phi) {
-        return r * F(r * sin(phi)) * G(r * cos(phi));
-      };
-
-      // Part 1 of second double integral, integrated only in r, as a function
-      // of phi (phi from 0 to alpha)
-      auto inner21 = [&](double phi) {
-        // Integrand as a function of r only (fixed phi), to calculate the inner
-        // integral
-        auto in = [&](double r) { return integrand2(r, phi); };
-        // Integrating the inner integral in r using log weighted quadrature
-        // return ComputeLogwtIntegral(in,length_pi/cos(phi),GaussQR);
-        return ComputeLoogIntegral(in, length_pi / cos(phi), GaussQR);
-      };
-
-      // Part 2 of second double integral, integrated only in r, as a function
-      // of phi (phi from alpha to pi/2)
-      auto inner22 = [&](double phi) {
-        // Integrand as a function of r only (fixed phi), to calculate the inner
-        // integral
-        auto in = [&](double r) { return integrand2(r, phi); };
-        // Integrating the inner integral in r using log weighted quadrature
-        // return ComputeLogwtIntegral(in,length_pi_p/sin(phi),GaussQR);
-        return ComputeLoogIntegral(in, length_pi_p / sin(phi), GaussQR);
-      };
-
-      // i_IJ -> Integral I, part J
-      double i11 = 0., i21 = 0., i12 = 0., i22 = 0.;
-      // Computing both the parts of the second integral by integrating the
-      // inner integrals w.r.t. phi
-      i21 = ComputeIntegral(inner21, 0, alpha, GaussQR);
-      i22 = ComputeIntegral(inner22, alpha, M_PI / 2, GaussQR);
-      // Computing the first integral
-
-      // part 1 (phi from 0 to alpha)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi
-        double phi = alpha / 2 * (1 + GaussQR.x(i));
-        // Computing inner integral with fixed phi
-        // Inner integral for double integral 1, evaluated with Gauss Legendre
-        // quadrature
-        double inner1 = 0.;
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi / cos(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Evaluating inner1 using Gauss Legendre quadrature
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner1 += GaussQR.w(j) * r * log(D_r_phi(r, phi)) * F(r * sin(phi)) *
-                    G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r from Gauss Legendre nodes
-        inner1 *= rmax / 2;
-        // Multiplying the integrals with appropriate constants for
-        // transformation to phi from Gauss Legendre nodes
-        i11 += GaussQR.w(i) * inner1 * alpha / 2;
-      }
-
-      // part 2 (phi from alpha to pi/2)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi (alpha to pi/2)
-        double phi =
-            GaussQR.x(i) * (M_PI / 2. - alpha) / 2. + (M_PI / 2. + alpha) / 2.;
-        // Computing inner integral with fixed phi
-        // Inner integral for double integral 1, evaluated with Gauss Legendre
-        // quadrature
-        double inner1 = 0.;
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi_p / sin(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Evaluating inner1 using Gauss Legendre quadrature
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner1 += GaussQR.w(j) * r * log(D_r_phi(r, phi)) * F(r * sin(phi)) *
-                    G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r from Gauss Legendre quadrature nodes
-        inner1 *= rmax / 2;
-        // Multiplying the integrals with appropriate constants for
-        // transformation to phi from Gauss Legendre quadrature nodes
-        i12 += GaussQR.w(i) * inner1 * (M_PI / 2. - alpha) / 2.;
-      }
-      // Summing up the parts to get the final integral
-      double integral = 0.5 * (i11 + i12) + (i21 + i22);
-      // Multiplying the integral with appropriate constants for transformation
-      // to local arclength variables
-      integral *= 4 / length_pi / length_pi_p;
-      // Filling up the matrix entry
-      interaction_matrix(i, j) = -1 / (2 * M_PI) * integral;
-    }
-  }
-  return interaction_matrix;
+  // when transforming the parametrizations from [-1,1]->\Pi to local
+  // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
+  // that the common point between the panels corresponds to the parameter 0
+  // in both arclength parametrizations
+  bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
+              std::numeric_limits<double>::epsilon();
+
+  double length_pi =
+      2 * pi.Derivative(swap ? -1 : 1)
+              .norm(); // Length for panel pi to ensure norm of arclength
+                       // parametrization is 1 at the common point
+  double length_pi_p =
+      2 * pi_p.Derivative(swap ? 1 : -1)
+              .norm(); // Length for panel pi_p to ensure norm of arclength
+                       // parametrization is 1 at the common point
+
+  // Values of the functions F and G in \f$\eqref{eq:Isplitapn}\f$ for all the
+  // reference shape functions
+  Eigen::VectorXd F(Q), G(Q);
+  // Lambda expression evaluating F and G at the local arclength parameters
+  // t_pr (panel pi_p) and s_pr (panel pi)
+  auto evaluateFG = [&](double t_pr, double s_pr) {
+    // Transforming the local arclength parameters to standard parameter
+    // range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    space.evaluateShapeFunctionDots(t, F);
+    space.evaluateShapeFunctionDots(s, G);
+  };
+
+  auto D_r_phi = [&](double r, double phi) { // \f$\eqref{eq:Ddef}\f$
+    double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+    // Transforming to local arclength parameter range
+    double s_pr = r * cos(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    // Transforming to local arclength parameter range
+    double t_pr = r * sin(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    if (r > sqrt_epsilon) // Away from singularity, simply use the formula
+      return (pi(s) - pi_p(t)).squaredNorm() / r / r;
+    else // Near singularity, use analytically evaluated limit for r -> 0
+      return 1 + sin(2 * phi) * pi.Derivative(s).dot(pi_p.Derivative(t)) * 4 /
+                     length_pi / length_pi_p;
+  };
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ have to be further
+  // split into two parts part 1 is where phi goes from 0 to alpha part 2 is
+  // where phi goes from alpha to pi/2
+  double alpha = atan(length_pi_p / length_pi); // the split point
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ for all the pairs of
+  // reference shape functions
+  Eigen::MatrixXd i1 = Eigen::MatrixXd::Zero(Q, Q);
+  Eigen::MatrixXd i2 = Eigen::MatrixXd::Zero(Q, Q);
+  // Adds the weighted products of the current values of F and G to integral
+  auto accumulate = [&](Eigen::MatrixXd &integral, double weight) {
+    for (int I = 0; I < Q; ++I)
+      for (int J = 0; J < Q; ++J)
+        integral(I, J) += weight * F(J) * G(I);
+  };
+
+  // Computing both the integrals for part 1 or part 2, with a single
+  // evaluation of F and G per quadrature node
+  auto integrate_part = [&](bool part1) {
+    AccumulateIntegral(
+        [&](double phi, double w_phi) {
+          // Upper limit for the inner 'r' integrals
+          double rmax = part1 ? length_pi / cos(phi) : length_pi_p / sin(phi);
+          // Inner 'r' integral of the first integral, evaluated with Gauss
+          // Legendre quadrature
+          AccumulateIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i1, w_phi * w_r * r * log(D_r_phi(r, phi)));
+              },
+              0, rmax, GaussQR);
+          // Inner 'r' integral of the second integral, evaluated with log
+          // weighted quadrature
+          AccumulateLoogIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i2, w_phi * w_r * r);
+              },
+              rmax, GaussQR);
+        },
+        part1 ? 0 : alpha, part1 ? alpha : M_PI / 2, GaussQR);
+  };
+  integrate_part(true);  // part 1 (phi from 0 to alpha)
+  integrate_part(false); // part 2 (phi from alpha to pi/2)
+
+  // Summing up the integrals and multiplying with appropriate constants for
+  // transformation to local arclength variables
+  return -1 / (2 * M_PI) * 4 / length_pi / length_pi_p * (0.5 * i1 + i2);
 }
 
 Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
                                        const AbstractParametrizedCurve &pi_p,
                                        const AbstractBEMSpace &space,
                                        const QuadRule &GaussQR) {
-  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
-                          // to be used for log weighted quadrature
-                          // std::cout << "Gen" << std::endl;
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
   int Q = space.getQ(); // No. of Reference Shape Functions in trial/test space
+  // Tabulating the points and the functions F and G in \f$\eqref{eq:titg}\f$
+  // at the Gauss nodes, the kth column corresponds to the kth node. Both F and
+  // G are given by the derivatives of the reference shape functions.
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd FG = space.tabulateShapeFunctionDots(GaussQR).matrix();
+  for (unsigned int k = 0; k < N; ++k) {
+    double t = GaussQR.x(k);
+    pi_nodes.col(k) = pi(t);
+    pi_p_nodes.col(k) = pi_p(t);
+  }
   // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:titg}\f$ for
-      // Single Layer BIO
-      auto F = [&](double t) { // Function associated with panel pi_p
-        return space.evaluateShapeFunctionDot(j, t);
-      };
-
-      auto G = [&](double s) { // Function associated with panel pi
-        return space.evaluateShapeFunctionDot(i, s);
-      };
-
-      double integral = 0.;
-
-      // Tensor product quadrature rule
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          double s = GaussQR.x(i);
-          double t = GaussQR.x(j);
-          integral += GaussQR.w(i) * GaussQR.w(j) *
-                      log((pi(s) - pi_p(t)).norm()) * F(t) * G(s);
-        }
-      }
-      // Filling up the matrix entry
-      interaction_matrix(i, j) = -1 / (2 * M_PI) * integral;
+  Eigen::MatrixXd interaction_matrix = Eigen::MatrixXd::Zero(Q, Q);
+  // Tensor product quadrature rule, evaluating the kernel once per pair of
+  // nodes for all the (I,J) matrix entries
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi_nodes.col(k) - pi_p_nodes.col(l)).norm());
+      for (int I = 0; I < Q; ++I)
+        for (int J = 0; J < Q; ++J)
+          interaction_matrix(I, J) += kernel * FG(J, l) * FG(I, k);
     }
   }
+  return -1 / (2 * M_PI) * interaction_matrix;
+}
+
+Eigen::MatrixXd ComputeIntegralGeneral(const PanelGeometryCache &geometry,
+                                       unsigned int i, unsigned int j,
+                                       const AbstractBEMSpace &space,
+                                       const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  ComputeIntegralGeneral(geometry, i, j, TabulatedBEMSpace(space, GaussQR),
+                         GaussQR, interaction_matrix);
   return interaction_matrix;
 }
 
+void ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                            unsigned int j, const TabulatedBEMSpace &space,
+                            const QuadRule &GaussQR,
+                            Eigen::MatrixXd &interaction_matrix) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
+  assert(geometry.getNumNodes() == N);
+  // Tabulated points of the panels pi (i) and pi_p (j)
+  PanelGeometryCache::ConstPointsView pi = geometry.getPoints(i);
+  PanelGeometryCache::ConstPointsView pi_p = geometry.getPoints(j);
+  // No. of Reference Shape Functions in trial/test space
+  int Q = space.getQ();
+  // Derivatives of the reference shape functions at the Gauss nodes, the kth
+  // column corresponds to the kth node
+  const Eigen::ArrayXXd &FG = space.getDots();
+  // Interaction matrix with size Q x Q, keeping the storage of the argument
+  interaction_matrix.setZero(Q, Q);
+  // Tensor product quadrature rule, k and l index the nodes on pi and pi_p.
+  // The kernel is evaluated once per pair of nodes for all the (I,J) entries.
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi.col(k) - pi_p.col(l)).norm());
+      for (int I = 0; I < Q; ++I)
+        for (int J = 0; J < Q; ++J)
+          interaction_matrix(I, J) += kernel * FG(J, l) * FG(I, k);
+    }
+  }
+  interaction_matrix *= -1 / (2 * M_PI);
+}
+
 Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &space,
                                const unsigned int &N) {
-  // Getting the number of panels in the mesh
-  unsigned int numpanels = mesh.getNumPanels();
-  // Getting dimensions of trial/test space
-  unsigned int dims = space.getSpaceDim(numpanels);
-  // Getting the panels from the mesh
-  PanelVector panels = mesh.getPanels();
-  // Getting the number of local shape functions in the trial/test space
-  unsigned int Q = space.getQ();
-  // Initializing the Galerkin matrix with zeros
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return GalerkinMatrix(mesh, geometry, space, GaussQR);
+}
+
+Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh &mesh,
+                               const PanelGeometryCache &geometry,
+                               const AbstractBEMSpace &space,
+                               const QuadRule &GaussQR) {
+  // Getting the space dimension for the mesh
+  unsigned int dims = space.getSpaceDim(mesh.getNumPanels());
   Eigen::MatrixXd output = Eigen::MatrixXd::Zero(dims, dims);
-  // Panel oriented assembly \f$\ref{pc:ass}\f$
-  QuadRule LogWeightQR = getLogWeightQR(1, N);
-  QuadRule GaussQR = getGaussQR(N);
-  for (unsigned int i = 0; i < numpanels; ++i) {
-    for (unsigned int j = 0; j < numpanels; ++j) {
-      // Getting the interaction matrix for the pair of panels i and j
-      Eigen::MatrixXd interaction_matrix =
-          InteractionMatrix(*panels[i], *panels[j], space, GaussQR);
-      // Local to global mapping of the elements in interaction matrix
-      for (unsigned int I = 0; I < Q; ++I) {
-        for (unsigned int J = 0; J < Q; ++J) {
-          // int II = space.LocGlobMap(I + 1, i + 1, numpanels) - 1;
-          // int JJ = space.LocGlobMap(J + 1, j + 1, numpanels) - 1;
-          int II = space.LocGlobMap2(I + 1, i + 1, mesh) - 1;
-          int JJ = space.LocGlobMap2(J + 1, j + 1, mesh) - 1;
-          // Filling the Galerkin matrix entries
-          output(II, JJ) += interaction_matrix(I, J);
-        }
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$ of the upper triangle,
+  // distributed over threads
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace shapes(space, GaussQR);
+  parallel_assembly::AssembleSymmetricGalerkinMatrix(
+      mesh, dofs,
+      [&](unsigned int i, unsigned int j,
+          Eigen::MatrixXd &interaction_matrix) {
+        // Interaction matrix for the pair of panels i and j
+        InteractionMatrix(geometry, i, j, shapes, GaussQR, interaction_matrix);
+      },
+      [&](unsigned int row, unsigned int col, double value) {
+        output(row, col) += value;
+      });
+  // Mirroring the upper triangle
+  for (unsigned int col = 0; col < dims; ++col)
+    for (unsigned int row = 0; row < col; ++row)
+      output(col, row) = output(row, col);
+  return output;
+}
+
+PackedSymmetricMatrix GalerkinMatrixPacked(const ParametrizedMesh &mesh,
+                                           const AbstractBEMSpace &space,
+                                           const unsigned int &N) {
+  // Getting the space dimension for the mesh
+  PackedSymmetricMatrix output(space.getSpaceDim(mesh.getNumPanels()));
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$ of the upper triangle,
+  // distributed over threads
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace shapes(space, GaussQR);
+  parallel_assembly::AssembleSymmetricGalerkinMatrix(
+      mesh, dofs,
+      [&](unsigned int i, unsigned int j,
+          Eigen::MatrixXd &interaction_matrix) {
+        // Interaction matrix for the pair of panels i and j
+        InteractionMatrix(geometry, i, j, shapes, GaussQR, interaction_matrix);
+      },
+      [&](unsigned int row, unsigned int col, double value) {
+        output(row, col) += value;
+      });
+  return output;
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
+                          const AbstractParametrizedCurve &pi_p,
+                          const AbstractBEMSpace &sl_space,
+                          const AbstractBEMSpace &hs_space,
+                          const QuadRule &GaussQR) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
+                          // to be used for log weighted quadrature
+  int Qv = sl_space.getQ(); // No. of Reference Shape Functions for V
+  int Qw = hs_space.getQ(); // No. of Reference Shape Functions for W
+  // Lambda expression for the values of the functions F (curve pi_p) and G
+  // (curve pi) in \f$\eqref{eq:Vidp}\f$. The first Qv entries are the ones
+  // for the Single Layer BIO, the last Qw entries the ones for the
+  // Hypersingular BIO.
+  auto evaluate = [&](const AbstractParametrizedCurve &curve, double t,
+                      Eigen::Ref<Eigen::VectorXd> values) {
+    sl_space.evaluateShapeFunctions(t, values.head(Qv));
+    values.head(Qv) *= curve.Derivative(t).norm();
+    hs_space.evaluateShapeFunctionDots(t, values.tail(Qw));
+  };
+  // Tabulating the points and the values of F and G at the Gauss nodes, the
+  // kth column corresponds to the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd F_nodes(Qv + Qw, N), G_nodes(Qv + Qw, N);
+  for (unsigned int k = 0; k < N; ++k) {
+    pi_nodes.col(k) = pi(GaussQR.x(k));
+    pi_p_nodes.col(k) = pi_p(GaussQR.x(k));
+    evaluate(pi_p, GaussQR.x(k), F_nodes.col(k));
+    evaluate(pi, GaussQR.x(k), G_nodes.col(k));
+  }
+
+  // The two integrals in \f$\eqref{eq:Isplit}\f$ for both the BIOs
+  Eigen::MatrixXd i1_v = Eigen::MatrixXd::Zero(Qv, Qv);
+  Eigen::MatrixXd i2_v = Eigen::MatrixXd::Zero(Qv, Qv);
+  Eigen::MatrixXd i1_w = Eigen::MatrixXd::Zero(Qw, Qw);
+  Eigen::MatrixXd i2_w = Eigen::MatrixXd::Zero(Qw, Qw);
+
+  // Tensor product quadrature for double 1st integral in
+  // \f$\eqref{eq:Isplit}\f$. The kernel is evaluated once per pair of nodes
+  // for both the BIOs.
+  double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double s = GaussQR.x(k);
+      double t = GaussQR.x(l);
+      double s_st;
+      if (fabs(s - t) > sqrt_epsilon) // Away from singularity
+        // Simply evaluating the expression
+        s_st = (pi_nodes.col(k) - pi_p_nodes.col(l)).squaredNorm() / (s - t) /
+               (s - t);
+      else // Near singularity
+        // Using analytic limit for s - > t given in \f$\eqref{eq:Sdef}\f$
+        s_st = pi.Derivative(0.5 * (t + s)).squaredNorm();
+      double kernel = GaussQR.w(k) * GaussQR.w(l) * 0.5 * log(s_st);
+      for (int I = 0; I < Qv; ++I)
+        for (int J = 0; J < Qv; ++J)
+          i1_v(I, J) += kernel * F_nodes(J, l) * G_nodes(I, k);
+      for (int I = 0; I < Qw; ++I)
+        for (int J = 0; J < Qw; ++J)
+          i1_w(I, J) += kernel * F_nodes(Qv + J, l) * G_nodes(Qv + I, k);
+    }
+  }
+
+  // Values of F and G at the points 0.5(w-z) and 0.5(w+z) of the integrand in
+  // transformed coordinates in \f$\eqref{eq:I21}\f$
+  Eigen::VectorXd F_minus(Qv + Qw), G_minus(Qv + Qw), F_plus(Qv + Qw),
+      G_plus(Qv + Qw);
+  // Calculating the second integral by log weighted quadrature in z of the
+  // Gauss Legendre quadrature in w
+  AccumulateLoogIntegral(
+      [&](double z, double w_z) {
+        AccumulateIntegral(
+            [&](double w, double w_w) {
+              evaluate(pi_p, 0.5 * (w - z), F_minus);
+              evaluate(pi, 0.5 * (w + z), G_plus);
+              evaluate(pi_p, 0.5 * (w + z), F_plus);
+              evaluate(pi, 0.5 * (w - z), G_minus);
+              double weight = w_z * w_w;
+              for (int I = 0; I < Qv; ++I)
+                for (int J = 0; J < Qv; ++J)
+                  i2_v(I, J) += weight * (F_minus(J) * G_plus(I) +
+                                          F_plus(J) * G_minus(I));
+              for (int I = Qv; I < Qv + Qw; ++I)
+                for (int J = Qv; J < Qv + Qw; ++J)
+                  i2_w(I - Qv, J - Qv) += weight * (F_minus(J) * G_plus(I) +
+                                                    F_plus(J) * G_minus(I));
+            },
+            -2 + z, 2 - z, GaussQR);
+      },
+      2, GaussQR);
+  return std::make_pair(
+      Eigen::MatrixXd(-1. / (2. * M_PI) * (i1_v + 0.5 * i2_v)),
+      Eigen::MatrixXd(-1. / (2. * M_PI) * (i1_w + 0.5 * i2_w)));
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
+                        const AbstractParametrizedCurve &pi_p,
+                        const AbstractBEMSpace &sl_space,
+                        const AbstractBEMSpace &hs_space,
+                        const QuadRule &GaussQR) {
+  int Qv = sl_space.getQ(); // No. of Reference Shape Functions for V
+  int Qw = hs_space.getQ(); // No. of Reference Shape Functions for W
+  // when transforming the parametrizations from [-1,1]->\Pi to local
+  // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
+  // that the common point between the panels corresponds to the parameter 0
+  // in both arclength parametrizations
+  bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
+              std::numeric_limits<double>::epsilon();
+
+  double length_pi =
+      2 * pi.Derivative(swap ? -1 : 1)
+              .norm(); // Length for panel pi to ensure norm of arclength
+                       // parametrization is 1 at the common point
+  double length_pi_p =
+      2 * pi_p.Derivative(swap ? 1 : -1)
+              .norm(); // Length for panel pi_p to ensure norm of arclength
+                       // parametrization is 1 at the common point
+
+  // Values of the functions F and G in \f$\eqref{eq:Isplitapn}\f$. The first
+  // Qv entries are the ones for the Single Layer BIO, the last Qw entries the
+  // ones for the Hypersingular BIO.
+  Eigen::VectorXd F(Qv + Qw), G(Qv + Qw);
+  // Lambda expression evaluating F and G at the local arclength parameters
+  // t_pr (panel pi_p) and s_pr (panel pi)
+  auto evaluateFG = [&](double t_pr, double s_pr) {
+    // Transforming the local arclength parameters to standard parameter
+    // range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    sl_space.evaluateShapeFunctions(t, F.head(Qv));
+    sl_space.evaluateShapeFunctions(s, G.head(Qv));
+    F.head(Qv) *= pi_p.Derivative(t).norm();
+    G.head(Qv) *= pi.Derivative(s).norm();
+    hs_space.evaluateShapeFunctionDots(t, F.tail(Qw));
+    hs_space.evaluateShapeFunctionDots(s, G.tail(Qw));
+  };
+
+  auto D_r_phi = [&](double r, double phi) { // \f$\eqref{eq:Ddef}\f$
+    double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+    // Transforming to local arclength parameter range
+    double s_pr = r * cos(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    // Transforming to local arclength parameter range
+    double t_pr = r * sin(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    if (r > sqrt_epsilon) // Away from singularity, simply use the formula
+      return (pi(s) - pi_p(t)).squaredNorm() / r / r;
+    else // Near singularity, use analytically evaluated limit for r -> 0
+      return 1 + sin(2 * phi) * pi.Derivative(s).dot(pi_p.Derivative(t)) * 4 /
+                     length_pi / length_pi_p;
+  };
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ have to be further
+  // split into two parts part 1 is where phi goes from 0 to alpha part 2 is
+  // where phi goes from alpha to pi/2
+  double alpha = atan(length_pi_p / length_pi); // the split point
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ for both the BIOs
+  Eigen::MatrixXd i1_v = Eigen::MatrixXd::Zero(Qv, Qv);
+  Eigen::MatrixXd i2_v = Eigen::MatrixXd::Zero(Qv, Qv);
+  Eigen::MatrixXd i1_w = Eigen::MatrixXd::Zero(Qw, Qw);
+  Eigen::MatrixXd i2_w = Eigen::MatrixXd::Zero(Qw, Qw);
+  // Adds the weighted products of the current values of F and G to the
+  // integrals for both the BIOs
+  auto accumulate = [&](Eigen::MatrixXd &integral_v,
+                        Eigen::MatrixXd &integral_w, double weight) {
+    for (int I = 0; I < Qv; ++I)
+      for (int J = 0; J < Qv; ++J)
+        integral_v(I, J) += weight * F(J) * G(I);
+    for (int I = 0; I < Qw; ++I)
+      for (int J = 0; J < Qw; ++J)
+        integral_w(I, J) += weight * F(Qv + J) * G(Qv + I);
+  };
+
+  // Computing both the integrals for part 1 or part 2, with a single
+  // evaluation of the kernel, F and G per quadrature node
+  auto integrate_part = [&](bool part1) {
+    AccumulateIntegral(
+        [&](double phi, double w_phi) {
+          // Upper limit for the inner 'r' integrals
+          double rmax = part1 ? length_pi / cos(phi) : length_pi_p / sin(phi);
+          // Inner 'r' integral of the first integral, evaluated with Gauss
+          // Legendre quadrature
+          AccumulateIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i1_v, i1_w,
+                           w_phi * w_r * r * log(D_r_phi(r, phi)));
+              },
+              0, rmax, GaussQR);
+          // Inner 'r' integral of the second integral, evaluated with log
+          // weighted quadrature
+          AccumulateLoogIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i2_v, i2_w, w_phi * w_r * r);
+              },
+              rmax, GaussQR);
+        },
+        part1 ? 0 : alpha, part1 ? alpha : M_PI / 2, GaussQR);
+  };
+  integrate_part(true);  // part 1 (phi from 0 to alpha)
+  integrate_part(false); // part 2 (phi from alpha to pi/2)
+
+  // Summing up the integrals and multiplying with appropriate constants for
+  // transformation to local arclength variables
+  double factor = -1. / (2 * M_PI) * 4. / length_pi / length_pi_p;
+  return std::make_pair(Eigen::MatrixXd(factor * (0.5 * i1_v + i2_v)),
+                        Eigen::MatrixXd(factor * (0.5 * i1_w + i2_w)));
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
+                       const AbstractParametrizedCurve &pi_p,
+                       const AbstractBEMSpace &sl_space,
+                       const AbstractBEMSpace &hs_space,
+                       const QuadRule &GaussQR) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
+  int Qv = sl_space.getQ(); // No. of Reference Shape Functions for V
+  int Qw = hs_space.getQ(); // No. of Reference Shape Functions for W
+  // Tabulating the points and the functions F and G in \f$\eqref{eq:titg}\f$
+  // for the Single Layer BIO and FG for the Hypersingular BIO at the Gauss
+  // nodes, the kth column corresponds to the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd F(Qv, N), G(Qv, N);
+  Eigen::MatrixXd FG = hs_space.tabulateShapeFunctionDots(GaussQR).matrix();
+  // Reference shape functions of the Single Layer space at the Gauss nodes
+  Eigen::ArrayXXd shapes = sl_space.tabulateShapeFunctions(GaussQR);
+  for (unsigned int k = 0; k < N; ++k) {
+    double t = GaussQR.x(k);
+    pi_nodes.col(k) = pi(t);
+    pi_p_nodes.col(k) = pi_p(t);
+    double pi_norm = pi.Derivative(t).norm();
+    double pi_p_norm = pi_p.Derivative(t).norm();
+    for (int q = 0; q < Qv; ++q) {
+      F(q, k) = shapes(q, k) * pi_p_norm;
+      G(q, k) = shapes(q, k) * pi_norm;
+    }
+  }
+  // Interaction matrices with sizes Qv x Qv and Qw x Qw
+  Eigen::MatrixXd interaction_matrix_v = Eigen::MatrixXd::Zero(Qv, Qv);
+  Eigen::MatrixXd interaction_matrix_w = Eigen::MatrixXd::Zero(Qw, Qw);
+  // Tensor product quadrature rule, evaluating the kernel once per pair of
+  // nodes for all the matrix entries of both the BIOs
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi_nodes.col(k) - pi_p_nodes.col(l)).norm());
+      for (int I = 0; I < Qv; ++I)
+        for (int J = 0; J < Qv; ++J)
+          interaction_matrix_v(I, J) += kernel * F(J, l) * G(I, k);
+      for (int I = 0; I < Qw; ++I)
+        for (int J = 0; J < Qw; ++J)
+          interaction_matrix_w(I, J) += kernel * FG(J, l) * FG(I, k);
+    }
+  }
+  return std::make_pair(
+      Eigen::MatrixXd(-1. / (2 * M_PI) * interaction_matrix_v),
+      Eigen::MatrixXd(-1 / (2 * M_PI) * interaction_matrix_w));
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const AbstractBEMSpace &sl_space,
+                       const AbstractBEMSpace &hs_space,
+                       const QuadRule &GaussQR) {
+  std::pair<Eigen::MatrixXd, Eigen::MatrixXd> interaction_matrices;
+  ComputeIntegralGeneral(geometry, i, j, TabulatedBEMSpace(sl_space, GaussQR),
+                         TabulatedBEMSpace(hs_space, GaussQR), GaussQR,
+                         interaction_matrices);
+  return interaction_matrices;
+}
+
+void ComputeIntegralGeneral(
+    const PanelGeometryCache &geometry, unsigned int i, unsigned int j,
+    const TabulatedBEMSpace &sl_space, const TabulatedBEMSpace &hs_space,
+    const QuadRule &GaussQR,
+    std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &interaction_matrices) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
+  assert(geometry.getNumNodes() == N);
+  // Tabulated points and derivative norms of the panels pi (i) and pi_p (j)
+  PanelGeometryCache::ConstPointsView pi = geometry.getPoints(i);
+  PanelGeometryCache::ConstPointsView pi_p = geometry.getPoints(j);
+  PanelGeometryCache::ConstValuesView pi_norms = geometry.getDerivativeNorms(i);
+  PanelGeometryCache::ConstValuesView pi_p_norms =
+      geometry.getDerivativeNorms(j);
+  int Qv = sl_space.getQ(); // No. of Reference Shape Functions for V
+  int Qw = hs_space.getQ(); // No. of Reference Shape Functions for W
+  // Reference shape functions of the Single Layer space and derivatives of
+  // the ones of the Hypersingular space (FG) at the Gauss nodes
+  const Eigen::ArrayXXd &shapes = sl_space.getValues();
+  const Eigen::ArrayXXd &FG = hs_space.getDots();
+  // Interaction matrices with sizes Qv x Qv and Qw x Qw, keeping the storage
+  // of the argument
+  Eigen::MatrixXd &interaction_matrix_v = interaction_matrices.first;
+  Eigen::MatrixXd &interaction_matrix_w = interaction_matrices.second;
+  interaction_matrix_v.setZero(Qv, Qv);
+  interaction_matrix_w.setZero(Qw, Qw);
+  // Tensor product quadrature rule, k and l index the nodes on pi and pi_p.
+  // The kernel is evaluated once per pair of nodes for all the matrix entries
+  // of both the BIOs. The functions F and G in \f$\eqref{eq:titg}\f$ for the
+  // Single Layer BIO are evaluated on the fly, without temporary tables.
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi.col(k) - pi_p.col(l)).norm());
+      double pi_norm = pi_norms(k), pi_p_norm = pi_p_norms(l);
+      for (int I = 0; I < Qv; ++I) {
+        double G = shapes(I, k) * pi_norm;
+        for (int J = 0; J < Qv; ++J)
+          interaction_matrix_v(I, J) +=
+              kernel * (shapes(J, l) * pi_p_norm) * G;
       }
+      for (int I = 0; I < Qw; ++I)
+        for (int J = 0; J < Qw; ++J)
+          interaction_matrix_w(I, J) += kernel * FG(J, l) * FG(I, k);
     }
   }
-  return output;
+  interaction_matrix_v *= -1. / (2 * M_PI);
+  interaction_matrix_w *= -1 / (2 * M_PI);
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+InteractionMatrices(const PanelGeometryCache &geometry, unsigned int i,
+                    unsigned int j, const AbstractBEMSpace &sl_space,
+                    const AbstractBEMSpace &hs_space, const QuadRule &GaussQR) {
+  std::pair<Eigen::MatrixXd, Eigen::MatrixXd> interaction_matrices;
+  InteractionMatrices(geometry, i, j, TabulatedBEMSpace(sl_space, GaussQR),
+                      TabulatedBEMSpace(hs_space, GaussQR), GaussQR,
+                      interaction_matrices);
+  return interaction_matrices;
+}
+
+void InteractionMatrices(
+    const PanelGeometryCache &geometry, unsigned int i, unsigned int j,
+    const TabulatedBEMSpace &sl_space, const TabulatedBEMSpace &hs_space,
+    const QuadRule &GaussQR,
+    std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &interaction_matrices) {
+  // Parametrizations for the panels i and j
+  const AbstractParametrizedCurve &pi = geometry.getPanel(i);
+  const AbstractParametrizedCurve &pi_p = geometry.getPanel(j);
+  // Relation of the panels, looked up in the topology of the mesh
+  PanelRelation relation = geometry.getTopology().getRelation(i, j);
+
+  if (relation == PanelRelation::Coinciding) // Same Panels case
+    interaction_matrices = ComputeIntegralCoinciding(
+        pi, pi_p, sl_space.getSpace(), hs_space.getSpace(), GaussQR);
+
+  else if (relation == PanelRelation::Adjacent) // Adjacent Panels case
+    interaction_matrices = ComputeIntegralAdjacent(
+        pi, pi_p, sl_space.getSpace(), hs_space.getSpace(), GaussQR);
+
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order =
+        adaptive_quadrature::SelectOrder(geometry, i, j, GaussQR.n);
+    // Using the geometry tabulated for the lower order
+    if (order < GaussQR.n)
+      ComputeIntegralGeneral(geometry.getLowerOrder(order), i, j,
+                             sl_space.getLowerOrder(order),
+                             hs_space.getLowerOrder(order), getGaussQR(order),
+                             interaction_matrices);
+    else // Using the tabulated geometry
+      ComputeIntegralGeneral(geometry, i, j, sl_space, hs_space, GaussQR,
+                             interaction_matrices);
+  }
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+GalerkinMatrices(const ParametrizedMesh &mesh,
+                 const PanelGeometryCache &geometry,
+                 const AbstractBEMSpace &sl_space,
+                 const AbstractBEMSpace &hs_space, const QuadRule &GaussQR) {
+  // Getting the space dimensions for the mesh
+  unsigned int numpanels = mesh.getNumPanels();
+  unsigned int dims_v = sl_space.getSpaceDim(numpanels);
+  unsigned int dims_w = hs_space.getSpaceDim(numpanels);
+  Eigen::MatrixXd V = Eigen::MatrixXd::Zero(dims_v, dims_v);
+  Eigen::MatrixXd W = Eigen::MatrixXd::Zero(dims_w, dims_w);
+  // Tabulating the local to global maps of the spaces
+  DofMap sl_dofs(sl_space, mesh);
+  DofMap hs_dofs(hs_space, mesh);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$ of the upper triangles,
+  // distributed over threads
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace sl_shapes(sl_space, GaussQR);
+  TabulatedBEMSpace hs_shapes(hs_space, GaussQR);
+  parallel_assembly::ForEachUpperPanelPair<
+      std::pair<Eigen::MatrixXd, Eigen::MatrixXd>>(
+      mesh,
+      [&](unsigned int i, unsigned int j,
+          std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &matrices) {
+        // Interaction matrices for the pair of panels i and j
+        InteractionMatrices(geometry, i, j, sl_shapes, hs_shapes, GaussQR,
+                            matrices);
+      },
+      [&](unsigned int i, unsigned int j,
+          const std::pair<Eigen::MatrixXd, Eigen::MatrixXd> &matrices) {
+        parallel_assembly::ScatterSymmetric(
+            sl_dofs, i, j, matrices.first,
+            [&](unsigned int row, unsigned int col, double value) {
+              V(row, col) += value;
+            });
+        parallel_assembly::ScatterSymmetric(
+            hs_dofs, i, j, matrices.second,
+            [&](unsigned int row, unsigned int col, double value) {
+              W(row, col) += value;
+            });
+      });
+  // Mirroring the upper triangles
+  for (unsigned int col = 0; col < dims_v; ++col)
+    for (unsigned int row = 0; row < col; ++row)
+      V(col, row) = V(row, col);
+  for (unsigned int col = 0; col < dims_w; ++col)
+    for (unsigned int row = 0; row < col; ++row)
+      W(col, row) = W(row, col);
+  return std::make_pair(V, W);
+}
+
+std::pair<Eigen::MatrixXd, Eigen::MatrixXd>
+GalerkinMatrices(const ParametrizedMesh &mesh,
+                 const AbstractBEMSpace &sl_space,
+                 const AbstractBEMSpace &hs_space, const unsigned int &N) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return GalerkinMatrices(mesh, geometry, sl_space, hs_space, GaussQR);
 }
 
 } // namespace hypersingular
@@ -0,0 +1,196 @@
+/**
+ * \file panel_geometry_cache.cpp
+ * \brief This file defines the class which tabulates the geometry of all the
+ *        panels in a mesh at the nodes of a quadrature rule.
+ *
+ * This File is a part of the 2D-Parametric BEM package
+ */
+
+#include "panel_geometry_cache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "abstract_bem_space.hpp"
+#include "dof_map.hpp"
+#include "gauleg.hpp"
+#include <Eigen/Dense>
+
+namespace parametricbem2d {
+
+PanelGeometryCache::PanelGeometryCache(const ParametrizedMesh &mesh,
+                                       const QuadRule &GaussQR)
+    : PanelGeometryCache(mesh.getPanels(), mesh.getTopology(), GaussQR) {}
+
+PanelGeometryCache::PanelGeometryCache(const PanelVector &panels,
+                                       const MeshTopology &topology,
+                                       const QuadRule &GaussQR)
+    : panels_(panels), topology_(topology), numnodes_(GaussQR.n),
+      lower_orders_(new std::atomic<const PanelGeometryCache *>[numnodes_]()) {
+  unsigned int numpanels = panels_.size();
+  points_.resize(2, numpanels * numnodes_);
+  derivatives_.resize(2, numpanels * numnodes_);
+  double_derivatives_.resize(2, numpanels * numnodes_);
+  normals_.resize(2, numpanels * numnodes_);
+  derivative_norms_.resize(numpanels * numnodes_);
+  lengths_.resize(numpanels);
+  centers_.resize(2, numpanels);
+  radii_.resize(numpanels);
+  // Quadrature nodes and the values of the parametrizations at them
+  Eigen::ArrayXd t =
+      Eigen::Map<const Eigen::ArrayXd>(GaussQR.x.data(), numnodes_);
+  Eigen::Matrix2Xd values(2, numnodes_);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    // Evaluating all the nodes of a panel with one call
+    panels_[i]->Evaluate(t, values);
+    points_.middleCols(i * numnodes_, numnodes_) = values;
+    panels_[i]->Derivative(t, values);
+    derivatives_.middleCols(i * numnodes_, numnodes_) = values;
+    panels_[i]->DoubleDerivative(t, values);
+    double_derivatives_.middleCols(i * numnodes_, numnodes_) = values;
+    for (unsigned int k = 0; k < numnodes_; ++k) {
+      unsigned int col = i * numnodes_ + k;
+      Eigen::Vector2d tangent = derivatives_.col(col);
+      derivative_norms_(col) = tangent.norm();
+      // Outward normal vector, normalized in the same way as in the kernels
+      Eigen::Vector2d normal;
+      normal << tangent(1), -tangent(0);
+      normals_.col(col) = normal / normal.norm();
+    }
+    // Length of the panel by quadrature
+    lengths_(i) = GaussQR.w.dot(getDerivativeNorms(i));
+    // Circle around the panel, centered at the midpoint of its endpoints
+    Eigen::Vector2d start = panels_[i]->operator()(-1);
+    Eigen::Vector2d end = panels_[i]->operator()(1);
+    centers_.col(i) = 0.5 * (start + end);
+    radii_(i) = 0.5 * (end - start).norm();
+    for (unsigned int k = 0; k < numnodes_; ++k)
+      radii_(i) = std::max(
+          radii_(i), (points_.col(i * numnodes_ + k) - centers_.col(i)).norm());
+  }
+}
+
+PanelGeometryCache::~PanelGeometryCache() {
+  for (unsigned int order = 0; order < numnodes_; ++order)
+    delete lower_orders_[order].load();
+}
+
+const PanelGeometryCache &
+PanelGeometryCache::getLowerOrder(unsigned int order) const {
+  assert(order < numnodes_);
+  const PanelGeometryCache *geometry =
+      lower_orders_[order].load(std::memory_order_acquire);
+  if (geometry == nullptr) {
+    // Threads tabulating the same order concurrently keep the first result
+    const PanelGeometryCache *computed =
+        new PanelGeometryCache(panels_, topology_, getGaussQR(order));
+    if (lower_orders_[order].compare_exchange_strong(
+            geometry, computed, std::memory_order_acq_rel))
+      geometry = computed;
+    else
+      delete computed;
+  }
+  return *geometry;
+}
+
+double PanelGeometryCache::estimateRho(unsigned int i, unsigned int j) const {
+  // Lower bound for the distance between the panels
+  double dist =
+      (centers_.col(i) - centers_.col(j)).norm() - radii_(i) - radii_(j);
+  if (dist <= 0)
+    return std::numeric_limits<double>::infinity();
+  // Admissibility formula as in rho()
+  return std::max(lengths_(i), lengths_(j)) / dist;
+}
+
+double PanelGeometryCache::estimateRho(const Eigen::Vector2d &x,
+                                       unsigned int i) const {
+  // Lower bound for the distance between the point and the panel
+  double dist = (x - centers_.col(i)).norm() - radii_(i);
+  if (dist <= 0)
+    return std::numeric_limits<double>::infinity();
+  return lengths_(i) / dist;
+}
+
+std::vector<std::vector<unsigned int>>
+PanelGeometryCache::findNearPanels(const Eigen::Matrix2Xd &points,
+                                   double rho) const {
+  unsigned int numpanels = panels_.size();
+  std::vector<std::vector<unsigned int>> near(points.cols());
+  if (numpanels == 0)
+    return near;
+  // A panel is close to the points in the disk with radius
+  // radius + length / rho around its center
+  Eigen::VectorXd reach = radii_ + lengths_ / rho;
+  // Bounding box of the disks
+  Eigen::Vector2d lower = centers_.col(0);
+  Eigen::Vector2d upper = centers_.col(0);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    Eigen::Vector2d extent = Eigen::Vector2d::Constant(reach(i));
+    lower = lower.cwiseMin(centers_.col(i) - extent);
+    upper = upper.cwiseMax(centers_.col(i) + extent);
+  }
+  // Uniform grid with cells at least as large as the largest disk, such that
+  // every disk overlaps at most 3 X 3 cells, and with at most about numpanels
+  // cells
+  double cellsize = std::max(
+      reach.maxCoeff(), std::sqrt((upper - lower).prod() / numpanels));
+  unsigned int nx = std::floor((upper(0) - lower(0)) / cellsize) + 1;
+  unsigned int ny = std::floor((upper(1) - lower(1)) / cellsize) + 1;
+  std::vector<std::vector<unsigned int>> cells(nx * ny);
+  auto cell = [&](double coordinate, unsigned int dim, unsigned int n) {
+    double index = std::floor((coordinate - lower(dim)) / cellsize);
+    return static_cast<unsigned int>(std::min(std::max(index, 0.), n - 1.));
+  };
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    for (unsigned int cx = cell(centers_(0, i) - reach(i), 0, nx);
+         cx <= cell(centers_(0, i) + reach(i), 0, nx); ++cx)
+      for (unsigned int cy = cell(centers_(1, i) - reach(i), 1, ny);
+           cy <= cell(centers_(1, i) + reach(i), 1, ny); ++cy)
+        cells[cx * ny + cy].push_back(i);
+  }
+  // Checking the panels in the cell of every point
+  for (unsigned int k = 0; k < points.cols(); ++k) {
+    Eigen::Vector2d x = points.col(k);
+    if ((x.array() < lower.array()).any() || (x.array() > upper.array()).any())
+      continue;
+    for (unsigned int i : cells[cell(x(0), 0, nx) * ny + cell(x(1), 1, ny)])
+      if (estimateRho(x, i) > rho)
+        near[k].push_back(i);
+  }
+  return near;
+}
+
+Eigen::VectorXd WeightedDensity(const PanelGeometryCache &geometry,
+                                const ParametrizedMesh &mesh,
+                                const AbstractBEMSpace &space,
+                                const Eigen::VectorXd &coeffs,
+                                const QuadRule &GaussQR) {
+  unsigned int numpanels = mesh.getNumPanels();
+  unsigned int N = GaussQR.n;
+  assert(geometry.getNumNodes() == N);
+  assert(coeffs.rows() == space.getSpaceDim(numpanels));
+  // Number of local shape functions in the BEM space
+  unsigned int Q = space.getQ();
+  // Local shape functions times quadrature weights at the nodes
+  Eigen::MatrixXd shapes = (space.tabulateShapeFunctions(GaussQR).rowwise() *
+                            GaussQR.w.transpose().array())
+                               .matrix();
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  Eigen::VectorXd density = Eigen::VectorXd::Zero(N * numpanels);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    // Local to global mapping of the coefficients
+    for (unsigned int I = 0; I < Q; ++I)
+      density.segment(i * N, N) +=
+          coeffs(dofs(I, i)) * shapes.row(I).transpose();
+    density.segment(i * N, N) =
+        density.segment(i * N, N).cwiseProduct(geometry.getDerivativeNorms(i));
+  }
+  return density;
+}
+
+} // namespace parametricbem2d
@@ -8,31 +8,84 @@
 
 #include "parametrized_mesh.hpp"
 
-#include <utility>
+#include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 
 #include <Eigen/Dense>
 
 namespace parametricbem2d {
 
-ParametrizedMesh::ParametrizedMesh(PanelVector panels) : panels_(panels) {
-  // std::cout << "ParametrizedMesh constructor called!" << std::endl;
+MeshTopology::MeshTopology(const PanelVector &panels) {
+  double tol = std::numeric_limits<double>::epsilon();
+  unsigned int numpanels = panels.size();
+  next_.assign(numpanels, numpanels);
+  previous_.assign(numpanels, numpanels);
+  // Starting points of the panels, sorted by their x coordinate along with
+  // the indices of the panels
+  std::vector<Eigen::Vector2d> starts(numpanels);
+  std::vector<std::pair<double, unsigned int>> sorted(numpanels);
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    starts[i] = panels[i]->operator()(-1);
+    sorted[i] = std::make_pair(starts[i](0), i);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    Eigen::Vector2d end = panels[i]->operator()(1);
+    // Only the starting points with close x coordinates can coincide
+    auto it = std::lower_bound(sorted.begin(), sorted.end(),
+                               std::make_pair(end(0) - 100. * tol, 0u));
+    for (; it != sorted.end() && it->first - end(0) < 100. * tol; ++it) {
+      if ((end - starts[it->second]).norm() / 100. < tol) {
+        next_[i] = it->second;
+        previous_[it->second] = i;
+        break;
+      }
+    }
+  }
+  // Numbering the chains of connected panels
+  chain_.assign(numpanels, numpanels);
+  numchains_ = 0;
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    if (chain_[i] < numpanels)
+      continue;
+    // Going back to the first panel of an open chain, or once around a
+    // closed one, and numbering the panels from there on
+    unsigned int first = i;
+    for (unsigned int steps = 0; steps < numpanels &&
+                                 previous_[first] < numpanels &&
+                                 previous_[first] != i;
+         ++steps)
+      first = previous_[first];
+    for (unsigned int k = first; k < numpanels && chain_[k] == numpanels;
+         k = next_[k])
+      chain_[k] = numchains_;
+    ++numchains_;
+  }
+}
+
+ParametrizedMesh::ParametrizedMesh(PanelVector panels)
+    : panels_(panels), topology_(panels_) {
   unsigned int N = getNumPanels();
-  // Determining the split value by looping over the panels in the mesh. Non
-  // zero split indicates two distinct boundaries in the mesh object. Used when
-  // dealing with an annular domain
+  // Determining the boundary components by looping over the panels in the
+  // mesh. A component ends where a panel is not followed by the next one.
+  offsets_.push_back(0);
+  components_.resize(N);
   for (unsigned int i = 0; i < N; ++i) {
-    if ((panels[0]->operator()(-1.) - panels[i]->operator()(1.)).norm() <
-        10*std::numeric_limits<double>::epsilon()) {
-      // std::cout << "Break in continuity at position "<< i << std::endl;
-      split_ = (i + 1) % N;
-    }
+    components_[i] = offsets_.size() - 1;
+    if (i + 1 < N && topology_.getNext(i) != i + 1)
+      offsets_.push_back(i + 1);
   }
-  // std::cout << "split : " << split_ << std::endl;
+  if (N > 0)
+    offsets_.push_back(N);
+  // Non zero split indicates two or more distinct boundaries in the mesh
+  // object, it is the position where the second boundary begins
+  split_ = getNumComponents() > 1 ? offsets_[1] : 0;
 }
 
-PanelVector ParametrizedMesh::getPanels() const {
-  // Returning a copy of the stored panels
+const PanelVector &ParametrizedMesh::getPanels() const {
+  // Returning the stored panels without copying them
   return panels_;
 }
 
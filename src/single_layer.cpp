@@ -18,10 +18,17 @@
 
 #include "abstract_bem_space.hpp"
 #include "abstract_parametrized_curve.hpp"
+#include "adaptive_quadrature.hpp"
 #include "discontinuous_space.hpp"
+#include "dof_map.hpp"
+#include "fast_multipole.hpp"
 #include "gauleg.hpp"
+#include "hierarchical_matrix.hpp"
 #include "integral_gauss.hpp"
 #include "logweight_quadrature.hpp"
+#include "packed_symmetric_matrix.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
 #include "parametrized_mesh.hpp"
 #include <Eigen/Dense>
 
@@ -39,8 +46,57 @@ Eigen::MatrixXd InteractionMatrix(const AbstractParametrizedCurve &pi,
            (pi(-1) - pi_p(1)).norm() / 100. < tol) // Adjacent Panels case
     return ComputeIntegralAdjacent(pi, pi_p, space, GaussQR);
 
-  else // Disjoint panels case
-    return ComputeIntegralGeneral(pi, pi_p, space, GaussQR);
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order = adaptive_quadrature::SelectOrder(pi, pi_p, GaussQR.n);
+    return ComputeIntegralGeneral(
+        pi, pi_p, space, order < GaussQR.n ? getGaussQR(order) : GaussQR);
+  }
+}
+
+Eigen::MatrixXd InteractionMatrix(const PanelGeometryCache &geometry,
+                                  unsigned int i, unsigned int j,
+                                  const AbstractBEMSpace &space,
+                                  const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  InteractionMatrix(geometry, i, j, TabulatedBEMSpace(space, GaussQR), GaussQR,
+                    interaction_matrix);
+  return interaction_matrix;
+}
+
+void InteractionMatrix(const PanelGeometryCache &geometry, unsigned int i,
+                       unsigned int j, const TabulatedBEMSpace &space,
+                       const QuadRule &GaussQR,
+                       Eigen::MatrixXd &interaction_matrix) {
+  // Parametrizations for the panels i and j
+  const AbstractParametrizedCurve &pi = geometry.getPanel(i);
+  const AbstractParametrizedCurve &pi_p = geometry.getPanel(j);
+  // Relation of the panels, looked up in the topology of the mesh
+  PanelRelation relation = geometry.getTopology().getRelation(i, j);
+
+  if (relation == PanelRelation::Coinciding) // Same Panels case
+    interaction_matrix =
+        ComputeIntegralCoinciding(pi, pi_p, space.getSpace(), GaussQR);
+
+  else if (relation == PanelRelation::Adjacent) // Adjacent Panels case
+    interaction_matrix =
+        ComputeIntegralAdjacent(pi, pi_p, space.getSpace(), GaussQR);
+
+  else { // Disjoint panels case
+    // Quadrature order chosen from the admissibility of the panels, if
+    // enabled in adaptive_quadrature
+    unsigned order =
+        adaptive_quadrature::SelectOrder(geometry, i, j, GaussQR.n);
+    // Using the geometry tabulated for the lower order
+    if (order < GaussQR.n)
+      ComputeIntegralGeneral(geometry.getLowerOrder(order), i, j,
+                             space.getLowerOrder(order), getGaussQR(order),
+                             interaction_matrix);
+    else // Using the tabulated geometry
+      ComputeIntegralGeneral(geometry, i, j, space, GaussQR,
+                             interaction_matrix);
+  }
 }
 
 Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
@@ -50,245 +106,190 @@ Eigen::MatrixXd ComputeIntegralCoinciding(const AbstractParametrizedCurve &pi,
   unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
                           // to be used for log weighted quadrature
   int Q = space.getQ(); // No. of Reference Shape Functions in trial/test space
-  // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:Vidp}\f$
-      auto F = [&](double t) { // Function associated with panel pi_p
-        return space.evaluateShapeFunction(j, t) * pi_p.Derivative(t).norm();
-      };
-
-      auto G = [&](double s) { // Function associated with panel pi
-        return space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
-
-      // Lambda expression for the 1st integrand in \f$\eqref{eq:Isplit}\f$
-      auto integrand1 = [&](double s, double t) {
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        double s_st;
-        if (fabs(s - t) >
-            sqrt_epsilon) // Away from singularity for stable evaluation as
-                          // mentioned in \f$\eqref{eq:Stab}\f$
-          // Simply evaluating the expression
-          s_st = (pi(s) - pi_p(t)).squaredNorm() / (s - t) / (s - t);
-        else // Near singularity
-          // Using analytic limit for s - > t given in \f$\eqref{eq:Sdef}\f$
-          s_st = pi.Derivative(0.5 * (t + s)).squaredNorm();
-        return 0.5 * log(s_st) * F(t) * G(s);
-      };
-
-      double i1 = 0., i2 = 0.; // The two integrals in \f$\eqref{eq:Isplit}\f$
-
-      // Tensor product quadrature for double 1st integral in
-      // \f$\eqref{eq:Isplit}\f$
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          i1 += GaussQR.w(i) * GaussQR.w(j) *
-                integrand1(GaussQR.x(i), GaussQR.x(j));
-        }
-      }
-
-      // Lambda expression for inner integrand in transformed coordinates in
-      // \f$\eqref{eq:I21}\f$
-      auto integrand2 = [&](double w, double z) {
-        return F(0.5 * (w - z)) * G(0.5 * (w + z)) +
-               F(0.5 * (w + z)) * G(0.5 * (w - z));
-      };
-
-      // Integral of integrand2 above w.r.t. w, as a function of z
-      auto inner2_z = [&](double z) {
-        // Integrand 2 as a function of w only (fixed z), to integrate w.r.t. w
-        auto integrand2_w = [&](double w) { return integrand2(w, z); };
-        // Computing the integral w.r.t. w
-        return ComputeIntegral(integrand2_w, -2 + z, 2 - z, GaussQR);
-      };
+  // Lambda expression for the values of the functions F (curve pi_p) and G
+  // (curve pi) in \f$\eqref{eq:Vidp}\f$ for all the reference shape functions
+  auto evaluate = [&](const AbstractParametrizedCurve &curve, double t,
+                      Eigen::Ref<Eigen::VectorXd> values) {
+    space.evaluateShapeFunctions(t, values);
+    values *= curve.Derivative(t).norm();
+  };
+  // Tabulating the points and the values of F and G at the Gauss nodes, the
+  // kth column corresponds to the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd F_nodes(Q, N), G_nodes(Q, N);
+  for (unsigned int k = 0; k < N; ++k) {
+    pi_nodes.col(k) = pi(GaussQR.x(k));
+    pi_p_nodes.col(k) = pi_p(GaussQR.x(k));
+    evaluate(pi_p, GaussQR.x(k), F_nodes.col(k));
+    evaluate(pi, GaussQR.x(k), G_nodes.col(k));
+  }
 
-      // Calculating the second integral by logweighted integral of the function
-      // 'inner2_z' above
-      // i2 = ComputeLogwtIntegral(inner2_z, 2,GaussQR);
-      i2 = ComputeLoogIntegral(inner2_z, 2, GaussQR);
-      interaction_matrix(i, j) = -1. / (2. * M_PI) * (i1 + 0.5 * i2);
+  // The two integrals in \f$\eqref{eq:Isplit}\f$ for all the pairs of
+  // reference shape functions, computed in a single quadrature sweep
+  Eigen::MatrixXd i1 = Eigen::MatrixXd::Zero(Q, Q);
+  Eigen::MatrixXd i2 = Eigen::MatrixXd::Zero(Q, Q);
+
+  // Tensor product quadrature for double 1st integral in
+  // \f$\eqref{eq:Isplit}\f$. The kernel is evaluated once per pair of nodes.
+  double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double s = GaussQR.x(k);
+      double t = GaussQR.x(l);
+      double s_st;
+      if (fabs(s - t) > sqrt_epsilon) // Away from singularity for stable
+                                      // evaluation as mentioned in
+                                      // \f$\eqref{eq:Stab}\f$
+        // Simply evaluating the expression
+        s_st = (pi_nodes.col(k) - pi_p_nodes.col(l)).squaredNorm() / (s - t) /
+               (s - t);
+      else // Near singularity
+        // Using analytic limit for s - > t given in \f$\eqref{eq:Sdef}\f$
+        s_st = pi.Derivative(0.5 * (t + s)).squaredNorm();
+      double kernel = GaussQR.w(k) * GaussQR.w(l) * 0.5 * log(s_st);
+      for (int I = 0; I < Q; ++I)
+        for (int J = 0; J < Q; ++J)
+          i1(I, J) += kernel * F_nodes(J, l) * G_nodes(I, k);
     }
   }
-  return interaction_matrix;
+
+  // Values of F and G at the points 0.5(w-z) and 0.5(w+z) of the integrand in
+  // transformed coordinates in \f$\eqref{eq:I21}\f$
+  Eigen::VectorXd F_minus(Q), G_minus(Q), F_plus(Q), G_plus(Q);
+  // Calculating the second integral by log weighted quadrature in z of the
+  // Gauss Legendre quadrature in w
+  AccumulateLoogIntegral(
+      [&](double z, double w_z) {
+        AccumulateIntegral(
+            [&](double w, double w_w) {
+              evaluate(pi_p, 0.5 * (w - z), F_minus);
+              evaluate(pi, 0.5 * (w + z), G_plus);
+              evaluate(pi_p, 0.5 * (w + z), F_plus);
+              evaluate(pi, 0.5 * (w - z), G_minus);
+              double weight = w_z * w_w;
+              for (int I = 0; I < Q; ++I)
+                for (int J = 0; J < Q; ++J)
+                  i2(I, J) += weight * (F_minus(J) * G_plus(I) +
+                                        F_plus(J) * G_minus(I));
+            },
+            -2 + z, 2 - z, GaussQR);
+      },
+      2, GaussQR);
+  return -1. / (2. * M_PI) * (i1 + 0.5 * i2);
 }
 
 Eigen::MatrixXd ComputeIntegralAdjacent(const AbstractParametrizedCurve &pi,
                                         const AbstractParametrizedCurve &pi_p,
                                         const AbstractBEMSpace &space,
                                         const QuadRule &GaussQR) {
-  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object. Same order
-                          // to be used for log weighted quadrature
   int Q = space.getQ(); // No. of Reference Shape Functions in trial/test space
-  // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // when transforming the parametrizations from [-1,1]->\Pi to local
-      // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
-      // that the common point between the panels corresponds to the parameter 0
-      // in both arclength parametrizations
-      bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
-                  std::numeric_limits<double>::epsilon();
-      // Panel lengths for local arclength parametrization in
-      // \f$\eqref{eq:ap}\f$. Actual values are not required so a length of 1 is
-      // used for both the panels
-      double length_pi =
-          2 * pi.Derivative(swap ? -1 : 1)
-                  .norm(); // Length for panel pi to ensure norm of arclength
-                           // parametrization is 1 at the common point
-      double length_pi_p =
-          2 * pi_p.Derivative(swap ? 1 : -1)
-                  .norm(); // Length for panel pi_p to ensure norm of arclength
-                           // parametrization is 1 at the common point
-
-      assert((pi(swap ? -1 : 1) - pi_p(swap ? 1 : -1)).norm() <
-             10. * std::numeric_limits<double>::epsilon());
-      assert(fabs(pi.Derivative(swap ? -1 : 1).norm() * 2 / length_pi - 1.) <
-             10. * std::numeric_limits<double>::epsilon());
-      assert(fabs(pi_p.Derivative(swap ? 1 : -1).norm() * 2 / length_pi_p -
-                  1.) < 10. * std::numeric_limits<double>::epsilon());
-
-      // Lambda expressions for the functions F,G and D(r,phi) in
-      // \f$\eqref{eq:Isplitapn}\f$
-      auto F = [&](double t_pr) { // Function associated with panel pi_p
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        return space.evaluateShapeFunction(j, t) * pi_p.Derivative(t).norm();
-      };
-
-      auto G = [&](double s_pr) { // Function associated with panel pi
-        // Transforming the local arclength parameter to standard parameter
-        // range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        return space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
-
-      auto D_r_phi = [&](double r, double phi) { // \f$\eqref{eq:Ddef}\f$
-        double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
-        // Transforming to local arclength parameter range
-        double s_pr = r * cos(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
-        // Transforming to local arclength parameter range
-        double t_pr = r * sin(phi);
-        // Transforming to standard parameter range [-1,1] using swap
-        double t =
-            swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
-        if (r > sqrt_epsilon) // Away from singularity, simply use the formula
-          return (pi(s) - pi_p(t)).squaredNorm() / r / r;
-        else // Near singularity, use analytically evaluated limit at r -> 0 for
-             // stable evaluation \f$\eqref{eq:Dstab}\f$
-          return 1 + sin(2 * phi) * pi.Derivative(s).dot(pi_p.Derivative(t)) *
-                         4 / length_pi / length_pi_p;
-      };
-
-      // The two integrals in \f$\eqref{eq:Isplitapn}\f$ have to be further
-      // split into two parts part 1 is where phi goes from 0 to alpha part 2 is
-      // where phi goes from alpha to pi/2
-      double alpha = atan(length_pi_p / length_pi); // the split point
-
-      // Integrand for the second double integral in equation
-      // \f$\eqref{eq:Isplitapn}\f$, without the log weight
-      auto integrand2 = [&](double r, double phi) {
-        return r * F(r * sin(phi)) * G(r * cos(phi));
-      };
-
-      // Part 1 of second double integral, integrated only in r, as a function
-      // of phi (phi from 0 to alpha)
-      auto inner21 = [&](double phi) {
-        // Integrand as a function of r only (fixed phi), to calculate the inner
-        // integral
-        auto in = [&](double r) { return integrand2(r, phi); };
-        // Integrating the inner integral in r using log weighted quadrature
-        // return ComputeLogwtIntegral(in,length_pi/cos(phi),GaussQR);
-        return ComputeLoogIntegral(in, length_pi / cos(phi), GaussQR);
-      };
-
-      // Part 2 of second double integral, integrated only in r, as a function
-      // of phi (phi from alpha to pi/2)
-      auto inner22 = [&](double phi) {
-        // Integrand as a function of r only (fixed phi), to calculate the inner
-        // integral
-        auto in = [&](double r) { return integrand2(r, phi); };
-        // Integrating the inner integral in r using log weighted quadrature
-        // return ComputeLogwtIntegral(in,length_pi_p/sin(phi),GaussQR);
-        return ComputeLoogIntegral(in, length_pi_p / sin(phi), GaussQR);
-      };
-
-      // i_IJ -> Integral I, part J
-      double i11 = 0., i21 = 0., i12 = 0., i22 = 0.;
-      // Computing both the parts of the second integral by integrating the
-      // inner integrals w.r.t. phi
-      i21 = ComputeIntegral(inner21, 0, alpha, GaussQR);
-      i22 = ComputeIntegral(inner22, alpha, M_PI / 2, GaussQR);
-      // Computing the first integral
-
-      // part 1 (phi from 0 to alpha)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi
-        double phi = alpha / 2 * (1 + GaussQR.x(i));
-        // Computing inner integral with fixed phi
-        // Inner integral for double integral 1, evaluated with Gauss Legendre
-        // quadrature
-        double inner1 = 0.;
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi / cos(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Evaluating inner1 using Gauss Legendre quadrature
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner1 += GaussQR.w(j) * r * log(D_r_phi(r, phi)) * F(r * sin(phi)) *
-                    G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r from Gauss Legendre nodes
-        inner1 *= rmax / 2;
-        // Multiplying the integrals with appropriate constants for
-        // transformation to phi from Gauss Legendre nodes
-        i11 += GaussQR.w(i) * inner1 * alpha / 2;
-      }
-
-      // part 2 (phi from alpha to pi/2)
-      for (unsigned int i = 0; i < N; ++i) {
-        // Transforming gauss quadrature node into phi (alpha to pi/2)
-        double phi =
-            GaussQR.x(i) * (M_PI / 2. - alpha) / 2. + (M_PI / 2. + alpha) / 2.;
-        // Computing inner integral with fixed phi
-        // Inner integral for double integral 1, evaluated with Gauss Legendre
-        // quadrature
-        double inner1 = 0.;
-        // Upper limit for inner 'r' integral
-        double rmax = length_pi_p / sin(phi);
-        // Evaluating the inner 'r' integral
-        for (unsigned int j = 0; j < N; ++j) {
-          // Evaluating inner1 using Gauss Legendre quadrature
-          double r = rmax / 2 * (1 + GaussQR.x(j));
-          inner1 += GaussQR.w(j) * r * log(D_r_phi(r, phi)) * F(r * sin(phi)) *
-                    G(r * cos(phi));
-        }
-        // Multiplying the integral with appropriate constants for
-        // transformation to r from Gauss Legendre quadrature nodes
-        inner1 *= rmax / 2;
-        // Multiplying the integrals with appropriate constants for
-        // transformation to phi from Gauss Legendre quadrature nodes
-        i12 += GaussQR.w(i) * inner1 * (M_PI / 2. - alpha) / 2.;
-      }
-      // Summing up the parts to get the final integral
-      double integral = 0.5 * (i11 + i12) + (i21 + i22);
-      // Multiplying the integral with appropriate constants for transformation
-      // to local arclength variables
-      integral *= 4. / length_pi / length_pi_p;
-      // Filling up the matrix entry
-      interaction_matrix(i, j) = -1. / (2 * M_PI) * integral;
-    }
-  }
-  return interaction_matrix;
+  // when transforming the parametrizations from [-1,1]->\Pi to local
+  // arclength parametrizations [0,|\Pi|] -> \Pi, swap is used to ensure
+  // that the common point between the panels corresponds to the parameter 0
+  // in both arclength parametrizations
+  bool swap = (pi(1) - pi_p(-1)).norm() / 100. >
+              std::numeric_limits<double>::epsilon();
+  // Panel lengths for local arclength parametrization in
+  // \f$\eqref{eq:ap}\f$. Actual values are not required so a length of 1 is
+  // used for both the panels
+  double length_pi =
+      2 * pi.Derivative(swap ? -1 : 1)
+              .norm(); // Length for panel pi to ensure norm of arclength
+                       // parametrization is 1 at the common point
+  double length_pi_p =
+      2 * pi_p.Derivative(swap ? 1 : -1)
+              .norm(); // Length for panel pi_p to ensure norm of arclength
+                       // parametrization is 1 at the common point
+
+  assert((pi(swap ? -1 : 1) - pi_p(swap ? 1 : -1)).norm() <
+         10. * std::numeric_limits<double>::epsilon());
+  assert(fabs(pi.Derivative(swap ? -1 : 1).norm() * 2 / length_pi - 1.) <
+         10. * std::numeric_limits<double>::epsilon());
+  assert(fabs(pi_p.Derivative(swap ? 1 : -1).norm() * 2 / length_pi_p - 1.) <
+         10. * std::numeric_limits<double>::epsilon());
+
+  // Values of the functions F and G in \f$\eqref{eq:Isplitapn}\f$ for all the
+  // reference shape functions
+  Eigen::VectorXd F(Q), G(Q);
+  // Lambda expression evaluating F and G at the local arclength parameters
+  // t_pr (panel pi_p) and s_pr (panel pi)
+  auto evaluateFG = [&](double t_pr, double s_pr) {
+    // Transforming the local arclength parameters to standard parameter
+    // range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    space.evaluateShapeFunctions(t, F);
+    space.evaluateShapeFunctions(s, G);
+    F *= pi_p.Derivative(t).norm();
+    G *= pi.Derivative(s).norm();
+  };
+
+  auto D_r_phi = [&](double r, double phi) { // \f$\eqref{eq:Ddef}\f$
+    double sqrt_epsilon = std::sqrt(std::numeric_limits<double>::epsilon());
+    // Transforming to local arclength parameter range
+    double s_pr = r * cos(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double s = swap ? 2 * s_pr / length_pi - 1 : 1 - 2 * s_pr / length_pi;
+    // Transforming to local arclength parameter range
+    double t_pr = r * sin(phi);
+    // Transforming to standard parameter range [-1,1] using swap
+    double t = swap ? 1 - 2 * t_pr / length_pi_p : 2 * t_pr / length_pi_p - 1;
+    if (r > sqrt_epsilon) // Away from singularity, simply use the formula
+      return (pi(s) - pi_p(t)).squaredNorm() / r / r;
+    else // Near singularity, use analytically evaluated limit at r -> 0 for
+         // stable evaluation \f$\eqref{eq:Dstab}\f$
+      return 1 + sin(2 * phi) * pi.Derivative(s).dot(pi_p.Derivative(t)) * 4 /
+                     length_pi / length_pi_p;
+  };
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ have to be further
+  // split into two parts part 1 is where phi goes from 0 to alpha part 2 is
+  // where phi goes from alpha to pi/2
+  double alpha = atan(length_pi_p / length_pi); // the split point
+
+  // The two integrals in \f$\eqref{eq:Isplitapn}\f$ for all the pairs of
+  // reference shape functions
+  Eigen::MatrixXd i1 = Eigen::MatrixXd::Zero(Q, Q);
+  Eigen::MatrixXd i2 = Eigen::MatrixXd::Zero(Q, Q);
+  // Adds the weighted products of the current values of F and G to integral
+  auto accumulate = [&](Eigen::MatrixXd &integral, double weight) {
+    for (int I = 0; I < Q; ++I)
+      for (int J = 0; J < Q; ++J)
+        integral(I, J) += weight * F(J) * G(I);
+  };
+
+  // Computing both the integrals for part 1 or part 2, with a single
+  // evaluation of F and G per quadrature node
+  auto integrate_part = [&](bool part1) {
+    AccumulateIntegral(
+        [&](double phi, double w_phi) {
+          // Upper limit for the inner 'r' integrals
+          double rmax = part1 ? length_pi / cos(phi) : length_pi_p / sin(phi);
+          // Inner 'r' integral of the first integral, evaluated with Gauss
+          // Legendre quadrature
+          AccumulateIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i1, w_phi * w_r * r * log(D_r_phi(r, phi)));
+              },
+              0, rmax, GaussQR);
+          // Inner 'r' integral of the second integral, evaluated with log
+          // weighted quadrature
+          AccumulateLoogIntegral(
+              [&](double r, double w_r) {
+                evaluateFG(r * sin(phi), r * cos(phi));
+                accumulate(i2, w_phi * w_r * r);
+              },
+              rmax, GaussQR);
+        },
+        part1 ? 0 : alpha, part1 ? alpha : M_PI / 2, GaussQR);
+  };
+  integrate_part(true);  // part 1 (phi from 0 to alpha)
+  integrate_part(false); // part 2 (phi from alpha to pi/2)
+
+  // Summing up the integrals and multiplying with appropriate constants for
+  // transformation to local arclength variables
+  return -1. / (2 * M_PI) * 4. / length_pi / length_pi_p * (0.5 * i1 + i2);
 }
 
 Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
@@ -296,85 +297,155 @@ Eigen::MatrixXd ComputeIntegralGeneral(const AbstractParametrizedCurve &pi,
                                        const AbstractBEMSpace &space,
                                        const QuadRule &GaussQR) {
   unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
-  // Calculating the quadrature order for stable evaluation of integrands for
-  // disjoint panels as mentioned in \f$\ref{par:distpan}\f$
-  unsigned n0 = 9; // Order for admissible cases
-  // Admissibility criteria
-  double eta = 0.5;
-  // Calculating the quadrature order
-  // N = n0 * std::max(1., 1. + 51 * log(rho(pi, pi_p) / eta));
-  // QuadRule GaussQR = getGaussQR(N);
-  // std::cout << "ComputeIntegralGeneral used with order " << N << std::endl;
+  // The quadrature order for stable evaluation of integrands for disjoint
+  // panels as mentioned in \f$\ref{par:distpan}\f$ is chosen by the caller,
+  // see adaptive_quadrature::SelectOrder()
   // No. of Reference Shape Functions in trial/test space
   int Q = space.getQ();
+  // Tabulating the points and the functions F and G in \f$\eqref{eq:titg}\f$
+  // for Single Layer BIO at the Gauss nodes, the kth column corresponds to
+  // the kth node
+  Eigen::Matrix2Xd pi_nodes(2, N), pi_p_nodes(2, N);
+  Eigen::MatrixXd F(Q, N), G(Q, N);
+  // Reference shape functions at the Gauss nodes
+  Eigen::ArrayXXd shapes = space.tabulateShapeFunctions(GaussQR);
+  for (unsigned int k = 0; k < N; ++k) {
+    double t = GaussQR.x(k);
+    pi_nodes.col(k) = pi(t);
+    pi_p_nodes.col(k) = pi_p(t);
+    double pi_norm = pi.Derivative(t).norm();
+    double pi_p_norm = pi_p.Derivative(t).norm();
+    for (int q = 0; q < Q; ++q) {
+      F(q, k) = shapes(q, k) * pi_p_norm;
+      G(q, k) = shapes(q, k) * pi_norm;
+    }
+  }
   // Interaction matrix with size Q x Q
-  Eigen::MatrixXd interaction_matrix(Q, Q);
-  // Computing the (i,j)th matrix entry
-  for (int i = 0; i < Q; ++i) {
-    for (int j = 0; j < Q; ++j) {
-      // Lambda expression for functions F and G in \f$\eqref{eq:titg}\f$ for
-      // Single Layer BIO
-      auto F = [&](double t) { // Function associated with panel pi_p
-        return space.evaluateShapeFunction(j, t) * pi_p.Derivative(t).norm();
-      };
-
-      auto G = [&](double s) { // Function associated with panel pi
-        return space.evaluateShapeFunction(i, s) * pi.Derivative(s).norm();
-      };
+  Eigen::MatrixXd interaction_matrix = Eigen::MatrixXd::Zero(Q, Q);
+  // Tensor product quadrature rule, evaluating the kernel once per pair of
+  // nodes for all the (I,J) matrix entries
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi_nodes.col(k) - pi_p_nodes.col(l)).norm());
+      for (int I = 0; I < Q; ++I)
+        for (int J = 0; J < Q; ++J)
+          interaction_matrix(I, J) += kernel * F(J, l) * G(I, k);
+    }
+  }
+  return -1. / (2 * M_PI) * interaction_matrix;
+}
 
-      double integral = 0.;
+Eigen::MatrixXd ComputeIntegralGeneral(const PanelGeometryCache &geometry,
+                                       unsigned int i, unsigned int j,
+                                       const AbstractBEMSpace &space,
+                                       const QuadRule &GaussQR) {
+  Eigen::MatrixXd interaction_matrix;
+  ComputeIntegralGeneral(geometry, i, j, TabulatedBEMSpace(space, GaussQR),
+                         GaussQR, interaction_matrix);
+  return interaction_matrix;
+}
 
-      // Tensor product quadrature rule
-      for (unsigned int i = 0; i < N; ++i) {
-        for (unsigned int j = 0; j < N; ++j) {
-          double s = GaussQR.x(i);
-          double t = GaussQR.x(j);
-          integral += GaussQR.w(i) * GaussQR.w(j) *
-                      log((pi(s) - pi_p(t)).norm()) * F(t) * G(s);
-        }
+void ComputeIntegralGeneral(const PanelGeometryCache &geometry, unsigned int i,
+                            unsigned int j, const TabulatedBEMSpace &space,
+                            const QuadRule &GaussQR,
+                            Eigen::MatrixXd &interaction_matrix) {
+  unsigned N = GaussQR.n; // Quadrature order for the GaussQR object.
+  assert(geometry.getNumNodes() == N);
+  // Tabulated points and derivative norms of the panels pi (i) and pi_p (j)
+  PanelGeometryCache::ConstPointsView pi = geometry.getPoints(i);
+  PanelGeometryCache::ConstPointsView pi_p = geometry.getPoints(j);
+  PanelGeometryCache::ConstValuesView pi_norms = geometry.getDerivativeNorms(i);
+  PanelGeometryCache::ConstValuesView pi_p_norms =
+      geometry.getDerivativeNorms(j);
+  // No. of Reference Shape Functions in trial/test space
+  int Q = space.getQ();
+  // Reference shape functions at the Gauss nodes
+  const Eigen::ArrayXXd &shapes = space.getValues();
+  // Interaction matrix with size Q x Q, keeping the storage of the argument
+  interaction_matrix.setZero(Q, Q);
+  // Tensor product quadrature rule, k and l index the nodes on pi and pi_p.
+  // The kernel is evaluated once per pair of nodes for all the (I,J) entries.
+  // The functions F and G in \f$\eqref{eq:titg}\f$ are evaluated on the fly
+  // from the tabulated shape functions, without temporary tables.
+  for (unsigned int k = 0; k < N; ++k) {
+    for (unsigned int l = 0; l < N; ++l) {
+      double kernel = GaussQR.w(k) * GaussQR.w(l) *
+                      log((pi.col(k) - pi_p.col(l)).norm());
+      double pi_norm = pi_norms(k), pi_p_norm = pi_p_norms(l);
+      for (int I = 0; I < Q; ++I) {
+        double G = shapes(I, k) * pi_norm;
+        for (int J = 0; J < Q; ++J)
+          interaction_matrix(I, J) += kernel * (shapes(J, l) * pi_p_norm) * G;
       }
-      // Filling up the matrix entry
-      interaction_matrix(i, j) = -1. / (2 * M_PI) * integral;
     }
   }
-  return interaction_matrix;
+  interaction_matrix *= -1. / (2 * M_PI);
 }
 
 Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh mesh,
                                const AbstractBEMSpace &space,
                                const unsigned int &N) {
-  // Getting the number of panels in the mesh
-  unsigned int numpanels = mesh.getNumPanels();
-  // Getting dimensions of trial/test space
-  unsigned int dims = space.getSpaceDim(numpanels);
-  // Getting the panels from the mesh
-  PanelVector panels = mesh.getPanels();
-  // Getting the number of local shape functions in the trial/test space
-  unsigned int Q = space.getQ();
-  // Initializing the Galerkin matrix with zeros
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return GalerkinMatrix(mesh, geometry, space, GaussQR);
+}
+
+Eigen::MatrixXd GalerkinMatrix(const ParametrizedMesh &mesh,
+                               const PanelGeometryCache &geometry,
+                               const AbstractBEMSpace &space,
+                               const QuadRule &GaussQR) {
+  // Getting the space dimension for the mesh
+  unsigned int dims = space.getSpaceDim(mesh.getNumPanels());
   Eigen::MatrixXd output = Eigen::MatrixXd::Zero(dims, dims);
-  // Panel oriented assembly \f$\ref{pc:ass}\f$
-  QuadRule LogWeightQR = getLogWeightQR(1, N);
-  QuadRule GaussQR = getGaussQR(N);
-  for (unsigned int i = 0; i < numpanels; ++i) {
-    for (unsigned int j = 0; j < numpanels; ++j) {
-      // std::cout << "For panels "<< i <<  "," <<j << " " ;
-      // Getting the interaction matrix for the pair of panels i and j
-      Eigen::MatrixXd interaction_matrix =
-          InteractionMatrix(*panels[i], *panels[j], space, GaussQR);
-      // Local to global mapping of the elements in interaction matrix
-      for (unsigned int I = 0; I < Q; ++I) {
-        for (unsigned int J = 0; J < Q; ++J) {
-          // int II = space.LocGlobMap(I + 1, i + 1, numpanels) - 1;
-          // int JJ = space.LocGlobMap(J + 1, j + 1, numpanels) - 1;
-          int II = space.LocGlobMap2(I + 1, i + 1, mesh) - 1;
-          int JJ = space.LocGlobMap2(J + 1, j + 1, mesh) - 1;
-          // Filling the Galerkin matrix entries
-          output(II, JJ) += interaction_matrix(I, J);
-        }
-      }
-    }
-  }
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$ of the upper triangle,
+  // distributed over threads
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace shapes(space, GaussQR);
+  parallel_assembly::AssembleSymmetricGalerkinMatrix(
+      mesh, dofs,
+      [&](unsigned int i, unsigned int j,
+          Eigen::MatrixXd &interaction_matrix) {
+        // Interaction matrix for the pair of panels i and j
+        InteractionMatrix(geometry, i, j, shapes, GaussQR, interaction_matrix);
+      },
+      [&](unsigned int row, unsigned int col, double value) {
+        output(row, col) += value;
+      });
+  // Mirroring the upper triangle
+  for (unsigned int col = 0; col < dims; ++col)
+    for (unsigned int row = 0; row < col; ++row)
+      output(col, row) = output(row, col);
+  return output;
+}
+
+PackedSymmetricMatrix GalerkinMatrixPacked(const ParametrizedMesh &mesh,
+                                           const AbstractBEMSpace &space,
+                                           const unsigned int &N) {
+  // Getting the space dimension for the mesh
+  PackedSymmetricMatrix output(space.getSpaceDim(mesh.getNumPanels()));
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  // Panel oriented assembly \f$\ref{pc:ass}\f$ of the upper triangle,
+  // distributed over threads
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace shapes(space, GaussQR);
+  parallel_assembly::AssembleSymmetricGalerkinMatrix(
+      mesh, dofs,
+      [&](unsigned int i, unsigned int j,
+          Eigen::MatrixXd &interaction_matrix) {
+        // Interaction matrix for the pair of panels i and j
+        InteractionMatrix(geometry, i, j, shapes, GaussQR, interaction_matrix);
+      },
+      [&](unsigned int row, unsigned int col, double value) {
+        output(row, col) += value;
+      });
   return output;
 }
 
@@ -383,39 +454,177 @@ double Potential(const Eigen::Vector2d &x, const Eigen::VectorXd &coeffs,
                  const unsigned int &N) {
   // Getting the number of panels in the mesh
   unsigned int numpanels = mesh.getNumPanels();
-  // Getting dimensions of BEM space
-  unsigned int dims = space.getSpaceDim(numpanels);
   // asserting that the space dimension matches with coefficients
-  assert(coeffs.rows() == dims);
+  assert(coeffs.rows() == space.getSpaceDim(numpanels));
   // Getting the panels from the mesh
-  PanelVector panels = mesh.getPanels();
+  const PanelVector &panels = mesh.getPanels();
   // Getting the number of local shape functions in the BEM space
   unsigned int Q = space.getQ();
-  // Getting general Gauss Quadrature rule
-  QuadRule GaussQR = getGaussQR(N);
-  // Initializing the single layer potential vector for the bases, with zeros
-  Eigen::VectorXd potentials = Eigen::VectorXd::Zero(dims);
-  // Looping over all the panels
-  for (unsigned panel = 0; panel < numpanels; ++panel) {
-    // Looping over all reference shape functions
-    for (unsigned i = 0; i < Q; ++i) {
-      // The local integrand for a panel and a reference shape function
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Local coefficients on a panel and values of the reference shape functions
+  Eigen::VectorXd local(Q), shapes(Q);
+  double potential = 0.;
+  // Looping over all the panels, without tabulating the geometry
+  for (unsigned int i = 0; i < numpanels; ++i) {
+    const AbstractParametrizedCurve &panel = *panels[i];
+    for (unsigned int I = 0; I < Q; ++I)
+      local(I) = coeffs(space.LocGlobMap2(I + 1, i + 1, mesh) - 1);
+    auto integrand = [&](double t, const Eigen::Vector2d &y,
+                         const Eigen::Vector2d &tangent) {
+      space.evaluateShapeFunctions(t, shapes);
+      // Single Layer Potential
+      return -1. / 2. / M_PI * log((x - y).norm()) * local.dot(shapes) *
+             tangent.norm();
+    };
+    // Gauss rule on the panel, which is subdivided if it is close to x as in
+    // PotentialNearFieldCorrection()
+    potential +=
+        adaptive_quadrature::IntegrateOverPanel(panel, x, integrand, GaussQR);
+  }
+  return potential;
+}
+
+Eigen::VectorXd PotentialNearFieldCorrection(const Eigen::Matrix2Xd &points,
+                                             const Eigen::VectorXd &coeffs,
+                                             const ParametrizedMesh &mesh,
+                                             const PanelGeometryCache &geometry,
+                                             const AbstractBEMSpace &space,
+                                             const QuadRule &GaussQR) {
+  unsigned int N = GaussQR.n;
+  // Number of local shape functions in the BEM space
+  unsigned int Q = space.getQ();
+  Eigen::ArrayXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  // Panels which are too close to the points for the Gauss rule
+  std::vector<std::vector<unsigned int>> near =
+      geometry.findNearPanels(points, adaptive_quadrature::POTENTIAL_RHO);
+  // Tabulating the local to global map of the space
+  DofMap dofs(space, mesh);
+  Eigen::VectorXd corrections = Eigen::VectorXd::Zero(points.cols());
+  parallel_assembly::ParallelFor(0, points.cols(), [&](unsigned int k) {
+    Eigen::Vector2d x = points.col(k);
+    for (unsigned int i : near[k]) {
+      const AbstractParametrizedCurve &panel = geometry.getPanel(i);
+      // Local coefficients on the panel
+      Eigen::VectorXd local(Q);
+      for (unsigned int I = 0; I < Q; ++I)
+        local(I) = coeffs(dofs(I, i));
+      // Values of the reference shape functions in the integrand
+      Eigen::VectorXd shapes(Q);
       auto integrand = [&](double t) {
+        space.evaluateShapeFunctions(t, shapes);
+        double phi = local.dot(shapes);
         // Single Layer Potential
-        return -1. / 2. / M_PI *
-               log((x - panels[panel]->operator()(t)).norm()) *
-               space.evaluateShapeFunction(i, t) *
-               panels[panel]->Derivative(t).norm();
+        return -1. / 2. / M_PI * log((x - panel(t)).norm()) * phi *
+               panel.Derivative(t).norm();
       };
-      // Local to global mapping
-      double local = ComputeIntegral(integrand, -1., 1., GaussQR);
-      //unsigned ii = space.LocGlobMap(i + 1, panel + 1, numpanels) - 1;
-      unsigned ii = space.LocGlobMap2(i + 1, panel + 1, mesh) - 1;
-      // Filling the potentials vector
-      potentials(ii) += local;
+      // Gauss rule on the panel, as in the evaluation for all the panels
+      Eigen::ArrayXd nodes_x = geometry.getPoints(i).row(0).transpose();
+      Eigen::ArrayXd nodes_y = geometry.getPoints(i).row(1).transpose();
+      double fixed = -1. / 4. / M_PI *
+                     (density.segment(i * N, N) *
+                      ((nodes_x - x(0)).square() + (nodes_y - x(1)).square())
+                          .log())
+                         .sum();
+      corrections(k) +=
+          adaptive_quadrature::IntegrateNearPoint(panel, x, integrand,
+                                                  GaussQR) -
+          fixed;
     }
-  }
-  return coeffs.dot(potentials);
+  });
+  return corrections;
+}
+
+Eigen::VectorXd Potentials(const Eigen::Matrix2Xd &points,
+                           const Eigen::VectorXd &coeffs,
+                           const ParametrizedMesh &mesh,
+                           const AbstractBEMSpace &space,
+                           const unsigned int &N) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the quadrature nodes and the weighted density once
+  PanelGeometryCache geometry(mesh, GaussQR);
+  Eigen::ArrayXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  Eigen::ArrayXd nodes_x = geometry.getPoints().row(0).transpose();
+  Eigen::ArrayXd nodes_y = geometry.getPoints().row(1).transpose();
+  Eigen::VectorXd potentials(points.cols());
+  parallel_assembly::ParallelFor(0, points.cols(), [&](unsigned int k) {
+    // Single Layer Potential, using log||x-y|| = log(||x-y||^2) / 2
+    potentials(k) = -1. / 4. / M_PI *
+                    (density * ((nodes_x - points(0, k)).square() +
+                                (nodes_y - points(1, k)).square())
+                                   .log())
+                        .sum();
+  });
+  // Subdividing the panels close to the points
+  return potentials + PotentialNearFieldCorrection(points, coeffs, mesh,
+                                                   geometry, space, GaussQR);
+}
+
+Eigen::VectorXd FastMultipolePotential(const Eigen::Matrix2Xd &points,
+                                       const Eigen::VectorXd &coeffs,
+                                       const ParametrizedMesh &mesh,
+                                       const AbstractBEMSpace &space,
+                                       const unsigned int &N,
+                                       const FastMultipoleOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the quadrature nodes and the weighted density once
+  PanelGeometryCache geometry(mesh, GaussQR);
+  Eigen::VectorXd density =
+      WeightedDensity(geometry, mesh, space, coeffs, GaussQR);
+  // Charges at the quadrature nodes
+  LaplaceFMM fmm(geometry.getPoints(), points, options);
+  Eigen::VectorXd potentials =
+      -1. / 2. / M_PI * fmm.Evaluate(density, Eigen::Matrix2Xd(2, 0));
+  // Subdividing the panels close to the points
+  return potentials + PotentialNearFieldCorrection(points, coeffs, mesh,
+                                                   geometry, space, GaussQR);
+}
+
+HierarchicalMatrix
+HierarchicalGalerkinMatrix(const ParametrizedMesh &mesh,
+                           const AbstractBEMSpace &space,
+                           const unsigned int &N,
+                           const HierarchicalMatrixOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  // Shape functions tabulated once for all the panel pairs
+  TabulatedBEMSpace shapes(space, GaussQR);
+  return HierarchicalMatrix(
+      mesh, geometry, space, space,
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the pair of panels i and j
+        Eigen::MatrixXd interaction_matrix;
+        InteractionMatrix(geometry, i, j, shapes, GaussQR, interaction_matrix);
+        return interaction_matrix;
+      },
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the disjoint panels i and j
+        Eigen::MatrixXd interaction_matrix;
+        ComputeIntegralGeneral(geometry, i, j, shapes, GaussQR,
+                               interaction_matrix);
+        return interaction_matrix;
+      },
+      options);
+}
+
+FastMultipoleOperator
+FastMultipoleGalerkinOperator(const ParametrizedMesh &mesh,
+                              const AbstractBEMSpace &space,
+                              const unsigned int &N,
+                              const FastMultipoleOptions &options) {
+  const QuadRule &GaussQR = getGaussQR(N);
+  // Tabulating the geometry of all the panels at the quadrature nodes
+  PanelGeometryCache geometry(mesh, GaussQR);
+  return FastMultipoleOperator(
+      mesh, geometry, space, space, GaussQR,
+      FastMultipoleOperator::Kernel::SingleLayer,
+      [&](unsigned int i, unsigned int j) {
+        // Interaction matrix for the pair of panels i and j
+        return InteractionMatrix(geometry, i, j, space, GaussQR);
+      },
+      options);
 }
 
 } // namespace single_layer
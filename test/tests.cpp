@@ -8,18 +8,27 @@
 
 #include "BoundaryMesh.hpp"
 #include "abstract_bem_space.hpp"
+#include "adaptive_quadrature.hpp"
 #include "buildK.hpp"
 #include "buildM.hpp"
 #include "buildV.hpp"
 #include "buildW.hpp"
+#include "calderon.hpp"
 #include "continuous_space.hpp"
 #include "dirichlet.hpp"
 #include "discontinuous_space.hpp"
+#include "dof_map.hpp"
 #include "doubleLayerPotential.hpp"
 #include "double_layer.hpp"
+#include "fast_multipole.hpp"
+#include "hierarchical_matrix.hpp"
 #include "hypersingular.hpp"
 #include "integral_gauss.hpp"
+#include "iterative_solvers.hpp"
 #include "neumann.hpp"
+#include "packed_symmetric_matrix.hpp"
+#include "panel_geometry_cache.hpp"
+#include "parallel_assembly.hpp"
 #include "parametrized_circular_arc.hpp"
 #include "parametrized_fourier_sum.hpp"
 #include "parametrized_line.hpp"
@@ -194,6 +203,61 @@ TEST(IntegralGauss, ComputeIntegral) {
   EXPECT_NEAR(integral, 1. / 3., eps);
 }
 
+TEST(IntegralGauss, AccumulateIntegral) {
+  // The accumulated quadratures should agree with the scalar versions
+  QuadRule GaussQR = getGaussQR(10);
+  auto f = [](double x) { return cos(x) * x; };
+  double integral = 0., log_integral = 0.;
+  parametricbem2d::AccumulateIntegral(
+      [&](double x, double w) { integral += w * f(x); }, 0.5, 2., GaussQR);
+  parametricbem2d::AccumulateLoogIntegral(
+      [&](double x, double w) { log_integral += w * f(x); }, 2., GaussQR);
+  EXPECT_NEAR(integral, parametricbem2d::ComputeIntegral(f, 0.5, 2., GaussQR),
+              eps);
+  EXPECT_NEAR(log_integral,
+              parametricbem2d::ComputeLoogIntegral(f, 2., GaussQR), eps);
+}
+
+TEST(IntegralGauss, LogWeightQRView) {
+  // The stored rules should integrate \f$\int_{0}^{1} \log(x) x^{k} dx\f$
+  // exactly for low k and agree with the rules returned as vectors
+  for (int N : {2, 7, 64, 256}) {
+    LogWeightQRView view = getLogWeightQRView(N);
+    std::vector<double> wts, pts;
+    std::tie(pts, wts) = getLogWeightQR(N);
+    EXPECT_EQ(view.n, static_cast<std::size_t>(N));
+    double integral = 0.;
+    for (int i = 0; i < N; ++i) {
+      EXPECT_EQ(view.x[i], pts[i]);
+      EXPECT_EQ(view.w[i], wts[i]);
+      integral += view.w[i] * view.x[i];
+    }
+    EXPECT_NEAR(integral, -0.25, eps);
+  }
+  EXPECT_THROW(getLogWeightQRView(1), std::range_error);
+  EXPECT_THROW(getLogWeightQRView(257), std::range_error);
+}
+
+TEST(IntegralGauss, CachedGaussQR) {
+  // Repeated requests return the same stored rule, also from several threads
+  const QuadRule &rule = getGaussQR(17);
+  EXPECT_EQ(&rule, &getGaussQR(17));
+  EXPECT_EQ(rule.n, 17);
+  EXPECT_NEAR(rule.w.sum(), 2., eps);
+  std::vector<const QuadRule *> rules(8);
+  parametricbem2d::parallel_assembly::setNumThreads(4);
+  parametricbem2d::parallel_assembly::ParallelFor(
+      0, 8, [&](unsigned k) { rules[k] = &getGaussQR(20 + k % 2); });
+  parametricbem2d::parallel_assembly::setNumThreads(0);
+  for (unsigned k = 0; k < 8; ++k)
+    EXPECT_EQ(rules[k], &getGaussQR(20 + k % 2));
+  // Orders beyond the table of atomic pointers are cached as well
+  const QuadRule &high = getGaussQR(200);
+  EXPECT_EQ(&high, &getGaussQR(200));
+  EXPECT_EQ(high.n, 200);
+  EXPECT_NEAR(high.w.sum(), 2., eps);
+}
+
 TEST(BemSpace, DiscontinuousSpace0) {
   // Test for DiscontinuousSpace<0>
   parametricbem2d::AbstractBEMSpace *space =
@@ -1719,6 +1783,977 @@ TEST(StableEvaluationOfIntegrands, DISABLED_DoubleLayer) {
   // EXPECT_NEAR((sol_old - solnew).norm(), 0, eps);
 }
 
+TEST(ParallelAssembly, ThreadCountIndependence) {
+  // Checking that the multithreaded assembly gives the same result as the
+  // serial assembly, bit by bit
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1., 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(10));
+  parametricbem2d::ContinuousSpace<1> trial_space;
+  parametricbem2d::DiscontinuousSpace<0> test_space;
+  parametricbem2d::parallel_assembly::setNumThreads(1);
+  Eigen::MatrixXd V_serial =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, test_space, 8);
+  Eigen::MatrixXd K_serial = parametricbem2d::double_layer::GalerkinMatrix(
+      mesh, trial_space, test_space, 8);
+  Eigen::MatrixXd W_serial =
+      parametricbem2d::hypersingular::GalerkinMatrix(mesh, trial_space, 8);
+  parametricbem2d::parallel_assembly::setNumThreads(4);
+  Eigen::MatrixXd V_parallel =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, test_space, 8);
+  Eigen::MatrixXd K_parallel = parametricbem2d::double_layer::GalerkinMatrix(
+      mesh, trial_space, test_space, 8);
+  Eigen::MatrixXd W_parallel =
+      parametricbem2d::hypersingular::GalerkinMatrix(mesh, trial_space, 8);
+  // Restoring the automatic choice of thread count
+  parametricbem2d::parallel_assembly::setNumThreads(0);
+  EXPECT_TRUE(V_serial == V_parallel);
+  EXPECT_TRUE(K_serial == K_parallel);
+  EXPECT_TRUE(W_serial == W_parallel);
+}
+
+TEST(PanelGeometryCache, DisjointInteractionMatrix) {
+  // Checking the tabulated geometry and the interaction matrices computed
+  // from it against direct evaluation of the parametrizations
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1., 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(8));
+  parametricbem2d::PanelVector panels = mesh.getPanels();
+  QuadRule GaussQR = getGaussQR(6);
+  parametricbem2d::PanelGeometryCache geometry(mesh, GaussQR);
+  EXPECT_EQ(geometry.getNumPanels(), 8);
+  EXPECT_EQ(geometry.getNumNodes(), 6);
+  double t = GaussQR.x(2);
+  EXPECT_NEAR((geometry.getPoints(3).col(2) - (*panels[3])(t)).norm(), 0, eps);
+  EXPECT_NEAR(geometry.getDerivativeNorms(3)(2),
+              panels[3]->Derivative(t).norm(), eps);
+  // The outward normal of a counter clockwise circle is radial
+  EXPECT_NEAR((geometry.getNormals(3).col(2) - (*panels[3])(t)).norm(), 0,
+              eps);
+  parametricbem2d::ContinuousSpace<1> trial_space;
+  parametricbem2d::DiscontinuousSpace<1> test_space;
+  Eigen::MatrixXd V_direct = parametricbem2d::single_layer::
+      ComputeIntegralGeneral(*panels[0], *panels[4], test_space, GaussQR);
+  Eigen::MatrixXd V_cached = parametricbem2d::single_layer::
+      ComputeIntegralGeneral(geometry, 0, 4, test_space, GaussQR);
+  Eigen::MatrixXd K_direct = parametricbem2d::double_layer::
+      ComputeIntegralGeneral(*panels[0], *panels[4], trial_space, test_space,
+                             GaussQR);
+  Eigen::MatrixXd K_cached = parametricbem2d::double_layer::
+      ComputeIntegralGeneral(geometry, 0, 4, trial_space, test_space, GaussQR);
+  Eigen::MatrixXd W_direct = parametricbem2d::hypersingular::
+      ComputeIntegralGeneral(*panels[0], *panels[4], trial_space, GaussQR);
+  Eigen::MatrixXd W_cached = parametricbem2d::hypersingular::
+      ComputeIntegralGeneral(geometry, 0, 4, trial_space, GaussQR);
+  EXPECT_NEAR((V_direct - V_cached).norm(), 0, eps);
+  EXPECT_NEAR((K_direct - K_cached).norm(), 0, eps);
+  EXPECT_NEAR((W_direct - W_cached).norm(), 0, eps);
+}
+
+TEST(AdaptiveQuadrature, DisjointPanelOrders) {
+  // Choosing the order for disjoint panels adaptively should keep the
+  // Galerkin matrices within the accuracy target
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1., 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(32));
+  parametricbem2d::DiscontinuousSpace<0> space;
+  Eigen::MatrixXd V = parametricbem2d::single_layer::GalerkinMatrix(mesh,
+                                                                    space, 12);
+  // Well separated panels need only a few nodes
+  EXPECT_EQ(parametricbem2d::adaptive_quadrature::SelectOrder(0.1, 1e-8, 12),
+            3);
+  // Orders are limited by the order of the given rule
+  EXPECT_EQ(parametricbem2d::adaptive_quadrature::SelectOrder(50., 1e-8, 12),
+            12);
+  parametricbem2d::adaptive_quadrature::setAccuracy(1e-8);
+  parametricbem2d::adaptive_quadrature::resetOrderHistogram();
+  Eigen::MatrixXd V_adaptive =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, space, 12);
+  std::vector<unsigned long> histogram =
+      parametricbem2d::adaptive_quadrature::getOrderHistogram();
+  parametricbem2d::adaptive_quadrature::setAccuracy(0);
+  EXPECT_NEAR((V - V_adaptive).norm() / V.norm(), 0, 1e-8);
+  // The 32 x 29 / 2 disjoint pairs of the upper triangle are recorded, most
+  // with a low order
+  unsigned long total = 0;
+  for (unsigned long count : histogram)
+    total += count;
+  EXPECT_EQ(total, 32 * 29 / 2);
+  EXPECT_LE(histogram.size(), 13);
+  EXPECT_GT(histogram[3] + histogram[4], total / 2);
+  // The lower orders use the geometry tabulated once per order
+  const QuadRule &GaussQR = getGaussQR(12);
+  parametricbem2d::PanelGeometryCache geometry(mesh, GaussQR);
+  const parametricbem2d::PanelGeometryCache &lower = geometry.getLowerOrder(4);
+  EXPECT_EQ(&lower, &geometry.getLowerOrder(4));
+  EXPECT_EQ(lower.getNumNodes(), 4);
+  Eigen::MatrixXd V_lower = parametricbem2d::single_layer::
+      ComputeIntegralGeneral(lower, 0, 16, space, getGaussQR(4));
+  Eigen::MatrixXd V_direct = parametricbem2d::single_layer::
+      ComputeIntegralGeneral(mesh.getPanel(0), mesh.getPanel(16), space,
+                             getGaussQR(4));
+  EXPECT_NEAR((V_lower - V_direct).norm(), 0, eps);
+}
+
+TEST(SymmetricAssembly, PackedStorage) {
+  // The single layer and hypersingular Galerkin matrices are assembled from
+  // the upper panel pair triangle and are exactly symmetric
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1., 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(10));
+  parametricbem2d::ContinuousSpace<1> space;
+  Eigen::MatrixXd V =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, space, 8);
+  Eigen::MatrixXd W =
+      parametricbem2d::hypersingular::GalerkinMatrix(mesh, space, 8);
+  EXPECT_EQ((V - V.transpose()).norm(), 0);
+  EXPECT_EQ((W - W.transpose()).norm(), 0);
+  // Comparing with the interaction matrices of all the panel pairs
+  parametricbem2d::PanelVector panels = mesh.getPanels();
+  QuadRule GaussQR = getGaussQR(8);
+  Eigen::MatrixXd V_full = Eigen::MatrixXd::Zero(V.rows(), V.cols());
+  for (unsigned i = 0; i < 10; ++i) {
+    for (unsigned j = 0; j < 10; ++j) {
+      Eigen::MatrixXd interaction_matrix =
+          parametricbem2d::single_layer::InteractionMatrix(
+              *panels[i], *panels[j], space, GaussQR);
+      for (unsigned I = 0; I < 2; ++I)
+        for (unsigned J = 0; J < 2; ++J)
+          V_full(space.LocGlobMap2(I + 1, i + 1, mesh) - 1,
+                 space.LocGlobMap2(J + 1, j + 1, mesh) - 1) +=
+              interaction_matrix(I, J);
+    }
+  }
+  EXPECT_NEAR((V - V_full).norm(), 0, eps);
+  parametricbem2d::PackedSymmetricMatrix V_packed =
+      parametricbem2d::single_layer::GalerkinMatrixPacked(mesh, space, 8);
+  EXPECT_EQ(V_packed.getData().size(), 55);
+  EXPECT_EQ((V_packed.toDense() - V).norm(), 0);
+  EXPECT_EQ(V_packed(2, 7), V(7, 2));
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(10, -1, 2);
+  EXPECT_NEAR((V_packed * x - V * x).norm(), 0, eps);
+}
+
+TEST(Calderon, AssembleCalderonBlocks) {
+  // Quadrilateral without symmetries, such that K' differs from K
+  Eigen::Vector2d a(0, 0), b(3, 0), c(2.5, 1), d(0.2, 2);
+  parametricbem2d::ParametrizedLine l1(a, b), l2(b, c), l3(c, d), l4(d, a);
+  parametricbem2d::PanelVector panels, p;
+  for (parametricbem2d::ParametrizedLine *line : {&l1, &l2, &l3, &l4}) {
+    p = line->split(3);
+    panels.insert(panels.end(), p.begin(), p.end());
+  }
+  parametricbem2d::ParametrizedMesh mesh(panels);
+  parametricbem2d::DiscontinuousSpace<0> neumann_space;
+  parametricbem2d::ContinuousSpace<1> dirichlet_space;
+  parametricbem2d::calderon::CalderonBlocks blocks =
+      parametricbem2d::calderon::AssembleCalderonBlocks(mesh, neumann_space,
+                                                        dirichlet_space, 8);
+  // The shared geometry gives the same matrices as separate assembly
+  EXPECT_EQ((blocks.V - parametricbem2d::single_layer::GalerkinMatrix(
+                            mesh, neumann_space, 8))
+                .norm(),
+            0);
+  EXPECT_EQ((blocks.K - parametricbem2d::double_layer::GalerkinMatrix(
+                            mesh, dirichlet_space, neumann_space, 8))
+                .norm(),
+            0);
+  EXPECT_EQ((blocks.W - parametricbem2d::hypersingular::GalerkinMatrix(
+                            mesh, dirichlet_space, 8))
+                .norm(),
+            0);
+  Eigen::MatrixXd Kp = parametricbem2d::adj_double_layer::GalerkinMatrix(
+      mesh, neumann_space, dirichlet_space, 8);
+  EXPECT_EQ((blocks.Kp() - Kp).norm(), 0);
+  parametricbem2d::calderon::DoubleLayerOperators ops(mesh, dirichlet_space,
+                                                      neumann_space, 8);
+  EXPECT_EQ((ops.getKp() - Kp).norm(), 0);
+  // Entry of K' for two panels on different sides, with the kernel
+  // \f$\frac{\partial}{\partial n_{x}} G(x,y)\f$ evaluated directly
+  Eigen::MatrixXd Kp_d0 = parametricbem2d::adj_double_layer::GalerkinMatrix(
+      mesh, neumann_space, neumann_space, 8);
+  QuadRule GaussQR = getGaussQR(16);
+  unsigned i = 1, j = 7;
+  double integral = 0;
+  for (unsigned k = 0; k < GaussQR.n; ++k) {
+    for (unsigned l = 0; l < GaussQR.n; ++l) {
+      Eigen::Vector2d x = panels[i]->operator()(GaussQR.x(k));
+      Eigen::Vector2d y = panels[j]->operator()(GaussQR.x(l));
+      Eigen::Vector2d tangent = panels[i]->Derivative(GaussQR.x(k));
+      Eigen::Vector2d normal(tangent(1), -tangent(0));
+      integral += GaussQR.w(k) * GaussQR.w(l) * (y - x).dot(normal) /
+                  (x - y).squaredNorm() / (2 * M_PI) *
+                  panels[j]->Derivative(GaussQR.x(l)).norm();
+    }
+  }
+  EXPECT_NEAR(Kp_d0(i, j), integral, eps);
+  EXPECT_GT(std::fabs(Kp_d0(i, j) - Kp_d0(j, i)), 1e-3);
+}
+
+TEST(SingleLayerHypersingular, GalerkinMatrices) {
+  // V and W assembled together are identical to the separate assembly
+  // Kite shaped curve
+  Eigen::MatrixXd a(2, 2), b(2, 2);
+  a << 1., 0.2, 0., 0.;
+  b << 0., 0., 0.6, 0.;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0, 0), a, b,
+                                                0, 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(12));
+  parametricbem2d::DiscontinuousSpace<0> sl_space;
+  parametricbem2d::ContinuousSpace<1> hs_space;
+  Eigen::MatrixXd V, W;
+  std::tie(V, W) = parametricbem2d::hypersingular::GalerkinMatrices(
+      mesh, sl_space, hs_space, 10);
+  EXPECT_EQ(
+      (V - parametricbem2d::single_layer::GalerkinMatrix(mesh, sl_space, 10))
+          .norm(),
+      0);
+  EXPECT_EQ(
+      (W - parametricbem2d::hypersingular::GalerkinMatrix(mesh, hs_space, 10))
+          .norm(),
+      0);
+}
+
+TEST(IterativeSolvers, CGAndGMRES) {
+  // Symmetric positive definite and nonsymmetric test matrices
+  unsigned n = 40;
+  Eigen::MatrixXd B = Eigen::MatrixXd::Random(n, n);
+  Eigen::MatrixXd A_spd =
+      B * B.transpose() + n * Eigen::MatrixXd::Identity(n, n);
+  Eigen::MatrixXd A = B + n * Eigen::MatrixXd::Identity(n, n);
+  Eigen::VectorXd b = Eigen::VectorXd::LinSpaced(n, -1, 1);
+  parametricbem2d::iterative_solvers::SolverOptions options;
+  options.tolerance = 1e-12;
+  parametricbem2d::iterative_solvers::SolverResult cg =
+      parametricbem2d::iterative_solvers::CG(
+          [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+            return A_spd * x;
+          },
+          b, options);
+  EXPECT_TRUE(cg.converged);
+  EXPECT_EQ(cg.residuals.size(), cg.iterations + 1);
+  EXPECT_LE(cg.residuals.back(), options.tolerance);
+  EXPECT_NEAR((A_spd * cg.solution - b).norm(), 0, 1e-10);
+  // GMRES with restarts
+  options.restart = 5;
+  parametricbem2d::iterative_solvers::SolverResult gmres =
+      parametricbem2d::iterative_solvers::GMRES(
+          [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return A * x; },
+          b, options);
+  EXPECT_TRUE(gmres.converged);
+  EXPECT_GT(gmres.iterations, options.restart);
+  EXPECT_EQ(gmres.residuals.size(), gmres.iterations + 1);
+  EXPECT_NEAR((A * gmres.solution - b).norm(), 0, 1e-10);
+  // Stopping at the maximum number of iterations
+  options.max_iterations = 3;
+  gmres = parametricbem2d::iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return A * x; }, b,
+      options);
+  EXPECT_FALSE(gmres.converged);
+  EXPECT_EQ(gmres.iterations, 3);
+  // Breakdown for a singular matrix which maps b to zero, the iterate zero is
+  // returned
+  Eigen::MatrixXd S = Eigen::MatrixXd::Zero(2, 2);
+  S(0, 1) = 1;
+  gmres = parametricbem2d::iterative_solvers::GMRES(
+      [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return S * x; },
+      Eigen::Vector2d(1, 0), options);
+  EXPECT_FALSE(gmres.converged);
+  EXPECT_EQ(gmres.iterations, 1);
+  EXPECT_TRUE(gmres.solution.allFinite());
+  EXPECT_EQ(gmres.solution.norm(), 0);
+}
+
+TEST(IterativeSolvers, BoundaryValueProblems) {
+  // The iterative solvers give the same solutions as the direct ones. The
+  // radius is small enough for V to be positive definite.
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 0.4, 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(32));
+  std::function<double(double, double)> g = [](double x, double y) {
+    return x * x - y * y + x;
+  };
+  std::function<double(double, double)> Tn = [](double x, double y) {
+    return (2 * x * x - 2 * y * y + x) / 0.4;
+  };
+  unsigned order = 8;
+  parametricbem2d::iterative_solvers::SolverOptions options;
+  options.tolerance = 1e-12;
+  parametricbem2d::iterative_solvers::SolverResult result =
+      parametricbem2d::dirichlet_bvp::direct_first_kind::solve(mesh, g, order,
+                                                               options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_NEAR((result.solution - parametricbem2d::dirichlet_bvp::
+                                     direct_first_kind::solve(mesh, g, order))
+                  .norm(),
+              0, 1e-9);
+  result = parametricbem2d::dirichlet_bvp::indirect_second_kind::solve(
+      mesh, g, order, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_NEAR((result.solution - parametricbem2d::dirichlet_bvp::
+                                     indirect_second_kind::solve(mesh, g, order))
+                  .norm(),
+              0, 1e-9);
+  result = parametricbem2d::neumann_bvp::direct_first_kind::solve(
+      mesh, Tn, order, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_NEAR((result.solution - parametricbem2d::neumann_bvp::
+                                     direct_first_kind::solve(mesh, Tn, order))
+                  .norm(),
+              0, 1e-9);
+  result = parametricbem2d::neumann_bvp::direct_second_kind::solve(
+      mesh, Tn, order, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_NEAR((result.solution - parametricbem2d::neumann_bvp::
+                                     direct_second_kind::solve(mesh, Tn, order))
+                  .norm(),
+              0, 1e-9);
+}
+
+TEST(HierarchicalMatrix, SingleAndDoubleLayer) {
+  // Kite shaped curve
+  Eigen::MatrixXd a(2, 2), b(2, 2);
+  a << 1., 0.2, 0., 0.;
+  b << 0., 0., 0.6, 0.;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0, 0), a, b,
+                                                0, 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(256));
+  parametricbem2d::DiscontinuousSpace<0> space_0;
+  parametricbem2d::ContinuousSpace<1> space_1;
+  parametricbem2d::HierarchicalMatrixOptions options;
+  options.leafsize = 8;
+  parametricbem2d::HierarchicalMatrix V_h =
+      parametricbem2d::single_layer::HierarchicalGalerkinMatrix(
+          mesh, space_0, 4, options);
+  Eigen::MatrixXd V =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, space_0, 4);
+  EXPECT_GT(V_h.getNumLowRankBlocks(), 0);
+  EXPECT_LT(V_h.getNumStoredEntries(), V.size());
+  EXPECT_LT((V_h.toDense() - V).norm(), 1e-7 * V.norm());
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(V.cols(), -1, 2);
+  EXPECT_LT((V_h * x - V * x).norm(), 1e-7 * (V * x).norm());
+  // The Double Layer matrix for a continuous trial space
+  parametricbem2d::HierarchicalMatrix K_h =
+      parametricbem2d::double_layer::HierarchicalGalerkinMatrix(
+          mesh, space_1, space_0, 4, options);
+  Eigen::MatrixXd K = parametricbem2d::double_layer::GalerkinMatrix(
+      mesh, space_1, space_0, 4);
+  EXPECT_EQ(K_h.rows(), K.rows());
+  EXPECT_EQ(K_h.cols(), K.cols());
+  x = Eigen::VectorXd::LinSpaced(K.cols(), -1, 2);
+  EXPECT_LT((K_h * x - K * x).norm(), 1e-7 * (K * x).norm());
+  // Unit square, where the Double Layer blocks of far panels on the same side
+  // are exactly zero and are kept as blocks of rank 0
+  Eigen::Vector2d corners[] = {Eigen::Vector2d(0, 0), Eigen::Vector2d(1, 0),
+                               Eigen::Vector2d(1, 1), Eigen::Vector2d(0, 1)};
+  parametricbem2d::PanelVector panels;
+  for (unsigned int side = 0; side < 4; ++side) {
+    parametricbem2d::ParametrizedLine line(corners[side],
+                                           corners[(side + 1) % 4]);
+    parametricbem2d::PanelVector side_panels = line.split(64);
+    panels.insert(panels.end(), side_panels.begin(), side_panels.end());
+  }
+  parametricbem2d::ParametrizedMesh square(panels);
+  parametricbem2d::HierarchicalMatrix K_square_h =
+      parametricbem2d::double_layer::HierarchicalGalerkinMatrix(
+          square, space_0, space_0, 4, options);
+  Eigen::MatrixXd K_square = parametricbem2d::double_layer::GalerkinMatrix(
+      square, space_0, space_0, 4);
+  EXPECT_GT(K_square_h.getNumLowRankBlocks(), 0);
+  EXPECT_LT((K_square_h.toDense() - K_square).norm(), 1e-7 * K_square.norm());
+  x = Eigen::VectorXd::LinSpaced(K_square.cols(), -1, 2);
+  EXPECT_LT((K_square_h * x - K_square * x).norm(),
+            1e-7 * (K_square * x).norm());
+  // Annulus with the boundaries in either order, the clusters are found from
+  // the geometry and do not depend on the numbering of the panels
+  parametricbem2d::ParametrizedCircularArc outer(Eigen::Vector2d(0, 0), 1, 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedCircularArc inner(Eigen::Vector2d(0.2, 0), 0.3,
+                                                 2 * M_PI, 0);
+  parametricbem2d::PanelVector outer_panels = outer.split(128);
+  parametricbem2d::PanelVector inner_panels = inner.split(128);
+  panels = outer_panels;
+  panels.insert(panels.end(), inner_panels.begin(), inner_panels.end());
+  parametricbem2d::ParametrizedMesh annulus(panels);
+  panels = inner_panels;
+  panels.insert(panels.end(), outer_panels.begin(), outer_panels.end());
+  parametricbem2d::ParametrizedMesh annulus_swapped(panels);
+  parametricbem2d::HierarchicalMatrix V_annulus_h =
+      parametricbem2d::single_layer::HierarchicalGalerkinMatrix(
+          annulus, space_0, 4, options);
+  parametricbem2d::HierarchicalMatrix V_swapped_h =
+      parametricbem2d::single_layer::HierarchicalGalerkinMatrix(
+          annulus_swapped, space_0, 4, options);
+  Eigen::MatrixXd V_annulus =
+      parametricbem2d::single_layer::GalerkinMatrix(annulus, space_0, 4);
+  EXPECT_LT(V_annulus_h.getNumStoredEntries(), V_annulus.size());
+  EXPECT_LT(V_swapped_h.getNumStoredEntries(), V_annulus.size());
+  EXPECT_LT((V_annulus_h.toDense() - V_annulus).norm(),
+            1e-7 * V_annulus.norm());
+  // The swapped numbering exchanges the blocks of the boundaries
+  Eigen::MatrixXd V_swapped = V_swapped_h.toDense();
+  Eigen::MatrixXd V_unswapped(V_swapped.rows(), V_swapped.cols());
+  V_unswapped << V_swapped.bottomRightCorner(128, 128),
+      V_swapped.bottomLeftCorner(128, 128),
+      V_swapped.topRightCorner(128, 128), V_swapped.topLeftCorner(128, 128);
+  EXPECT_LT((V_unswapped - V_annulus).norm(), 1e-7 * V_annulus.norm());
+}
+
+TEST(FastMultipole, SingleAndDoubleLayer) {
+  // Kite shaped curve
+  Eigen::MatrixXd a(2, 2), b(2, 2);
+  a << 1., 0.2, 0., 0.;
+  b << 0., 0., 0.6, 0.;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0, 0), a, b,
+                                                0, 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(128));
+  parametricbem2d::DiscontinuousSpace<0> space_0;
+  parametricbem2d::ContinuousSpace<1> space_1;
+  parametricbem2d::FastMultipoleOptions options;
+  options.leafsize = 16;
+  parametricbem2d::FastMultipoleOperator V_fmm =
+      parametricbem2d::single_layer::FastMultipoleGalerkinOperator(
+          mesh, space_1, 6, options);
+  Eigen::MatrixXd V =
+      parametricbem2d::single_layer::GalerkinMatrix(mesh, space_1, 6);
+  EXPECT_EQ(V_fmm.rows(), V.rows());
+  EXPECT_EQ(V_fmm.cols(), V.cols());
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(V.cols(), -1, 2);
+  EXPECT_LT((V_fmm * x - V * x).norm(), 1e-10 * (V * x).norm());
+  // The Double Layer matrix for a continuous trial space
+  parametricbem2d::FastMultipoleOperator K_fmm =
+      parametricbem2d::double_layer::FastMultipoleGalerkinOperator(
+          mesh, space_1, space_0, 6, options);
+  Eigen::MatrixXd K = parametricbem2d::double_layer::GalerkinMatrix(
+      mesh, space_1, space_0, 6);
+  EXPECT_EQ(K_fmm.rows(), K.rows());
+  EXPECT_EQ(K_fmm.cols(), K.cols());
+  EXPECT_LT((K_fmm * x - K * x).norm(), 1e-10 * (K * x).norm());
+}
+
+TEST(Potential, BatchedEvaluation) {
+  // Kite shaped curve
+  Eigen::MatrixXd a(2, 2), b(2, 2);
+  a << 1., 0.2, 0., 0.;
+  b << 0., 0., 0.6, 0.;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0, 0), a, b,
+                                                0, 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(32));
+  parametricbem2d::ContinuousSpace<1> space;
+  unsigned order = 8;
+  Eigen::VectorXd coeffs =
+      Eigen::VectorXd::LinSpaced(space.getSpaceDim(32), -1, 2);
+  // Evaluation points inside and outside the curve
+  Eigen::Matrix2Xd points(2, 6);
+  points << 0., 0.3, -0.5, 1.5, -2., 0.1, 0., 0.2, 0.1, 0.4, -1., 1.;
+  Eigen::VectorXd sl = parametricbem2d::single_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  Eigen::VectorXd dl = parametricbem2d::double_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  ASSERT_EQ(sl.size(), points.cols());
+  ASSERT_EQ(dl.size(), points.cols());
+  for (unsigned k = 0; k < points.cols(); ++k) {
+    EXPECT_NEAR(sl(k),
+                parametricbem2d::single_layer::Potential(points.col(k), coeffs,
+                                                         mesh, space, order),
+                1e-12);
+    EXPECT_NEAR(dl(k),
+                parametricbem2d::double_layer::Potential(points.col(k), coeffs,
+                                                         mesh, space, order),
+                1e-12);
+  }
+}
+
+TEST(Potential, FastMultipoleEvaluation) {
+  // Kite shaped curve
+  Eigen::MatrixXd a(2, 2), b(2, 2);
+  a << 1., 0.2, 0., 0.;
+  b << 0., 0., 0.6, 0.;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0, 0), a, b,
+                                                0, 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(64));
+  parametricbem2d::ContinuousSpace<1> space;
+  unsigned order = 8;
+  Eigen::VectorXd coeffs =
+      Eigen::VectorXd::LinSpaced(space.getSpaceDim(64), -1, 2);
+  // Grid of evaluation points around the curve
+  unsigned n = 30;
+  Eigen::Matrix2Xd points(2, n * n);
+  for (unsigned i = 0; i < n; ++i)
+    for (unsigned j = 0; j < n; ++j)
+      points.col(i * n + j) << -2. + 4. * i / (n - 1), -2. + 4. * j / (n - 1);
+  Eigen::VectorXd sl = parametricbem2d::single_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  Eigen::VectorXd sl_fmm =
+      parametricbem2d::single_layer::FastMultipolePotential(
+          points, coeffs, mesh, space, order);
+  EXPECT_LT((sl_fmm - sl).norm(), 1e-10 * sl.norm());
+  Eigen::VectorXd dl = parametricbem2d::double_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  Eigen::VectorXd dl_fmm =
+      parametricbem2d::double_layer::FastMultipolePotential(
+          points, coeffs, mesh, space, order);
+  EXPECT_LT((dl_fmm - dl).norm(), 1e-10 * dl.norm());
+}
+
+TEST(Potential, NearBoundaryEvaluation) {
+  // Circle of radius R with a constant density, the Single Layer Potential
+  // is -R log(R) inside and -R log(|x|) outside, the Double Layer Potential
+  // is -1 inside and 0 outside
+  double R = 0.5;
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), R, 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(16));
+  parametricbem2d::DiscontinuousSpace<0> space;
+  Eigen::VectorXd coeffs = Eigen::VectorXd::Ones(16);
+  // Points at relative distances 1e-1, 1e-2 and 1e-3 inside and outside
+  Eigen::Matrix2Xd points(2, 6);
+  Eigen::VectorXd sl_exact(6), dl_exact(6);
+  for (unsigned k = 0; k < 3; ++k) {
+    double delta = std::pow(10., -1. - k);
+    points.col(2 * k) << R * (1 - delta) * std::cos(0.3 * k),
+        R * (1 - delta) * std::sin(0.3 * k);
+    points.col(2 * k + 1) << R * (1 + delta) * std::cos(0.3 * k),
+        R * (1 + delta) * std::sin(0.3 * k);
+    sl_exact(2 * k) = -R * std::log(R);
+    sl_exact(2 * k + 1) = -R * std::log(R * (1 + delta));
+    dl_exact(2 * k) = -1;
+    dl_exact(2 * k + 1) = 0;
+  }
+  unsigned order = 8;
+  Eigen::VectorXd sl = parametricbem2d::single_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  Eigen::VectorXd dl = parametricbem2d::double_layer::Potentials(
+      points, coeffs, mesh, space, order);
+  Eigen::VectorXd sl_fmm =
+      parametricbem2d::single_layer::FastMultipolePotential(
+          points, coeffs, mesh, space, order);
+  Eigen::VectorXd dl_fmm =
+      parametricbem2d::double_layer::FastMultipolePotential(
+          points, coeffs, mesh, space, order);
+  for (unsigned k = 0; k < 6; ++k) {
+    EXPECT_NEAR(sl(k), sl_exact(k), 1e-10);
+    EXPECT_NEAR(dl(k), dl_exact(k), 1e-10);
+    EXPECT_NEAR(sl_fmm(k), sl_exact(k), 1e-10);
+    EXPECT_NEAR(dl_fmm(k), dl_exact(k), 1e-10);
+  }
+}
+
+TEST(Parametrizations, BatchedEvaluation) {
+  using namespace parametricbem2d;
+  // One curve of every type
+  Eigen::MatrixXd cos_list(2, 2), sin_list(2, 2), poly_coeffs(2, 4);
+  cos_list << 0.25, 0.1, 0, 0;
+  sin_list << 0, 0, 0.375, -0.05;
+  poly_coeffs << 0, 1, 0.5, -0.25, 0, 0.5, 1, 0.125;
+  PanelVector curves = {
+      std::make_shared<ParametrizedLine>(Eigen::Vector2d(0, 0),
+                                         Eigen::Vector2d(1, 2)),
+      std::make_shared<ParametrizedCircularArc>(Eigen::Vector2d(0, 1), 0.5,
+                                                0.25, 2.),
+      std::make_shared<ParametrizedFourierSum>(Eigen::Vector2d(0.5, 0),
+                                               cos_list, sin_list, -0.5, 2.),
+      std::make_shared<ParametrizedPolynomial>(poly_coeffs, -0.5, 0.75),
+      std::make_shared<ParametrizedSemiCircle>(1.5)};
+  Eigen::ArrayXd t = Eigen::ArrayXd::LinSpaced(11, -1, 1);
+  Eigen::Matrix2Xd values, derivatives, double_derivatives;
+  for (const auto &curve : curves) {
+    curve->Evaluate(t, values);
+    curve->Derivative(t, derivatives);
+    curve->DoubleDerivative(t, double_derivatives);
+    ASSERT_EQ(values.cols(), t.size());
+    for (unsigned k = 0; k < t.size(); ++k) {
+      EXPECT_NEAR((values.col(k) - (*curve)(t(k))).norm(), 0, 1e-14);
+      EXPECT_NEAR((derivatives.col(k) - curve->Derivative(t(k))).norm(), 0,
+                  1e-14);
+      EXPECT_NEAR(
+          (double_derivatives.col(k) - curve->DoubleDerivative(t(k))).norm(),
+          0, 1e-14);
+    }
+  }
+}
+
+TEST(Parametrizations, FourierSumRecurrence) {
+  // The angle addition recurrence should match the direct evaluation of the
+  // sum for many terms
+  unsigned N = 24;
+  Eigen::MatrixXd cos_list(2, N), sin_list(2, N);
+  for (unsigned n = 0; n < N; ++n) {
+    cos_list.col(n) << 1. / (n + 1), 0.5 / (n + 1) / (n + 1);
+    sin_list.col(n) << std::pow(-0.5, n), 1. / (n + 2);
+  }
+  double tmin = -M_PI, tmax = 0.5;
+  parametricbem2d::ParametrizedFourierSum curve(Eigen::Vector2d(0.25, -1),
+                                                cos_list, sin_list, tmin, tmax);
+  double scale = (tmax - tmin) / 2;
+  for (double t = -1; t <= 1; t += 0.125) {
+    double s = t * scale + (tmax + tmin) / 2;
+    Eigen::Vector2d point(0.25, -1), derivative(0, 0), double_derivative(0, 0);
+    for (unsigned n = 1; n <= N; ++n) {
+      point += cos_list.col(n - 1) * cos(n * s) +
+               sin_list.col(n - 1) * sin(n * s);
+      derivative += n * scale *
+                    (sin_list.col(n - 1) * cos(n * s) -
+                     cos_list.col(n - 1) * sin(n * s));
+      double_derivative -= n * n * scale * scale *
+                           (cos_list.col(n - 1) * cos(n * s) +
+                            sin_list.col(n - 1) * sin(n * s));
+    }
+    Eigen::Vector2d p, d, dd;
+    curve.EvaluateWithDerivatives(t, p, d, dd);
+    EXPECT_NEAR((p - point).norm(), 0, 1e-13);
+    EXPECT_NEAR((d - derivative).norm(), 0, 1e-12);
+    EXPECT_NEAR((dd - double_derivative).norm(), 0, 1e-10);
+    EXPECT_NEAR((curve(t) - point).norm(), 0, 1e-13);
+    EXPECT_NEAR((curve.Derivative(t) - derivative).norm(), 0, 1e-12);
+    EXPECT_NEAR((curve.DoubleDerivative(t) - double_derivative).norm(), 0,
+                1e-10);
+  }
+}
+
+TEST(Parametrizations, SplitSharedCoefficients) {
+  // The parts of a split curve, which share the coefficients of the curve,
+  // should reproduce the curve on their parameter ranges
+  Eigen::MatrixXd cos_list(2, 3), sin_list(2, 3), poly_coeffs(2, 3);
+  cos_list << 0.25, 0.1, 0.05, 0, 0.2, 0;
+  sin_list << 0, 0, 0.01, 0.375, -0.05, 0.1;
+  poly_coeffs << 0, 1, 0.5, 0.25, 0.5, 1;
+  parametricbem2d::ParametrizedFourierSum fourier(Eigen::Vector2d(0.5, 0),
+                                                  cos_list, sin_list);
+  parametricbem2d::ParametrizedPolynomial polynomial(poly_coeffs);
+  std::vector<const parametricbem2d::AbstractParametrizedCurve *> curves = {
+      &fourier, &polynomial};
+  unsigned N = 5;
+  for (const auto curve : curves) {
+    parametricbem2d::PanelVector parts = curve->split(N);
+    ASSERT_EQ(parts.size(), N);
+    for (unsigned i = 0; i < N; ++i) {
+      for (double t = -1; t <= 1; t += 0.5) {
+        double s = -1 + (2. * i + t + 1) / N;
+        EXPECT_NEAR(((*parts[i])(t) - (*curve)(s)).norm(), 0, 1e-14);
+        EXPECT_NEAR(
+            (N * parts[i]->Derivative(t) - curve->Derivative(s)).norm(), 0,
+            1e-13);
+      }
+    }
+  }
+}
+
+TEST(Parametrizations, PolynomialBases) {
+  using parametricbem2d::ParametrizedPolynomial;
+  // Coefficients in the Chebyshev basis and the same polynomial in the
+  // monomial basis, obtained from T_{n+1} = 2t T_n - T_{n-1}
+  unsigned N = 8;
+  Eigen::MatrixXd chebyshev(2, N);
+  for (unsigned n = 0; n < N; ++n)
+    chebyshev.col(n) << 1. / (n + 1), std::pow(-0.5, n);
+  Eigen::MatrixXd T = Eigen::MatrixXd::Zero(N, N); // T(n, i): t^i in T_n
+  T(0, 0) = 1;
+  T(1, 1) = 1;
+  for (unsigned n = 1; n + 1 < N; ++n) {
+    T.row(n + 1) = -T.row(n - 1);
+    T.block(n + 1, 1, 1, N - 1) += 2 * T.block(n, 0, 1, N - 1);
+  }
+  Eigen::MatrixXd monomial = chebyshev * T;
+  double tmin = -0.75, tmax = 0.5;
+  ParametrizedPolynomial cheb_curve(chebyshev, tmin, tmax,
+                                    ParametrizedPolynomial::Basis::Chebyshev);
+  ParametrizedPolynomial mono_curve(monomial, tmin, tmax);
+  double scale = (tmax - tmin) / 2;
+  for (double t = -1; t <= 1; t += 0.125) {
+    double s = t * scale + (tmax + tmin) / 2;
+    // Direct evaluation of the monomial form
+    Eigen::Vector2d point(0, 0), derivative(0, 0), double_derivative(0, 0);
+    for (unsigned i = 0; i < N; ++i) {
+      point += monomial.col(i) * std::pow(s, i);
+      if (i >= 1)
+        derivative += i * scale * monomial.col(i) * std::pow(s, i - 1);
+      if (i >= 2)
+        double_derivative +=
+            i * (i - 1) * scale * scale * monomial.col(i) * std::pow(s, i - 2);
+    }
+    Eigen::Vector2d p, d, dd;
+    mono_curve.EvaluateWithDerivatives(t, p, d, dd);
+    EXPECT_NEAR((p - point).norm(), 0, 1e-13);
+    EXPECT_NEAR((d - derivative).norm(), 0, 1e-13);
+    EXPECT_NEAR((dd - double_derivative).norm(), 0, 1e-12);
+    cheb_curve.EvaluateWithDerivatives(t, p, d, dd);
+    EXPECT_NEAR((p - point).norm(), 0, 1e-13);
+    EXPECT_NEAR((d - derivative).norm(), 0, 1e-13);
+    EXPECT_NEAR((dd - double_derivative).norm(), 0, 1e-12);
+    EXPECT_NEAR((cheb_curve(t) - point).norm(), 0, 1e-13);
+    EXPECT_NEAR((cheb_curve.Derivative(t) - derivative).norm(), 0, 1e-13);
+    EXPECT_NEAR((cheb_curve.DoubleDerivative(t) - double_derivative).norm(),
+                0, 1e-12);
+  }
+  // Split parts keep the basis
+  parametricbem2d::PanelVector parts = cheb_curve.split(4);
+  EXPECT_NEAR(((*parts[1])(-1) - cheb_curve(-0.5)).norm(), 0, 1e-14);
+}
+
+TEST(BEMSpaces, TabulatedShapeFunctions) {
+  // The tabulated and the vectorized evaluations should agree with
+  // evaluateShapeFunction() for all the spaces
+  parametricbem2d::DiscontinuousSpace<0> space0;
+  parametricbem2d::DiscontinuousSpace<1> space1;
+  parametricbem2d::ContinuousSpace<1> space2;
+  parametricbem2d::ContinuousSpace<2> space3;
+  std::vector<const parametricbem2d::AbstractBEMSpace *> spaces = {
+      &space0, &space1, &space2, &space3};
+  const QuadRule &GaussQR = getGaussQR(7);
+  for (const auto space : spaces) {
+    int Q = space->getQ();
+    Eigen::ArrayXXd values = space->tabulateShapeFunctions(GaussQR);
+    Eigen::ArrayXXd dots = space->tabulateShapeFunctionDots(GaussQR);
+    ASSERT_EQ(values.rows(), Q);
+    ASSERT_EQ(values.cols(), GaussQR.n);
+    ASSERT_EQ(dots.rows(), Q);
+    Eigen::VectorXd point_values(Q), point_dots(Q);
+    for (unsigned int k = 0; k < GaussQR.n; ++k) {
+      space->evaluateShapeFunctions(GaussQR.x(k), point_values);
+      space->evaluateShapeFunctionDots(GaussQR.x(k), point_dots);
+      for (int q = 0; q < Q; ++q) {
+        double value = space->evaluateShapeFunction(q, GaussQR.x(k));
+        double dot = space->evaluateShapeFunctionDot(q, GaussQR.x(k));
+        EXPECT_EQ(values(q, k), value);
+        EXPECT_EQ(dots(q, k), dot);
+        EXPECT_EQ(point_values(q), value);
+        EXPECT_EQ(point_dots(q), dot);
+      }
+    }
+  }
+}
+
+TEST(BEMSpaces, DofMap) {
+  using PanelVector = parametricbem2d::PanelVector;
+  // Annular mesh with an outer and an inner circle, such that the numbering
+  // of both boundaries is covered
+  Eigen::Vector2d center(0, 0);
+  parametricbem2d::ParametrizedCircularArc outer(center, 2, 0, 2 * M_PI);
+  parametricbem2d::ParametrizedCircularArc inner(center, 1, 2 * M_PI, 0);
+  PanelVector panels = outer.split(8);
+  PanelVector inner_panels = inner.split(5);
+  panels.insert(panels.end(), inner_panels.begin(), inner_panels.end());
+  parametricbem2d::ParametrizedMesh mesh(panels);
+  ASSERT_EQ(mesh.getSplit(), 8);
+  parametricbem2d::DiscontinuousSpace<0> space0;
+  parametricbem2d::DiscontinuousSpace<1> space1;
+  parametricbem2d::ContinuousSpace<1> space2;
+  parametricbem2d::ContinuousSpace<2> space3;
+  std::vector<const parametricbem2d::AbstractBEMSpace *> spaces = {
+      &space0, &space1, &space2, &space3};
+  for (const auto space : spaces) {
+    parametricbem2d::DofMap dofs(*space, mesh);
+    ASSERT_EQ(dofs.getQ(), space->getQ());
+    ASSERT_EQ(dofs.getNumPanels(), 13);
+    EXPECT_EQ(dofs.getSpaceDim(), space->getSpaceDim(13));
+    for (unsigned int i = 0; i < 13; ++i) {
+      for (unsigned int q = 0; q < dofs.getQ(); ++q) {
+        EXPECT_EQ(dofs(q, i), space->LocGlobMap2(q + 1, i + 1, mesh) - 1);
+        EXPECT_EQ(dofs.getPanelDofs(i)[q], dofs(q, i));
+      }
+    }
+  }
+}
+
+TEST(ParametrizedMesh, PanelAccess) {
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1, 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(6));
+  // The panels are accessed without copying them
+  const parametricbem2d::PanelVector &panels = mesh.getPanels();
+  EXPECT_EQ(&panels, &mesh.getPanels());
+  ASSERT_EQ(panels.size(), 6);
+  for (unsigned int i = 0; i < 6; ++i) {
+    EXPECT_EQ(&mesh.getPanel(i), panels[i].get());
+    // Only the mesh holds the panels
+    EXPECT_EQ(panels[i].use_count(), 1);
+  }
+}
+
+TEST(ParametrizedMesh, Topology) {
+  using PanelVector = parametricbem2d::PanelVector;
+  using PanelRelation = parametricbem2d::PanelRelation;
+  // Annular mesh with an outer and an inner circle
+  Eigen::Vector2d center(0, 0);
+  parametricbem2d::ParametrizedCircularArc outer(center, 2, 0, 2 * M_PI);
+  parametricbem2d::ParametrizedCircularArc inner(center, 1, 2 * M_PI, 0);
+  PanelVector panels = outer.split(8);
+  PanelVector inner_panels = inner.split(5);
+  panels.insert(panels.end(), inner_panels.begin(), inner_panels.end());
+  parametricbem2d::ParametrizedMesh mesh(panels);
+  const parametricbem2d::MeshTopology &topology = mesh.getTopology();
+  ASSERT_EQ(topology.getNumChains(), 2);
+  for (unsigned int i = 0; i < 13; ++i) {
+    // Panels are numbered along each boundary
+    unsigned int first = i < 8 ? 0 : 8, size = i < 8 ? 8 : 5;
+    unsigned int next = first + (i - first + 1) % size;
+    EXPECT_EQ(topology.getNext(i), next);
+    EXPECT_EQ(topology.getPrevious(next), i);
+    EXPECT_EQ(topology.getChain(i), i < 8 ? 0 : 1);
+    // The relations agree with the comparison of the end points
+    for (unsigned int j = 0; j < 13; ++j) {
+      PanelRelation expected = PanelRelation::Disjoint;
+      if (i == j)
+        expected = PanelRelation::Coinciding;
+      else if ((panels[i]->operator()(1) - panels[j]->operator()(-1)).norm() <
+                   1e-14 ||
+               (panels[i]->operator()(-1) - panels[j]->operator()(1)).norm() <
+                   1e-14)
+        expected = PanelRelation::Adjacent;
+      EXPECT_EQ(topology.getRelation(i, j), expected);
+    }
+  }
+  // An open chain of panels has no neighbours at its ends
+  parametricbem2d::ParametrizedLine line(Eigen::Vector2d(0, 0),
+                                         Eigen::Vector2d(1, 0));
+  parametricbem2d::ParametrizedMesh open_mesh(line.split(4));
+  const parametricbem2d::MeshTopology &open_topology =
+      open_mesh.getTopology();
+  EXPECT_EQ(open_topology.getNumChains(), 1);
+  EXPECT_EQ(open_topology.getPrevious(0), 4);
+  EXPECT_EQ(open_topology.getNext(3), 4);
+  EXPECT_EQ(open_topology.getRelation(0, 3), PanelRelation::Disjoint);
+  EXPECT_EQ(open_topology.getRelation(2, 1), PanelRelation::Adjacent);
+}
+
+TEST(ParametrizedMesh, MultipleComponents) {
+  using PanelVector = parametricbem2d::PanelVector;
+  // Plate with three holes, with different numbers of panels per boundary
+  parametricbem2d::ParametrizedCircularArc outer(Eigen::Vector2d(0, 0), 4, 0,
+                                                 2 * M_PI);
+  PanelVector panels = outer.split(10);
+  std::vector<unsigned int> offsets = {0, 10};
+  for (unsigned int h = 0; h < 3; ++h) {
+    parametricbem2d::ParametrizedCircularArc hole(
+        Eigen::Vector2d(2. * h - 2, 0), 0.5, 2 * M_PI, 0);
+    PanelVector hole_panels = hole.split(3 + h);
+    panels.insert(panels.end(), hole_panels.begin(), hole_panels.end());
+    offsets.push_back(panels.size());
+  }
+  parametricbem2d::ParametrizedMesh mesh(panels);
+  ASSERT_EQ(mesh.getNumComponents(), 4);
+  EXPECT_EQ(mesh.getSplit(), 10);
+  for (unsigned int c = 0; c <= 4; ++c)
+    EXPECT_EQ(mesh.getComponentOffset(c), offsets[c]);
+  for (unsigned int i = 0; i < panels.size(); ++i)
+    EXPECT_EQ(mesh.getComponent(i), mesh.getTopology().getChain(i));
+  parametricbem2d::DiscontinuousSpace<0> space0;
+  parametricbem2d::DiscontinuousSpace<1> space1;
+  parametricbem2d::ContinuousSpace<1> space2;
+  parametricbem2d::ContinuousSpace<2> space3;
+  std::vector<const parametricbem2d::AbstractBEMSpace *> spaces = {
+      &space0, &space1, &space2, &space3};
+  for (const auto space : spaces) {
+    // The global shape functions of every component form a block, which is
+    // covered by the panels of the component
+    parametricbem2d::DofMap dofs(*space, mesh);
+    EXPECT_EQ(dofs.getComponentOffset(4), dofs.getSpaceDim());
+    std::vector<bool> used(dofs.getSpaceDim(), false);
+    for (unsigned int i = 0; i < panels.size(); ++i) {
+      unsigned int c = mesh.getComponent(i);
+      for (unsigned int q = 0; q < dofs.getQ(); ++q) {
+        EXPECT_GE(dofs(q, i), dofs.getComponentOffset(c));
+        EXPECT_LT(dofs(q, i), dofs.getComponentOffset(c + 1));
+        used[dofs(q, i)] = true;
+      }
+    }
+    EXPECT_EQ(std::count(used.begin(), used.end(), false), 0);
+  }
+  // The interpolants agree with the function at the end points and the
+  // middle of every panel
+  auto func = [](double x, double y) { return x * x + 2 * y; };
+  Eigen::VectorXd coeffs1 = space1.Interpolate(func, mesh);
+  Eigen::VectorXd coeffs3 = space3.Interpolate(func, mesh);
+  parametricbem2d::DofMap dofs1(space1, mesh), dofs3(space3, mesh);
+  for (unsigned int i = 0; i < panels.size(); ++i) {
+    for (double t : {-1., 0., 1.}) {
+      Eigen::Vector2d x = panels[i]->operator()(t);
+      double value1 = 0, value3 = 0;
+      for (unsigned int q = 0; q < 2; ++q)
+        value1 += coeffs1(dofs1(q, i)) * space1.evaluateShapeFunction(q, t);
+      for (unsigned int q = 0; q < 3; ++q)
+        value3 += coeffs3(dofs3(q, i)) * space3.evaluateShapeFunction(q, t);
+      if (t != 0) {
+        EXPECT_NEAR(value1, func(x(0), x(1)), eps);
+      }
+      EXPECT_NEAR(value3, func(x(0), x(1)), eps);
+    }
+  }
+  // The blocks for the pairs of components make up the Galerkin matrix
+  const QuadRule &GaussQR = getGaussQR(6);
+  parametricbem2d::PanelGeometryCache geometry(mesh, GaussQR);
+  auto kernel = [&](unsigned int i, unsigned int j,
+                    Eigen::MatrixXd &interaction_matrix) {
+    interaction_matrix = parametricbem2d::double_layer::InteractionMatrix(
+        geometry, i, j, space2, space0, GaussQR);
+  };
+  Eigen::MatrixXd K = parametricbem2d::double_layer::GalerkinMatrix(
+      mesh, geometry, space2, space0, GaussQR);
+  parametricbem2d::DofMap trial_dofs(space2, mesh), test_dofs(space0, mesh);
+  for (unsigned int c = 0; c < 4; ++c) {
+    for (unsigned int d = 0; d < 4; ++d) {
+      Eigen::MatrixXd block =
+          parametricbem2d::parallel_assembly::AssembleGalerkinBlock(
+              mesh, trial_dofs, test_dofs, c, d, kernel);
+      EXPECT_EQ(block, K.block(test_dofs.getComponentOffset(c),
+                               trial_dofs.getComponentOffset(d), block.rows(),
+                               block.cols()));
+    }
+  }
+}
+
+TEST(PanelGeometryCache, ReusedInteractionMatrices) {
+  // The kernels writing into matrices provided by the caller give the same
+  // interaction matrices and keep the storage for disjoint panels
+  parametricbem2d::ParametrizedCircularArc curve(Eigen::Vector2d(0, 0), 1., 0,
+                                                 2 * M_PI);
+  parametricbem2d::ParametrizedMesh mesh(curve.split(8));
+  const QuadRule &GaussQR = getGaussQR(6);
+  parametricbem2d::PanelGeometryCache geometry(mesh, GaussQR);
+  parametricbem2d::ContinuousSpace<1> trial_space;
+  parametricbem2d::DiscontinuousSpace<1> test_space;
+  parametricbem2d::TabulatedBEMSpace trial_shapes(trial_space, GaussQR);
+  parametricbem2d::TabulatedBEMSpace test_shapes(test_space, GaussQR);
+  EXPECT_EQ(&test_shapes.getSpace(), &test_space);
+  EXPECT_EQ(test_shapes.getValues().matrix(),
+            test_space.tabulateShapeFunctions(GaussQR).matrix());
+  EXPECT_EQ(trial_shapes.getDots().matrix(),
+            trial_space.tabulateShapeFunctionDots(GaussQR).matrix());
+  Eigen::MatrixXd V(2, 2), K(2, 2), W(2, 2);
+  std::pair<Eigen::MatrixXd, Eigen::MatrixXd> VW(Eigen::MatrixXd(2, 2),
+                                                 Eigen::MatrixXd(2, 2));
+  for (unsigned int i = 0; i < 8; ++i) {
+    for (unsigned int j = 0; j < 8; ++j) {
+      const double *storage[] = {V.data(), K.data(), W.data(),
+                                 VW.first.data(), VW.second.data()};
+      parametricbem2d::single_layer::InteractionMatrix(geometry, i, j,
+                                                       test_shapes, GaussQR, V);
+      parametricbem2d::double_layer::InteractionMatrix(
+          geometry, i, j, trial_shapes, test_shapes, GaussQR, K);
+      parametricbem2d::hypersingular::InteractionMatrix(
+          geometry, i, j, trial_shapes, GaussQR, W);
+      parametricbem2d::hypersingular::InteractionMatrices(
+          geometry, i, j, test_shapes, trial_shapes, GaussQR, VW);
+      EXPECT_EQ(V, parametricbem2d::single_layer::InteractionMatrix(
+                       geometry, i, j, test_space, GaussQR));
+      EXPECT_EQ(K, parametricbem2d::double_layer::InteractionMatrix(
+                       geometry, i, j, trial_space, test_space, GaussQR));
+      EXPECT_EQ(W, parametricbem2d::hypersingular::InteractionMatrix(
+                       geometry, i, j, trial_space, GaussQR));
+      EXPECT_EQ(VW.first, V);
+      EXPECT_EQ(VW.second, W);
+      if (mesh.getTopology().getRelation(i, j) ==
+          parametricbem2d::PanelRelation::Disjoint) {
+        const double *reused[] = {V.data(), K.data(), W.data(),
+                                  VW.first.data(), VW.second.data()};
+        for (unsigned int m = 0; m < 5; ++m)
+          EXPECT_EQ(reused[m], storage[m]);
+      }
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   srand(time(NULL));
   // run tests